@@ -31,7 +31,7 @@ F32                              mTransformMatrix[16];
 bgfx::ProgramHandle              mShader;
 Rendering::RenderData*           mRenderData = NULL;
 bgfx::TextureHandle              mTexture = BGFX_INVALID_HANDLE;
-Vector<Rendering::InstanceData>  mInstanceData;
+Rendering::InstanceBuffer*       mInstanceBuffer = NULL;
 Vector<Rendering::TextureData>   mTextureData;
 
 using namespace Plugins;
@@ -45,7 +45,11 @@ void create(PluginLink _link)
 
 void destroy()
 {
+   Link.Rendering.destroyRenderData(mRenderData);
+   mRenderData = NULL;
 
+   Link.Rendering.destroyInstanceBuffer(mInstanceBuffer);
+   mInstanceBuffer = NULL;
 }
 
 void loadModel(SimObject *obj, S32 argc, const char *argv[])
@@ -88,8 +92,12 @@ void loadModel(SimObject *obj, S32 argc, const char *argv[])
       mRenderData->transformTable = &mTransformMatrix[0];
       mRenderData->transformCount = 1;
 
-      // Instances
-      mInstanceData.clear();
+      // Instances never change so they're uploaded once into a static 
+      // instance buffer.
+      Vector<Rendering::InstanceData> instanceData;
+      instanceData.reserve(200 * 200);
+      Box3F meshBounds = mesh->getBoundingBox(0);
+      Box3F foliageBounds = meshBounds;
       for(S32 x = -100; x < 100; ++x)
       {
          for(S32 y = -100; y < 100; ++y)
@@ -107,10 +115,18 @@ void loadModel(SimObject *obj, S32 argc, const char *argv[])
             grassInstance.i_data2.set(instMat[8],  instMat[9],  instMat[10], instMat[11]);
             grassInstance.i_data3.set(instMat[12], instMat[13], instMat[14], instMat[15]);
 
-            mInstanceData.push_back(grassInstance);
+            instanceData.push_back(grassInstance);
+
+            foliageBounds.intersect(Plugins::Link.Rendering.transformBox(instMat, meshBounds));
          }
       }
-      mRenderData->instances = &mInstanceData;
+      Link.Rendering.destroyInstanceBuffer(mInstanceBuffer);
+      mInstanceBuffer = Link.Rendering.createStaticInstanceBuffer(instanceData.address(), instanceData.size());
+      mRenderData->instanceBuffer = mInstanceBuffer;
+
+      // World space bounds for culling, covers every instance.
+      mRenderData->bounds = Plugins::Link.Rendering.transformBox(mTransformMatrix, foliageBounds);
+      mRenderData->hasBounds = true;
 
       // Textures
       mTextureData.clear();
@@ -43,7 +43,7 @@ extern F32                              mTransformMatrix[16];
 extern bgfx::ProgramHandle              mShader;
 extern Rendering::RenderData*           mRenderData;
 extern bgfx::TextureHandle              mTexture;
-extern Vector<Rendering::InstanceData>  mInstanceData;
+extern Rendering::InstanceBuffer*       mInstanceBuffer;
 extern Vector<Rendering::TextureData>   mTextureData;
 
 void loadModel(SimObject *obj, S32 argc, const char *argv[]);
\ No newline at end of file
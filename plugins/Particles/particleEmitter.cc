@@ -55,8 +55,8 @@ namespace Scene
       mSpeed = 0.1f;
 
       mShader.idx = bgfx::invalidHandle;
-      mRenderData = NULL;
       mTexture.idx = bgfx::invalidHandle;
+      mInstanceBuffer = NULL;
    }
 
    void ParticleEmitter::initPersistFields()
@@ -86,6 +86,16 @@ namespace Scene
       refresh();
    }
 
+   void ParticleEmitter::onRemoveFromScene()
+   {  
+      setProcessTicks(false);
+
+      Plugins::Link.Rendering.destroyRenderData(Plugins::Link.Rendering.getRenderData(mRenderHandle));
+
+      Plugins::Link.Rendering.destroyInstanceBuffer(mInstanceBuffer);
+      mInstanceBuffer = NULL;
+   }
+
    void ParticleEmitter::refresh()
    {
       Parent::refresh();
@@ -95,31 +105,43 @@ namespace Scene
            mCount < 1 )
          return;
 
-      if ( mRenderData == NULL )
-         mRenderData = Plugins::Link.Rendering.createRenderData();
+      // Emitters come and go often, so only a handle to the render data is
+      // kept and resolved when it's needed.
+      Rendering::RenderData* renderData = Plugins::Link.Rendering.getRenderData(mRenderHandle);
+      if ( renderData == NULL )
+      {
+         renderData = Plugins::Link.Rendering.createRenderData();
+         mRenderHandle = Plugins::Link.Rendering.getRenderHandle(renderData);
+      }
 
-      mRenderData->indexBuffer = indexBuffer;
-      mRenderData->vertexBuffer = vertexBuffer;
+      renderData->indexBuffer = indexBuffer;
+      renderData->vertexBuffer = vertexBuffer;
 
       // Render in Forward (for now) with our custom terrain shader.
-      mRenderData->shader = mShader;
-      mRenderData->view = Plugins::Link.Graphics.getView("TransparencyBuffer", 3000);
-      mRenderData->state = 0
+      renderData->shader = mShader;
+      renderData->view = Plugins::Link.Graphics.getView("TransparencyBuffer", 3000);
+      renderData->state = 0
             | BGFX_STATE_RGB_WRITE
             | BGFX_STATE_ALPHA_WRITE
             | BGFX_STATE_DEPTH_TEST_LESS
             | BGFX_STATE_BLEND_FUNC(BGFX_STATE_BLEND_ONE, BGFX_STATE_BLEND_ONE)
 				| BGFX_STATE_BLEND_INDEPENDENT;
-      mRenderData->stateRGBA = 0
+      renderData->stateRGBA = 0
             | BGFX_STATE_BLEND_FUNC_RT_1(BGFX_STATE_BLEND_ZERO, BGFX_STATE_BLEND_INV_SRC_ALPHA);
 
       // Transform of emitter.
-      mRenderData->transformTable = &mTransformMatrix[0];
-      mRenderData->transformCount = 1;
+      renderData->transformTable = &mTransformMatrix[0];
+      renderData->transformCount = 1;
 
-      // Instances
+      // Instances are written straight into a double buffered instance 
+      // buffer every frame.
+      if ( mInstanceBuffer == NULL || mInstanceBuffer->capacity != (U32)mCount )
+      {
+         Plugins::Link.Rendering.destroyInstanceBuffer(mInstanceBuffer);
+         mInstanceBuffer = Plugins::Link.Rendering.createDynamicInstanceBuffer(mCount);
+      }
       mParticles.clear();
-      mRenderData->instances = &mInstanceData;
+      renderData->instanceBuffer = mInstanceBuffer;
    
       // Generate 50k particle instances for stress testing.
       for( U32 n = 0; n < mCount; ++n )
@@ -131,8 +153,8 @@ namespace Scene
 
       // Textures
       mTextureData.clear();
-      mRenderData->textures = &mTextureData;
-      Rendering::TextureData* texture = mRenderData->addTexture();
+      renderData->textures = &mTextureData;
+      Rendering::TextureData* texture = renderData->addTexture();
       texture->handle = mTexture;
       texture->uniform = Plugins::Link.Graphics.getTextureUniform(0);
    }
@@ -149,7 +171,11 @@ namespace Scene
 
    void ParticleEmitter::advanceTime( F32 timeDelta )
    {  
-      mInstanceData.clear();
+      if ( mInstanceBuffer == NULL )
+         return;
+
+      Rendering::InstanceData* instances = Plugins::Link.Rendering.beginInstanceUpdate(mInstanceBuffer);
+      Box3F particleBounds;
 
       //
       for(U32 n = 0; n < mParticles.size(); ++n)
@@ -162,10 +188,26 @@ namespace Scene
          if ( part->lifetime < 0 )
             emitParticle(part);
 
-         Rendering::InstanceData particle;
-         particle.i_data0.set(part->position.x, part->position.y, part->position.z, 0.0f);
-         particle.i_data1.set(part->color.red, part->color.green, part->color.blue, mClampF(part->lifetime, 0.0f, 1.0f));
-         mInstanceData.push_back(particle);
+         Rendering::InstanceData* particle = &instances[n];
+         particle->i_data0.set(part->position.x, part->position.y, part->position.z, 0.0f);
+         particle->i_data1.set(part->color.red, part->color.green, part->color.blue, mClampF(part->lifetime, 0.0f, 1.0f));
+
+         if ( n == 0 )
+            particleBounds.set(part->position, part->position);
+         else
+            particleBounds.extend(part->position);
+      }
+
+      Plugins::Link.Rendering.endInstanceUpdate(mInstanceBuffer, mParticles.size());
+
+      // World space bounds for culling, padded by the billboard size.
+      Rendering::RenderData* renderData = Plugins::Link.Rendering.getRenderData(mRenderHandle);
+      if ( renderData != NULL && mParticles.size() > 0 )
+      {
+         particleBounds.minExtents -= Point3F(10.0f, 10.0f, 10.0f);
+         particleBounds.maxExtents += Point3F(10.0f, 10.0f, 10.0f);
+         renderData->bounds = Plugins::Link.Rendering.transformBox(mTransformMatrix, particleBounds);
+         renderData->hasBounds = true;
       }
    }
 
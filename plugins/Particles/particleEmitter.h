@@ -61,9 +61,9 @@ namespace Scene
          Vector<Particle>                 mParticles;
 
          bgfx::ProgramHandle              mShader;
-         Rendering::RenderData*           mRenderData;
+         Rendering::RenderHandle          mRenderHandle;
          bgfx::TextureHandle              mTexture;
-         Vector<Rendering::InstanceData>  mInstanceData;
+         Rendering::InstanceBuffer*       mInstanceBuffer;
          Vector<Rendering::TextureData>   mTextureData;
 
       protected:
@@ -79,6 +79,7 @@ namespace Scene
 
          void emitParticle(Particle* part);
          void onAddToScene();
+         void onRemoveFromScene();
          void refresh();
 
          static void initPersistFields();
@@ -58,6 +58,8 @@ TerrainCell::TerrainCell(bgfx::TextureHandle* _megaTexture, Vector<Rendering::Un
    mRenderData = NULL;
 
    maxTerrainHeight = 0;
+   mBounds.minExtents.set(0, 0, 0);
+   mBounds.maxExtents.set(0, 0, 0);
 
    // Load Shader
    Graphics::ShaderAsset* terrainShaderAsset = Link.Graphics.getShaderAsset("Terrain:terrainShader");
@@ -72,6 +74,8 @@ TerrainCell::~TerrainCell()
    SAFE_DELETE(heightMap);
    SAFE_DELETE(blendMap);
 
+   Link.Rendering.destroyRenderData(mRenderData);
+
    if ( mVB.idx != bgfx::invalidHandle )
       Link.bgfx.destroyVertexBuffer(mVB);
 
@@ -227,14 +231,21 @@ void TerrainCell::rebuild()
    SAFE_DELETE(mVerts);
    SAFE_DELETE(mIndices);
 
+   F32 minHeight = heightMap[0];
+   F32 maxHeight = heightMap[0];
+
    mVertCount = 0;
    mVerts = new PosUVNormalVertex[width * height];
    for(U32 y = 0; y < height; y++ )
    {
       for(U32 x = 0; x < width; x++ )
       {
+         F32 heightValue = heightMap[(y * width) + x];
+         minHeight = getMin(minHeight, heightValue);
+         maxHeight = getMax(maxHeight, heightValue);
+
          mVerts[mVertCount].m_x = x;
-         mVerts[mVertCount].m_y = heightMap[(y * width) + x];
+         mVerts[mVertCount].m_y = heightValue;
          mVerts[mVertCount].m_z = y;
          mVerts[mVertCount].m_u = (F32)x / (F32)width;
          mVerts[mVertCount].m_v = (F32)y / (F32)height;
@@ -247,6 +258,14 @@ void TerrainCell::rebuild()
       }
    }
 
+   // Local space bounds of the cell, used for culling.
+   mBounds.minExtents.set(0.0f, minHeight, 0.0f);
+   mBounds.maxExtents.set((F32)width, maxHeight, (F32)height);
+
+   // Heightfield collision picks up the new heights the next time a shape
+   // is requested for this cell.
+   Link.Physics.setHeightfield(gridX, gridY, heightMap, width, height, Point3F((F32)(gridX * width - gridX), 0.0f, (F32)(gridY * height - gridY)));
+
    mIndexCount = 0;
    mIndices = new U32[width * height * 6];
    for(U32 y = 0; y < (height - 1); y++ )
@@ -297,6 +316,11 @@ void TerrainCell::refresh()
    bx::mtxSRT(mTransformMtx, 1, 1, 1, 0, 0, 0, gridX * width - (1 * gridX), 0, gridY * height - (1 * gridY));
    mRenderData->transformTable = mTransformMtx;
    mRenderData->transformCount = 1;
+
+   // World space bounds for culling.
+   Point3F cellOrigin(mTransformMtx[12], mTransformMtx[13], mTransformMtx[14]);
+   mRenderData->bounds.set(mBounds.minExtents + cellOrigin, mBounds.maxExtents + cellOrigin);
+   mRenderData->hasBounds = true;
 }
 
 void TerrainCell::paintLayer(U32 layerNum, U32 x, U32 y, U8 strength)
@@ -51,6 +51,7 @@ protected:
    U32*                             mIndices;
    U32                              mIndexCount;
    F32                              mTransformMtx[16];
+   Box3F                            mBounds;
 
    bgfx::TextureHandle*             mMegaTexture;
    Vector<Rendering::TextureData>   mTextureData;
@@ -112,6 +112,8 @@ TerrainEditor::TerrainEditor()
 
 TerrainEditor::~TerrainEditor()
 {
+   Link.Rendering.destroyRenderData(decalRenderData);
+
    if ( vertexBuffer.idx != bgfx::invalidHandle )
       Link.bgfx.destroyVertexBuffer(vertexBuffer);
 
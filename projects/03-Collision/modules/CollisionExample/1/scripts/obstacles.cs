@@ -49,6 +49,10 @@ function SceneEntity::removeSelf( %this )
 
 function SceneEntity::onCollide ( %this, %hit, %type )
 {
+    // Contacts are reported once with "begin" and once with "end".
+    if ( %type !$= "begin" )
+        return;
+
     %this.findComponent("Cube").setUniformVec4("cubeColor", "0.2 1.0 0.2 0.0");
     cancel(%this.resetColorTimer);
     %this.resetColorTimer = %this.schedule(1000, "resetColor");
@@ -2,6 +2,7 @@ $input a_position, a_indices, a_weight
 $output v_position
 
 #include <torque6.sc>
+#include <skinning.sh>
 
 void main()
 {
@@ -9,10 +10,7 @@ void main()
     vec4 vertPosition = vec4(a_position, 1.0);
 
     // Optional: GPU Skinning
-    mat4 boneTransform =    mul(u_model[int(a_indices[0])], a_weight[0]);
-    boneTransform +=        mul(u_model[int(a_indices[1])], a_weight[1]);
-    boneTransform +=        mul(u_model[int(a_indices[2])], a_weight[2]);
-    boneTransform +=        mul(u_model[int(a_indices[3])], a_weight[3]);    
+    mat4 boneTransform = getSkinTransform(u_bonePalette.x, a_indices, a_weight);
     vertPosition =          mul(boneTransform, vertPosition);
 
     gl_Position = mul(u_modelViewProj, vertPosition );
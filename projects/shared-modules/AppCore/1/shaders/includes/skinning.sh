@@ -0,0 +1,38 @@
+// Bone Palette
+// Every skinned mesh's bones live in one RGBA32F texture, four texels (one
+// per matrix column) per bone. See src/3d/rendering/bonePalette.h
+
+SAMPLER2D(s_bonePalette, 15);
+uniform vec4 u_bonePalette; // [First Bone - 1, Width, Height, 0]
+
+vec4 getBonePaletteTexel(float _index)
+{
+    float row = floor(_index / u_bonePalette.y);
+    float col = _index - (row * u_bonePalette.y);
+    return texture2DLod(s_bonePalette, (vec2(col, row) + 0.5) / u_bonePalette.yz, 0.0);
+}
+
+// Returns a matrix that's used the same way as u_model.
+mat4 getBoneTransform(float _boneOffset, float _boneIndex)
+{
+    float texel = (_boneOffset + _boneIndex) * 4.0;
+    vec4 col0 = getBonePaletteTexel(texel);
+    vec4 col1 = getBonePaletteTexel(texel + 1.0);
+    vec4 col2 = getBonePaletteTexel(texel + 2.0);
+    vec4 col3 = getBonePaletteTexel(texel + 3.0);
+
+#if BGFX_SHADER_LANGUAGE_HLSL
+    return transpose(mat4(col0, col1, col2, col3));
+#else
+    return mat4(col0, col1, col2, col3);
+#endif
+}
+
+mat4 getSkinTransform(float _boneOffset, vec4 _indices, vec4 _weight)
+{
+    mat4 skinTransform =    mul(getBoneTransform(_boneOffset, _indices[0]), _weight[0]);
+    skinTransform +=        mul(getBoneTransform(_boneOffset, _indices[1]), _weight[1]);
+    skinTransform +=        mul(getBoneTransform(_boneOffset, _indices[2]), _weight[2]);
+    skinTransform +=        mul(getBoneTransform(_boneOffset, _indices[3]), _weight[3]);
+    return skinTransform;
+}
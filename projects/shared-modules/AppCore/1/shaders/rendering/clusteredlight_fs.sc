@@ -0,0 +1,73 @@
+$input v_color0, v_texcoord0, v_sspos
+
+#include <torque6.sc>
+
+uniform vec4 u_clusterGrid;     // [TilesX, TilesY, Slices, Near Plane]
+uniform vec4 u_clusterParams;   // [Slice Scale, 0, 0, 0]
+uniform vec4 u_clusterTexSize;  // [Light Width, Light Height, Index Width, Index Height]
+uniform mat4 u_sceneViewMat;
+uniform mat4 u_sceneInvViewProjMat;
+uniform vec4 u_camPos;
+
+SAMPLER2D(Texture0, 0); // Depth
+SAMPLER2D(Texture1, 1); // Normals
+SAMPLER2D(Texture2, 2); // Cluster Grid
+SAMPLER2D(Texture3, 3); // Light Indices
+SAMPLER2D(Texture4, 4); // Light Data
+
+#include <lighting.sh>
+
+#define MAX_LIGHTS_PER_CLUSTER 128
+
+vec2 texelUV(float _index, vec2 _texSize)
+{
+    float row = floor(_index / _texSize.x);
+    float col = _index - (row * _texSize.x);
+    return (vec2(col, row) + 0.5) / _texSize;
+}
+
+void main()
+{
+    // World-Space Position
+    float deviceDepth   = texture2D(Texture0, v_texcoord0).x;
+    if ( deviceDepth >= 1.0 )
+    {
+        gl_FragColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    float depth         = toClipSpaceDepth(deviceDepth);
+    vec3  clip          = vec3(toClipSpace(v_texcoord0), depth);
+    vec3  wpos          = clipToWorld(u_sceneInvViewProjMat, clip);
+
+    // Find the cluster.
+    float viewZ = mul(u_sceneViewMat, vec4(wpos, 1.0)).z;
+    vec2  tile  = clamp(floor((clip.xy * 0.5 + 0.5) * u_clusterGrid.xy), vec2(0.0, 0.0), u_clusterGrid.xy - 1.0);
+    float slice = clamp(floor(log(max(viewZ, u_clusterGrid.w) / u_clusterGrid.w) * u_clusterParams.x), 0.0, u_clusterGrid.z - 1.0);
+
+    // Slices are laid out side by side in the grid texture.
+    vec2 gridSize   = vec2(u_clusterGrid.x * u_clusterGrid.z, u_clusterGrid.y);
+    vec2 gridUV     = (vec2(tile.x + slice * u_clusterGrid.x, tile.y) + 0.5) / gridSize;
+    vec4 cluster    = texture2DLod(Texture2, gridUV, 0.0);
+
+    // Normals
+    vec3 normal = decodeNormalUint(texture2D(Texture1, v_texcoord0).xyz);
+
+    // View Direction
+    vec3 viewDir = normalize(u_camPos.xyz - wpos);
+
+    vec3 color = vec3(0.0, 0.0, 0.0);
+    for (int i = 0; i < MAX_LIGHTS_PER_CLUSTER; ++i)
+    {
+        if ( float(i) >= cluster.y )
+            break;
+
+        float lightIndex    = texture2DLod(Texture3, texelUV(cluster.x + float(i), u_clusterTexSize.zw), 0.0).x;
+        vec4  lightPosRad   = texture2DLod(Texture4, texelUV(lightIndex * 2.0, u_clusterTexSize.xy), 0.0);
+        vec4  lightColAttn  = texture2DLod(Texture4, texelUV(lightIndex * 2.0 + 1.0, u_clusterTexSize.xy), 0.0);
+
+        color += calcPointLight(wpos, viewDir, normal, lightPosRad.xyz, lightColAttn.xyz, lightPosRad.w, lightColAttn.w);
+    }
+
+    gl_FragColor = vec4(color, 1.0);
+}
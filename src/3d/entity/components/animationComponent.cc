@@ -36,6 +36,7 @@
 // bgfx/bx
 #include <bgfx.h>
 #include <bx/fpumath.h>
+#include <bx/timer.h>
 
 // Assimp - Asset Import Library
 #include <assimp/cimport.h>
@@ -45,6 +46,18 @@
 
 namespace Scene
 {
+   bool           animationLOD = true;
+   AnimationStats animationStats;
+
+   // Every client side AnimationComponent with a mesh, posed by updateAnimations().
+   static Vector<AnimationComponent*> gAnimationComponents;
+
+   // Screen size (bounding radius / distance, scaled by the projection) below 
+   // which each further halving of the update rate kicks in.
+   static const F32 AnimationLODScreenSize[] = { 0.25f, 0.1f, 0.04f };
+   static const U32 AnimationLODLevels = sizeof(AnimationLODScreenSize) / sizeof(F32);
+   static const U32 AnimationOffscreenInterval = 16;
+
    IMPLEMENT_CONOBJECT(AnimationComponent);
 
    AnimationComponent::AnimationComponent()
@@ -55,8 +68,19 @@ namespace Scene
 
       mAnimationTime = 0.0f;
       mSpeed = 1.0f;
+      mClipName = StringTable->EmptyString;
 
       mTargetName = StringTable->EmptyString;
+
+      mUpdateInterval = 1;
+      mFramesSinceUpdate = 0;
+      mVisible = false;
+      mRegistered = false;
+   }
+
+   AnimationComponent::~AnimationComponent()
+   {
+      _unregister();
    }
 
    void AnimationComponent::initPersistFields()
@@ -65,6 +89,7 @@ namespace Scene
 
       addGroup("AnimationComponent");
          addField("Speed", TypeF32, Offset(mSpeed, AnimationComponent), "");
+         addField("Clip", TypeString, Offset(mClipName, AnimationComponent), "Name of the clip to start playing, the first clip if empty.");
          addField("Target", TypeString, Offset(mTargetName, AnimationComponent), "");
          addProtectedField("MeshAsset", TypeAssetId, Offset(mMeshAssetId, AnimationComponent), &setMesh, &defaultProtectedGetFn, "The asset Id of the mesh to animate."); 
       endGroup("AnimationComponent");
@@ -78,11 +103,37 @@ namespace Scene
 
       if ( mMeshAsset->isLoaded() )
          mOwnerEntity->setProcessTick(true);
+
+      _register();
    }
 
    void AnimationComponent::onRemoveFromScene()
    {  
       //setProcessTicks(false);
+      _unregister();
+   }
+
+   void AnimationComponent::_register()
+   {
+      if ( mRegistered )
+         return;
+
+      // Spread the first update of components added together across frames.
+      mFramesSinceUpdate = gAnimationComponents.size() % AnimationOffscreenInterval;
+      mVisible = false;
+      gAnimationComponents.push_back(this);
+      mRegistered = true;
+   }
+
+   void AnimationComponent::_unregister()
+   {
+      if ( !mRegistered )
+         return;
+
+      S32 idx = gAnimationComponents.find_next(this);
+      if ( idx >= 0 )
+         gAnimationComponents.erase_fast(idx);
+      mRegistered = false;
    }
 
    void AnimationComponent::setMesh( const char* pImageAssetId )
@@ -94,6 +145,9 @@ namespace Scene
       mMeshAssetId = StringTable->insert(pImageAssetId);
       mMeshAsset.setAssetId(mMeshAssetId);
 
+      // Clip indices and masks belong to the old mesh.
+      mLayers.clear();
+
       if ( mMeshAsset.isNull() )
          Con::errorf("[AnimationComponent] Failed to load mesh asset.");
    }
@@ -105,15 +159,252 @@ namespace Scene
 
    void AnimationComponent::processMove(const Move* move)
    {  
-      if ( !mTarget.isNull() )
-      {
-         mTarget->mTransformCount = mMeshAsset->getAnimatedTransforms(mAnimationTime, mTarget->mTransformTable[1]) + 1;
-         mTarget->refreshTransforms();
-      }
+      // Posing is batched in updateAnimations().
    }
 
    void AnimationComponent::advanceMove( F32 timeDelta )
    {  
       mAnimationTime += (timeDelta * mSpeed);
+
+      for ( S32 n = mLayers.size() - 1; n >= 0; --n )
+      {
+         mLayers[n].advance(timeDelta * mSpeed);
+         if ( mLayers[n].isFinished() )
+            mLayers.erase(n);
+      }
+   }
+
+   // Counts the frame and decides if the component should be posed in it.
+   bool AnimationComponent::_isUpdateDue(const Rendering::Frustum& frustum, const Point3F& cameraPos)
+   {
+      mFramesSinceUpdate++;
+
+      if ( !animationLOD )
+      {
+         mUpdateInterval = 1;
+         mVisible = true;
+         return true;
+      }
+
+      Box3F bounds = mTarget->getWorldBounds();
+      bool visible = frustum.intersects(bounds);
+      bool cameIntoView = visible && !mVisible;
+      mVisible = visible;
+
+      if ( visible )
+      {
+         F32 radius = bounds.len() * 0.5f;
+         F32 distance = getMax((bounds.getCenter() - cameraPos).len(), Rendering::nearPlane);
+         F32 screenSize = (radius / distance) * Rendering::projectionHeight;
+
+         mUpdateInterval = 1;
+         for ( U32 n = 0; n < AnimationLODLevels && screenSize < AnimationLODScreenSize[n]; ++n )
+            mUpdateInterval *= 2;
+      } else {
+         mUpdateInterval = AnimationOffscreenInterval;
+      }
+
+      return cameIntoView || mFramesSinceUpdate >= mUpdateInterval;
+   }
+
+   // Without any explicit layers the component plays Clip (or the first
+   // clip) at full weight, as it always has.
+   void AnimationComponent::_ensureLayers()
+   {
+      if ( mLayers.size() > 0 || mMeshAsset.isNull() || mMeshAsset->getClipCount() == 0 )
+         return;
+
+      S32 clip = mClipName != StringTable->EmptyString ? mMeshAsset->findClip(mClipName) : 0;
+      mLayers.increment();
+      mLayers.last().mClip = getMax(clip, 0);
+      mLayers.last().mTime = mAnimationTime;
+   }
+
+   S32 AnimationComponent::playClip(const char* clipName, F32 fadeTime)
+   {
+      if ( mMeshAsset.isNull() )
+         return -1;
+
+      S32 clip = mMeshAsset->findClip(clipName);
+      if ( clip < 0 )
+      {
+         Con::warnf("[AnimationComponent] Unknown clip: %s", clipName);
+         return -1;
+      }
+
+      _ensureLayers();
+
+      // Crossfade out every full body blend layer and fade the new clip in.
+      for ( S32 n = 0; n < mLayers.size(); ++n )
+      {
+         if ( mLayers[n].mMode == AnimationLayer::Blend && mLayers[n].mMask.size() == 0 )
+            mLayers[n].fadeTo(0.0f, fadeTime, true);
+      }
+
+      mLayers.increment();
+      AnimationLayer* layer = &mLayers.last();
+      layer->mClip = clip;
+      layer->mWeight = 0.0f;
+      layer->fadeTo(1.0f, fadeTime);
+
+      // Layers that finished fading instantly go away right now.
+      for ( S32 n = mLayers.size() - 1; n >= 0; --n )
+      {
+         if ( mLayers[n].isFinished() )
+            mLayers.erase(n);
+      }
+
+      return mLayers.size() - 1;
+   }
+
+   S32 AnimationComponent::addLayer(const char* clipName, F32 weight, bool additive, const char* maskRootNode)
+   {
+      if ( mMeshAsset.isNull() )
+         return -1;
+
+      S32 clip = mMeshAsset->findClip(clipName);
+      if ( clip < 0 )
+      {
+         Con::warnf("[AnimationComponent] Unknown clip: %s", clipName);
+         return -1;
+      }
+
+      _ensureLayers();
+      mLayers.increment();
+      AnimationLayer* layer = &mLayers.last();
+      layer->mClip = clip;
+      layer->mMode = additive ? AnimationLayer::Additive : AnimationLayer::Blend;
+      layer->mWeight = layer->mTargetWeight = weight;
+
+      if ( maskRootNode != NULL && maskRootNode[0] != 0 && !mMeshAsset->buildNodeMask(maskRootNode, layer->mMask) )
+         Con::warnf("[AnimationComponent] Unknown mask node: %s", maskRootNode);
+
+      return mLayers.size() - 1;
+   }
+
+   void AnimationComponent::removeLayer(U32 idx)
+   {
+      if ( idx < (U32)mLayers.size() )
+         mLayers.erase(idx);
+   }
+
+   void AnimationComponent::setLayerWeight(U32 idx, F32 weight, F32 fadeTime)
+   {
+      if ( idx < (U32)mLayers.size() )
+         mLayers[idx].fadeTo(weight, fadeTime);
+   }
+
+   void AnimationComponent::setLayerSpeed(U32 idx, F32 speed)
+   {
+      if ( idx < (U32)mLayers.size() )
+         mLayers[idx].mSpeed = speed;
+   }
+
+   void AnimationComponent::setLayerTime(U32 idx, F64 time)
+   {
+      if ( idx < (U32)mLayers.size() )
+         mLayers[idx].mTime = time;
+   }
+
+   bool AnimationComponent::setLayerMask(U32 idx, const char* maskRootNode)
+   {
+      if ( idx >= (U32)mLayers.size() || mMeshAsset.isNull() )
+         return false;
+
+      if ( maskRootNode == NULL || maskRootNode[0] == 0 )
+      {
+         mLayers[idx].mMask.clear();
+         return true;
+      }
+
+      return mMeshAsset->buildNodeMask(maskRootNode, mLayers[idx].mMask);
+   }
+
+   // ----------------------------------------------------------------------------
+   //  Animation Update
+   // ----------------------------------------------------------------------------
+
+   struct AnimationJob
+   {
+      MeshAsset*           mesh;
+      AnimationState*      state;
+      AnimationLayer*      layers;
+      U32                  layerCount;
+      F32*                 transformsOut;
+      U32                  transformCount;
+      MeshComponent*       target;
+   };
+
+   static Vector<AnimationJob> gAnimationJobs;
+
+   static void _poseAnimations(void* data, U32 start, U32 end)
+   {
+      AnimationJob* jobs = (AnimationJob*)data;
+      for ( U32 n = start; n < end; ++n )
+      {
+         AnimationJob* job = &jobs[n];
+         job->transformCount = job->mesh->getAnimatedTransforms(job->state, job->layers, job->layerCount, job->transformsOut);
+      }
+   }
+
+   void updateAnimations()
+   {
+      U64 updateStart = bx::getHPCounter();
+
+      // Camera frustum and position for animation LOD.
+      F32 viewProjMtx[16];
+      bx::mtxMul(viewProjMtx, Rendering::viewMatrix, Rendering::projectionMatrix);
+      Rendering::Frustum frustum;
+      frustum.set(viewProjMtx);
+
+      F32 invViewMtx[16];
+      bx::mtxInverse(invViewMtx, Rendering::viewMatrix);
+      Point3F cameraPos(invViewMtx[12], invViewMtx[13], invViewMtx[14]);
+
+      // Gather everything that's due this frame.
+      gAnimationJobs.clear();
+      for ( S32 n = 0; n < gAnimationComponents.size(); ++n )
+      {
+         AnimationComponent* component = gAnimationComponents[n];
+         if ( component->mTarget.isNull() || component->mMeshAsset.isNull() || !component->mMeshAsset->isLoaded() )
+            continue;
+
+         // Only rendered targets have somewhere to put the bones.
+         F32* bones = component->mTarget->beginBoneUpdate();
+         if ( bones == NULL || component->mTarget->getBoneCount() < component->mMeshAsset->getSkeleton()->getBoneCount() )
+            continue;
+
+         if ( !component->_isUpdateDue(frustum, cameraPos) )
+            continue;
+
+         component->_ensureLayers();
+         component->mFramesSinceUpdate = 0;
+
+         gAnimationJobs.increment();
+         AnimationJob* job = &gAnimationJobs.last();
+         job->mesh = component->mMeshAsset;
+         job->state = &component->mAnimationState;
+         job->layers = component->mLayers.address();
+         job->layerCount = component->mLayers.size();
+         job->transformsOut = bones;
+         job->transformCount = 0;
+         job->target = component->mTarget;
+      }
+
+      Rendering::runFrameJob(_poseAnimations, gAnimationJobs.address(), gAnimationJobs.size(), 4);
+
+      // Queue the new poses for upload.
+      U32 boneCount = 0;
+      for ( S32 n = 0; n < gAnimationJobs.size(); ++n )
+      {
+         AnimationJob* job = &gAnimationJobs[n];
+         job->target->endBoneUpdate();
+         boneCount += job->transformCount;
+      }
+
+      animationStats.activeCount  = gAnimationComponents.size();
+      animationStats.updatedCount = gAnimationJobs.size();
+      animationStats.boneCount    = boneCount;
+      animationStats.updateTime   = (F32)((F64)(bx::getHPCounter() - updateStart) * 1000.0 / (F64)bx::getHPFrequency());
    }
 }
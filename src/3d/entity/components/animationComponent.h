@@ -35,12 +35,50 @@
 #include "meshComponent.h"
 #endif
 
+#ifndef _RENDERING_CULLING_H_
+#include "3d/rendering/culling.h"
+#endif
+
 #ifndef _TICKABLE_H_
 #include "platform/Tickable.h"
 #endif
 
 namespace Scene 
 {
+   // ----------------------------------------------------------------------------
+   //  Animation Update
+   // ----------------------------------------------------------------------------
+   //
+   //   AnimationComponents aren't posed in processMove. Every active component
+   //   is posed by updateAnimations(), called once per frame before culling:
+   //
+   //   1) Main thread: animation LOD decides which components are due this 
+   //      frame and they're gathered into a job list.
+   //   2) Worker pool: each job evaluates its layers straight into the 
+   //      target's range of the bone palette. Jobs only touch their own 
+   //      component and range.
+   //   3) Main thread: the ranges are queued for upload. The palette is 
+   //      copied when it's handed to bgfx, so the GPU never sees a pose 
+   //      that's half written.
+   //
+   //   With animationLOD on, characters are posed every frame while they're 
+   //   large on screen and less often as they shrink. Offscreen characters 
+   //   are posed rarely, and straight away when they come back into view.
+   //
+   // ----------------------------------------------------------------------------
+
+   struct AnimationStats
+   {
+      U32 activeCount;
+      U32 updatedCount;
+      U32 boneCount;
+      F32 updateTime;
+   };
+
+   extern bool             animationLOD;
+   extern AnimationStats   animationStats;
+   void updateAnimations();
+
    class AnimationComponent : public BaseComponent
    {
       private:
@@ -53,9 +91,26 @@ namespace Scene
 
 		 F64 mAnimationTime;
 		 F32 mSpeed;
+         StringTableEntry                 mClipName;
+         Vector<AnimationLayer>           mLayers;
+         AnimationState                   mAnimationState;
+
+         // Animation LOD
+         U32                              mUpdateInterval;
+         U32                              mFramesSinceUpdate;
+         bool                             mVisible;
+         bool                             mRegistered;
+
+         void _ensureLayers();
+         void _register();
+         void _unregister();
+         bool _isUpdateDue(const Rendering::Frustum& frustum, const Point3F& cameraPos);
+
+         friend void updateAnimations();
 
       public:
          AnimationComponent();
+         ~AnimationComponent();
 
          void onAddToScene();
          void onRemoveFromScene();
@@ -76,6 +131,16 @@ namespace Scene
          AssetPtr<MeshAsset> getMesh() { return mMeshAsset; }
          void setMesh(const char* pMeshAssetId);
 
+         // Layers
+         S32 playClip(const char* clipName, F32 fadeTime);
+         S32 addLayer(const char* clipName, F32 weight, bool additive, const char* maskRootNode);
+         void removeLayer(U32 idx);
+         void setLayerWeight(U32 idx, F32 weight, F32 fadeTime);
+         void setLayerSpeed(U32 idx, F32 speed);
+         void setLayerTime(U32 idx, F64 time);
+         bool setLayerMask(U32 idx, const char* maskRootNode);
+         U32 getLayerCount() { return mLayers.size(); }
+
 
       protected:
          static bool setMesh(void* obj, const char* data) { static_cast<AnimationComponent*>(obj)->setMesh( data ); return false; }
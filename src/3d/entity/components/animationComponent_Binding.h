@@ -22,14 +22,123 @@
 
 #include "c-interface/c-interface.h"
 
-ConsoleMethodGroupBeginWithDocs(AnimationComponent, BaseComponent)
+ConsoleNamespaceFunction( Scene, setAnimationLOD, ConsoleVoid, 2, 2, ("Enables or disables lowering the update rate of small and offscreen animations."))
+{
+   Scene::animationLOD = dAtob(argv[1]);
+}
 
-// Nothing Yet
-
-ConsoleMethodGroupEndWithDocs(AnimationComponent)
+ConsoleNamespaceFunction( Scene, getAnimationStats, ConsoleString, 1, 1, ("Returns \"active updated bones milliseconds\" for the last frame."))
+{
+   char* buffer = Con::getReturnBuffer(64);
+   dSprintf(buffer, 64, "%d %d %d %.3f", 
+      Scene::animationStats.activeCount,
+      Scene::animationStats.updatedCount,
+      Scene::animationStats.boneCount,
+      Scene::animationStats.updateTime);
+   return buffer;
+}
 
 namespace Scene{
+   ConsoleMethodGroupBeginWithDocs(AnimationComponent, BaseComponent)
+
+   /*! Crossfades from the current full body animation to a clip.
+       @param clipName Name of the clip to play.
+       @param fadeTime Crossfade duration in seconds (default 0.25).
+       @return The layer index of the new clip, or -1 if the clip wasn't found.
+   */
+   ConsoleMethodWithDocs(AnimationComponent, playClip, ConsoleInt, 3, 4, (clipName, [fadeTime]))
+   {
+      F32 fadeTime = argc > 3 ? dAtof(argv[3]) : 0.25f;
+      return object->playClip(argv[2], fadeTime);
+   }
+
+   /*! Adds a layer playing a clip, optionally additive and masked to part of the skeleton.
+       @param clipName Name of the clip to play.
+       @param weight Layer weight (default 1).
+       @param additive Whether the clip is added on top of the blended pose (default false).
+       @param maskRootNode Only this node and its children are affected (default everything).
+       @return The layer index, or -1 if the clip wasn't found.
+   */
+   ConsoleMethodWithDocs(AnimationComponent, addLayer, ConsoleInt, 3, 6, (clipName, [weight], [additive], [maskRootNode]))
+   {
+      F32 weight = argc > 3 ? dAtof(argv[3]) : 1.0f;
+      bool additive = argc > 4 ? dAtob(argv[4]) : false;
+      const char* maskRootNode = argc > 5 ? argv[5] : "";
+      return object->addLayer(argv[2], weight, additive, maskRootNode);
+   }
+
+   /*! Removes a layer.
+       @param layer Layer index.
+       @return No return value.
+   */
+   ConsoleMethodWithDocs(AnimationComponent, removeLayer, ConsoleVoid, 3, 3, (layer))
+   {
+      object->removeLayer(dAtoi(argv[2]));
+   }
+
+   /*! Sets (or fades to) a layer weight.
+       @param layer Layer index.
+       @param weight New weight.
+       @param fadeTime Seconds to reach the weight (default 0).
+       @return No return value.
+   */
+   ConsoleMethodWithDocs(AnimationComponent, setLayerWeight, ConsoleVoid, 4, 5, (layer, weight, [fadeTime]))
+   {
+      F32 fadeTime = argc > 4 ? dAtof(argv[4]) : 0.0f;
+      object->setLayerWeight(dAtoi(argv[2]), dAtof(argv[3]), fadeTime);
+   }
+
+   /*! Sets a layer's playback speed.
+       @param layer Layer index.
+       @param speed Playback speed multiplier.
+       @return No return value.
+   */
+   ConsoleMethodWithDocs(AnimationComponent, setLayerSpeed, ConsoleVoid, 4, 4, (layer, speed))
+   {
+      object->setLayerSpeed(dAtoi(argv[2]), dAtof(argv[3]));
+   }
+
+   /*! Sets a layer's playback time.
+       @param layer Layer index.
+       @param time Time in seconds.
+       @return No return value.
+   */
+   ConsoleMethodWithDocs(AnimationComponent, setLayerTime, ConsoleVoid, 4, 4, (layer, time))
+   {
+      object->setLayerTime(dAtoi(argv[2]), dAtof(argv[3]));
+   }
+
+   /*! Restricts a layer to a node and its children.
+       @param layer Layer index.
+       @param maskRootNode Node name, or empty to affect the whole skeleton.
+       @return Whether the node was found.
+   */
+   ConsoleMethodWithDocs(AnimationComponent, setLayerMask, ConsoleBool, 4, 4, (layer, maskRootNode))
+   {
+      return object->setLayerMask(dAtoi(argv[2]), argv[3]);
+   }
+
+   /*! Gets the number of active layers.
+       @return The layer count.
+   */
+   ConsoleMethodWithDocs(AnimationComponent, getLayerCount, ConsoleInt, 2, 2, ())
+   {
+      return object->getLayerCount();
+   }
+
+   ConsoleMethodGroupEndWithDocs(AnimationComponent)
+
    extern "C" {
+      DLL_PUBLIC void Scene_SetAnimationLOD(bool enabled)
+      {
+         Scene::animationLOD = enabled;
+      }
+
+      DLL_PUBLIC void Scene_GetAnimationStats(Scene::AnimationStats* outStats)
+      {
+         *outStats = Scene::animationStats;
+      }
+
       DLL_PUBLIC AnimationComponent* AnimationComponentCreateInstance()
       {
          return new AnimationComponent();
@@ -64,5 +173,25 @@ namespace Scene{
       {
          animationComponent->setMesh(meshAssetId);
       }
+
+      DLL_PUBLIC S32 AnimationComponentPlayClip(AnimationComponent* animationComponent, const char* clipName, F32 fadeTime)
+      {
+         return animationComponent->playClip(clipName, fadeTime);
+      }
+
+      DLL_PUBLIC S32 AnimationComponentAddLayer(AnimationComponent* animationComponent, const char* clipName, F32 weight, bool additive, const char* maskRootNode)
+      {
+         return animationComponent->addLayer(clipName, weight, additive, maskRootNode);
+      }
+
+      DLL_PUBLIC void AnimationComponentRemoveLayer(AnimationComponent* animationComponent, U32 idx)
+      {
+         animationComponent->removeLayer(idx);
+      }
+
+      DLL_PUBLIC void AnimationComponentSetLayerWeight(AnimationComponent* animationComponent, U32 idx, F32 weight, F32 fadeTime)
+      {
+         animationComponent->setLayerWeight(idx, weight, fadeTime);
+      }
    }
 }
\ No newline at end of file
@@ -61,17 +61,22 @@ namespace Scene
    {
       if ( !mOwnerEntity ) return;
 
+      F32 mtxWorld[16];
+      bx::mtxSRT(mtxWorld, mOwnerEntity->mScale.x, mOwnerEntity->mScale.y, mOwnerEntity->mScale.z,
+                           mOwnerEntity->mRotation.x, mOwnerEntity->mRotation.y, mOwnerEntity->mRotation.z,
+                           mOwnerEntity->mPosition.x, mOwnerEntity->mPosition.y, mOwnerEntity->mPosition.z);
+
+      updateTransform(mtxWorld);
+   }
+
+   void BaseComponent::updateTransform(const F32* mtxWorld)
+   {
       // Build Transformation Matrix
       F32 mtxLocal[16];
       bx::mtxSRT(mtxLocal, mScale.x, mScale.y, mScale.z,
                            mRotation.x, mRotation.y, mRotation.z,
                            mPosition.x, mPosition.y, mPosition.z);
 
-      F32 mtxWorld[16];
-      bx::mtxSRT(mtxWorld, mOwnerEntity->mScale.x, mOwnerEntity->mScale.y, mOwnerEntity->mScale.z,
-                           mOwnerEntity->mRotation.x, mOwnerEntity->mRotation.y, mOwnerEntity->mRotation.z,
-                           mOwnerEntity->mPosition.x, mOwnerEntity->mPosition.y, mOwnerEntity->mPosition.z);
-
       // Combine local and world.
       bx::mtxIdentity(mTransformMatrix);
       bx::mtxMul(mTransformMatrix, mtxLocal, mtxWorld );
@@ -89,6 +89,10 @@ namespace Scene
          virtual void setOwnerEntity( Scene::SceneEntity* owner ) { mOwnerEntity = owner; }
          virtual void refresh();
 
+         // Rebuilds the transform matrix against the given world matrix 
+         // instead of the owner's position, rotation and scale.
+         void updateTransform(const F32* mtxWorld);
+
          virtual Box3F     getBoundingBox()     { return mBoundingBox; }
          virtual Point3F   getWorldPosition()   { return mWorldPosition; }
          virtual void setWorldPosition(Point3F pos) { mWorldPosition = pos; }
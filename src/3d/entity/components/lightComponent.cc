@@ -24,6 +24,7 @@
 #include "lightComponent.h"
 #include "graphics/core.h"
 #include "3d/rendering/common.h"
+#include "3d/rendering/lightGrid.h"
 #include "3d/scene/core.h"
 #include "3d/scene/camera.h"
 
@@ -49,8 +50,7 @@ namespace Scene
 
    LightComponent::LightComponent()
    {
-      mRenderData    = NULL;
-      mLightData     = NULL;
+      mLightIndex    = -1;
       mLightRadius   = 10.0f;
       mLightColor    = ColorF(1.0f, 1.0f, 1.0f);
       mLightAtten    = 0.8f;
@@ -70,31 +70,20 @@ namespace Scene
 
    void LightComponent::onAddToScene()
    {  
-      // Register Light Data ( for forward )
-      Rendering::LightData light_data;
-      Rendering::lightList.push_back(light_data);
-      mLightData = &Rendering::lightList.back();
-
-      // Render Data ( for deferred )
-      mRenderData       = Rendering::createRenderData();
-      mRenderData->view = Graphics::getView("DeferredLight");
-      
-      mRenderData->indexBuffer   = Graphics::cubeIB;
-      mRenderData->vertexBuffer  = Graphics::cubeVB;
-      mRenderData->shader        = Graphics::getShader("rendering/pointlight_vs.sc", "rendering/pointlight_fs.sc")->mProgram;
-      mRenderData->state         = 0 | BGFX_STATE_RGB_WRITE | BGFX_STATE_ALPHA_WRITE | BGFX_STATE_CULL_CCW | BGFX_STATE_BLEND_ADD;
-
-      mScale.set(mLightRadius - 1.0f, mLightRadius - 1.0f, mLightRadius - 1.0f);
+      // Register Light Data. Forward materials use the nearest lights, deferred
+      // shading bins every light into the clustered light grid.
+      mLightIndex = Rendering::createLight();
 
       refresh();
    }
 
    void LightComponent::onRemoveFromScene()
    {  
-      if ( mRenderData == NULL )
+      if ( mLightIndex < 0 )
          return;
 
-      mRenderData->deleted = true;
+      Rendering::destroyLight(mLightIndex);
+      mLightIndex = -1;
    }
 
    void LightComponent::refresh()
@@ -106,56 +95,16 @@ namespace Scene
 
       // Sanity Checks.
       if ( mOwnerEntity == NULL ) return;
-      if ( mLightData == NULL ) return;
-
-      mLightData->position    = mWorldPosition;
-      mLightData->radius      = mLightRadius;
-      mLightData->color[0]    = mLightColor.red;
-      mLightData->color[1]    = mLightColor.green;
-      mLightData->color[2]    = mLightColor.blue;
-      mLightData->attenuation = mLightAtten;
-
-      // Debug Render.
-      if ( mRenderData )
-      {
-         // Base Component transform matrix is always slot 0 in the transform table.
-         mRenderData->transformTable = &mTransformMatrix[0];
-         mRenderData->transformCount = 1;
-
-         // Depth Texture
-         textures.clear();
-         mRenderData->textures = &textures;
-
-         // Depth
-         Rendering::TextureData depthTex;
-         depthTex.uniform = Graphics::Shader::getTextureUniform(0);
-         depthTex.isDepthTexture = true;
-         textures.push_back(depthTex);
-
-         // Normals
-         Rendering::TextureData normalsTex;
-         normalsTex.uniform = Graphics::Shader::getTextureUniform(1);
-         normalsTex.isNormalTexture = true;
-         textures.push_back(normalsTex);
-
-         // Setup Uniforms with Light Data
-         mRenderData->uniforms.uniforms = &uniforms;
-         uniforms.clear();
-
-         // [PosX, PosY, PosZ, Radius]
-         uniforms.push_back(Rendering::UniformData(Graphics::Shader::getUniformVec4("singleLightPosRadius")));
-         Rendering::UniformData* uLightPosRadius = &uniforms.back();
-         uLightPosRadius->setValue(Point4F(mLightData->position.x, mLightData->position.y, mLightData->position.z, mLightData->radius));
-
-         // [ColorR, ColorG, ColorB, Attenuation(0-1)]
-         uniforms.push_back(Rendering::UniformData(Graphics::Shader::getUniformVec4("singleLightColorAttn")));
-         Rendering::UniformData* uLightColorAttn = &uniforms.back();
-         uLightColorAttn->setValue(Point4F(mLightData->color[0], mLightData->color[1], mLightData->color[2], mLightData->attenuation));
-
-         // Camera Pos
-         uniforms.push_back(Rendering::UniformData(Graphics::Shader::getUniformVec4("ptLightCamPos")));
-         Rendering::UniformData* uLightCamPos = &uniforms.back();
-         uLightCamPos->setValue(Scene::getActiveCamera()->getPosition());
-      }
+      if ( mLightIndex < 0 ) return;
+
+      // lightList can reallocate so the light is looked up by index.
+      Rendering::LightData* lightData = &Rendering::lightList[mLightIndex];
+      lightData->position    = mWorldPosition;
+      lightData->radius      = mLightRadius;
+      lightData->color[0]    = mLightColor.red;
+      lightData->color[1]    = mLightColor.green;
+      lightData->color[2]    = mLightColor.blue;
+      lightData->attenuation = mLightAtten;
+      Rendering::updateLight(mLightIndex);
    }
 }
@@ -59,16 +59,10 @@ namespace Scene
          typedef BaseComponent Parent;
 
          // Light Data
-         Rendering::LightData*                  mLightData;
+         S32                                    mLightIndex;
          F32                                    mLightRadius;
          ColorF                                 mLightColor;
          F32                                    mLightAtten;
-         Vector<Rendering::UniformData>         uniforms;
-         Vector<Rendering::TextureData>         textures;
-
-         // Debug Render
-         Rendering::RenderData*                 mRenderData;
-         AssetPtr<Graphics::ShaderAsset>        mShaderAsset;
 
       public:
          LightComponent();
@@ -25,6 +25,8 @@
 #include "graphics/core.h"
 #include "3d/entity/entity.h"
 #include "3d/rendering/common.h"
+#include "3d/rendering/culling.h"
+#include "3d/rendering/bonePalette.h"
 
 // Script bindings.
 #include "meshComponent_Binding.h"
@@ -48,15 +50,19 @@ namespace Scene
 
    MeshComponent::MeshComponent()
    {
-      mTransformCount = 0;
+      mBoneOffset = Rendering::InvalidBoneRange;
+      mBoneCount = 0;
    }
 
    MeshComponent::~MeshComponent()
    {
+      MeshLoader::removeListener(this);
+      _freeBones();
+
       for ( S32 n = 0; n < mSubMeshes.size(); ++n )
       {
          SubMesh* subMesh = &mSubMeshes[n];
-         subMesh->renderData->deleted = true;
+         Rendering::destroyRenderData(subMesh->renderData);
       }
    }
 
@@ -104,29 +110,52 @@ namespace Scene
       if ( mOwnerEntity )
          renderMesh = !mOwnerEntity->mGhosted || mOwnerEntity->isClientObject();
 
-      if ( renderMesh )
+      if ( renderMesh && mMeshAsset->isLoaded() )
+         _createSubMeshes();
+
+      refresh();
+
+      // Meshes that are still streaming in show up once they're loaded. Until
+      // then this component pulls its mesh forward in the load queue if it's
+      // close to the camera.
+      if ( renderMesh && !mMeshAsset->isLoaded() )
       {
-         for ( U32 n = 0; n < mMeshAsset->getMeshCount(); ++n )
-         {
-            SubMesh subMesh;
-            subMesh.renderData = Rendering::createRenderData();
-            mSubMeshes.push_back(subMesh);
-         }
+         MeshLoader::setLoadPosition(mMeshAsset, mWorldPosition);
+         MeshLoader::addListener(mMeshAsset, this);
       }
+   }
 
+   void MeshComponent::onMeshLoaded(MeshAsset* asset)
+   {
+      _createSubMeshes();
       refresh();
    }
 
+   void MeshComponent::_createSubMeshes()
+   {
+      for ( U32 n = 0; n < mMeshAsset->getMeshCount(); ++n )
+      {
+         SubMesh subMesh;
+         subMesh.renderData = Rendering::createRenderData();
+         mSubMeshes.push_back(subMesh);
+      }
+   }
+
    void MeshComponent::onRemoveFromScene()
    {
+      MeshLoader::removeListener(this);
       if ( mOwnerEntity && mOwnerEntity->isServerObject() )
          return;
 
       for ( S32 n = 0; n < mSubMeshes.size(); ++n )
       {
          SubMesh* subMesh = &mSubMeshes[n];
-         subMesh->renderData->deleted = true;
+         Rendering::destroyRenderData(subMesh->renderData);
       }
+
+      // The slots will be recycled, don't hold on to them.
+      mSubMeshes.clear();
+      _freeBones();
    }
 
    void MeshComponent::refresh()
@@ -138,6 +167,7 @@ namespace Scene
       if ( mMeshAsset.isNull() ) return;
       if ( mMaterialAssets.size() < 1 ) return;
 
+      _allocBones();
       refreshTransforms();
 
       for ( S32 n = 0; n < mSubMeshes.size(); ++n )
@@ -148,6 +178,8 @@ namespace Scene
          subMesh->renderData->castShadow = true;
          subMesh->renderData->indexBuffer = mMeshAsset->getIndexBuffer(n);
          subMesh->renderData->vertexBuffer = mMeshAsset->getVertexBuffer(n);
+         subMesh->renderData->triangleCount = mMeshAsset->getTriangleCount(n);
+         _refreshLODs(subMesh, n);
 
          // Uniform/Texture Vectors (these are filled by applyMaterial)
          subMesh->uniforms.clear();
@@ -175,11 +207,18 @@ namespace Scene
       {
          SubMesh* subMesh = &mSubMeshes[n];
 
-         // Base Component transform matrix is always slot 0 in the transform table.
-         dMemcpy(mTransformTable[0], mTransformMatrix, sizeof(mTransformMatrix));
-         if ( mTransformCount < 1 ) mTransformCount = 1;
-         subMesh->renderData->transformTable = mTransformTable[0];
-         subMesh->renderData->transformCount = mTransformCount;
+         // Bones come from the bone palette so the table is just the component transform.
+         subMesh->renderData->transformTable = mTransformMatrix;
+         subMesh->renderData->transformCount = 1;
+         subMesh->renderData->isSkinned = mMeshAsset->isSkinned();
+         subMesh->renderData->boneOffset = mBoneOffset;
+         subMesh->renderData->boneCount = mBoneCount;
+
+         // World space bounds for culling. Skinned submeshes can be posed
+         // outside of their own bounds so they use the bounds of the whole mesh.
+         Box3F localBounds = mMeshAsset->isSkinned() ? mMeshAsset->getBoundingBox() : mMeshAsset->getBoundingBox(n);
+         subMesh->renderData->bounds = Rendering::transformBox(mTransformMatrix, localBounds);
+         subMesh->renderData->hasBounds = true;
       }
 
       // Bounding Box
@@ -187,4 +226,96 @@ namespace Scene
       mBoundingBox.minExtents += mPosition;
       mBoundingBox.maxExtents += mPosition;
    }
+
+   // Culling picks the level each frame. The current level is kept across
+   // refreshes so a mesh doesn't pop back to full detail for a frame.
+   void MeshComponent::_refreshLODs(SubMesh* subMesh, U32 idx)
+   {
+      Rendering::RenderData* renderData = subMesh->renderData;
+      U32 lodCount = mMeshAsset->getLODCount(idx);
+
+      subMesh->lods.clear();
+      if ( lodCount < 2 )
+      {
+         renderData->lods = NULL;
+         renderData->lodCount = 0;
+         renderData->lodLevel = 0;
+         return;
+      }
+
+      subMesh->lods.setSize(lodCount);
+      for ( U32 n = 0; n < lodCount; ++n )
+      {
+         Rendering::RenderLOD* lod = &subMesh->lods[n];
+         lod->indexBuffer     = mMeshAsset->getLODIndexBuffer(idx, n);
+         lod->triangleCount   = mMeshAsset->getLODTriangleCount(idx, n);
+         lod->error           = mMeshAsset->getLODError(idx, n);
+      }
+
+      renderData->lods = subMesh->lods.address();
+      renderData->lodCount = (U8)lodCount;
+      if ( renderData->lodLevel >= lodCount )
+         renderData->lodLevel = 0;
+
+      renderData->indexBuffer = subMesh->lods[renderData->lodLevel].indexBuffer;
+      renderData->triangleCount = subMesh->lods[renderData->lodLevel].triangleCount;
+   }
+
+   // Only rendered skinned meshes get a range. Until they're first posed the 
+   // range holds the bind pose.
+   void MeshComponent::_allocBones()
+   {
+      U32 boneCount = 0;
+      if ( mSubMeshes.size() > 0 && mMeshAsset->isSkinned() )
+         boneCount = mMeshAsset->getSkeleton()->getBoneCount();
+
+      if ( boneCount == mBoneCount )
+         return;
+
+      _freeBones();
+      if ( boneCount < 1 )
+         return;
+
+      mBoneOffset = Rendering::allocBoneRange(boneCount);
+      if ( mBoneOffset == Rendering::InvalidBoneRange )
+      {
+         Con::warnf("[MeshComponent] Bone palette is full, %s will render in its bind pose.", mMeshAssetId);
+         return;
+      }
+
+      mBoneCount = boneCount;
+      F32* bones = Rendering::beginBoneUpdate(mBoneOffset);
+      for ( U32 n = 0; n < mBoneCount; ++n )
+         bx::mtxIdentity(&bones[n * 16]);
+      Rendering::endBoneUpdate(mBoneOffset, mBoneCount);
+   }
+
+   void MeshComponent::_freeBones()
+   {
+      Rendering::freeBoneRange(mBoneOffset, mBoneCount);
+      mBoneOffset = Rendering::InvalidBoneRange;
+      mBoneCount = 0;
+   }
+
+   // Bones are written straight into the bone palette, getBoneCount() of them.
+   F32* MeshComponent::beginBoneUpdate()
+   {
+      if ( mBoneOffset == Rendering::InvalidBoneRange )
+         return NULL;
+
+      return Rendering::beginBoneUpdate(mBoneOffset);
+   }
+
+   void MeshComponent::endBoneUpdate()
+   {
+      Rendering::endBoneUpdate(mBoneOffset, mBoneCount);
+   }
+
+   Box3F MeshComponent::getWorldBounds()
+   {
+      if ( mMeshAsset.isNull() )
+         return Box3F(mPosition, mPosition);
+
+      return Rendering::transformBox(mTransformMatrix, mMeshAsset->getBoundingBox());
+   }
 }
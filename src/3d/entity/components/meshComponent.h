@@ -43,6 +43,10 @@
 #include "3d/entity/meshAsset.h"
 #endif
 
+#ifndef _MESH_LOADER_H_
+#include "3d/entity/meshLoader.h"
+#endif
+
 #ifndef _MATERIAL_ASSET_H_
 #include "3d/material/materialAsset.h"
 #endif
@@ -58,7 +62,7 @@
 namespace Scene 
 {
 
-   class MeshComponent : public BaseComponent
+   class MeshComponent : public BaseComponent, protected MeshLoader::Listener
    {
       struct SubMesh
       {
@@ -66,6 +70,7 @@ namespace Scene
          Vector<Rendering::UniformData>               uniforms;
          Vector<Rendering::TextureData>               textures;
          Vector<Rendering::InstanceData>              instances;
+         Vector<Rendering::RenderLOD>                 lods;
       };
 
       private:
@@ -75,10 +80,19 @@ namespace Scene
          Vector< AssetPtr<MaterialAsset> >            mMaterialAssets;
          Vector<SubMesh>                              mSubMeshes;
 
+         // Skinned meshes own a range of the bone palette while they're rendered.
+         U32                                          mBoneOffset;
+         U32                                          mBoneCount;
+
+         void _createSubMeshes();
+         void _allocBones();
+         void _freeBones();
+         void _refreshLODs(SubMesh* subMesh, U32 idx);
+
+      protected:
+         virtual void onMeshLoaded(MeshAsset* asset);
+
       public:
-         // TODO: maybe not public?
-         F32                              mTransformTable[60][16];
-         U32                              mTransformCount;
 
          MeshComponent();
          ~MeshComponent();
@@ -87,6 +101,10 @@ namespace Scene
          void onRemoveFromScene();
          void refresh();
          void refreshTransforms();
+         U32  getBoneCount() { return mBoneCount; }
+         F32* beginBoneUpdate();
+         void endBoneUpdate();
+         Box3F getWorldBounds();
          void setMesh( const char* pMeshAssetId );
          AssetPtr<MeshAsset> getMesh() { return mMeshAsset; }
 
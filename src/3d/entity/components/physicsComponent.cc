@@ -57,6 +57,11 @@ namespace Scene
       mPhysicsObject       = NULL;
       mLastTime            = 0;
       mStatic              = false;
+      mShapeName           = StringTable->insert("box");
+      mShapeType           = Physics::PhysicsShape::Box;
+      mMass                = 1.0f;
+      mMeshAssetId         = StringTable->insert("");
+      mHeightfieldCell.set(0, 0);
 
       // These are applied to the target.
       mScale.set(1.0f, 1.0f, 1.0f);
@@ -64,6 +69,11 @@ namespace Scene
       mRotation.set(0.0f, 0.0f, 0.0f);
    }
 
+   PhysicsComponent::~PhysicsComponent()
+   {
+      MeshLoader::removeListener(this);
+   }
+
    void PhysicsComponent::initPersistFields()
    {
       // Call parent.
@@ -73,9 +83,26 @@ namespace Scene
          addField("onCollideFunction", TypeString,    Offset(mOnCollideFunction, PhysicsComponent), "");
          addField("collisionType",     TypeString,    Offset(mCollisionType, PhysicsComponent), "");
          addField("static",            TypeBool,      Offset(mStatic, PhysicsComponent), "");
+         addField("shape",             TypeString,    Offset(mShapeName, PhysicsComponent), "box, sphere, capsule, convex, mesh or heightfield.");
+         addField("mass",              TypeF32,       Offset(mMass, PhysicsComponent), "");
+         addProtectedField("meshAsset", TypeAssetId,  Offset(mMeshAssetId, PhysicsComponent), &setMesh, &defaultProtectedGetFn, "Mesh used by convex and mesh shapes.");
+         addField("heightfield",       TypePoint2I,   Offset(mHeightfieldCell, PhysicsComponent), "Terrain cell used by heightfield shapes.");
       endGroup("PhysicsComponent");
    }
 
+   void PhysicsComponent::setMesh( const char* pMeshAssetId )
+   {
+      // Sanity!
+      AssertFatal( pMeshAssetId != NULL, "Cannot use a NULL asset Id." );
+
+      // Fetch the asset Id.
+      mMeshAssetId = StringTable->insert(pMeshAssetId);
+      mMeshAsset.setAssetId(mMeshAssetId);
+
+      if ( mMeshAsset.isNull() )
+         Con::errorf("[PhysicsComponent] Failed to load mesh asset.");
+   }
+
 
    void PhysicsComponent::onAddToScene()
    {  
@@ -86,11 +113,93 @@ namespace Scene
 
       mPhysicsObject = Physics::getPhysicsObject(this);
       mPhysicsObject->onCollideDelegate.bind(this, &PhysicsComponent::onCollide);
+      mPhysicsObject->setMass(mMass);
+      _setShape();
+
+      // Terrain doesn't move and isn't placed by the entity.
+      if ( mShapeType != Physics::PhysicsShape::Heightfield )
+         mPhysicsObject->onTransformDelegate.bind(this, &PhysicsComponent::onTransform);
+
       mOwnerEntity->setProcessTick(true);
    }
 
+   Physics::PhysicsShape::Type PhysicsComponent::_getShapeType()
+   {
+      if ( dStricmp(mShapeName, "sphere") == 0 )
+         return Physics::PhysicsShape::Sphere;
+      if ( dStricmp(mShapeName, "capsule") == 0 )
+         return Physics::PhysicsShape::Capsule;
+      if ( dStricmp(mShapeName, "convex") == 0 )
+         return Physics::PhysicsShape::ConvexHull;
+      if ( dStricmp(mShapeName, "mesh") == 0 )
+         return Physics::PhysicsShape::TriangleMesh;
+      if ( dStricmp(mShapeName, "heightfield") == 0 )
+         return Physics::PhysicsShape::Heightfield;
+
+      if ( dStrlen(mShapeName) > 0 && dStricmp(mShapeName, "box") != 0 )
+         Con::warnf("[PhysicsComponent] Unknown shape '%s', using a box.", mShapeName);
+
+      return Physics::PhysicsShape::Box;
+   }
+
+   // Cooked shapes come from the cache when possible. Otherwise the object
+   // waits on the game side until its mesh has loaded, see onMeshLoaded.
+   void PhysicsComponent::_setShape()
+   {
+      mShapeType = _getShapeType();
+      if ( Physics::PhysicsShape::isPrimitive(mShapeType) )
+      {
+         mPhysicsObject->setShape(mShapeType, NULL);
+         return;
+      }
+
+      Physics::PhysicsShape* shape = NULL;
+      if ( mShapeType == Physics::PhysicsShape::Heightfield )
+      {
+         shape = Physics::getHeightfieldShape(mHeightfieldCell.x, mHeightfieldCell.y);
+         if ( shape == NULL )
+            Con::warnf("[PhysicsComponent] No terrain at cell %d %d, using a box.", mHeightfieldCell.x, mHeightfieldCell.y);
+      }
+      else if ( mMeshAsset.isNull() )
+      {
+         Con::warnf("[PhysicsComponent] Shape '%s' needs a mesh asset, using a box.", mShapeName);
+      }
+      else
+      {
+         shape = Physics::getMeshShape(mShapeType, mMeshAsset);
+         if ( shape == NULL && !mMeshAsset->isLoaded() )
+         {
+            mPhysicsObject->setShape(mShapeType, NULL);
+            MeshLoader::request(mMeshAsset);
+            MeshLoader::addListener(mMeshAsset, this);
+            return;
+         }
+      }
+
+      if ( shape == NULL )
+         mShapeType = Physics::PhysicsShape::Box;
+
+      mPhysicsObject->setShape(mShapeType, shape);
+   }
+
+   void PhysicsComponent::onMeshLoaded(MeshAsset* asset)
+   {
+      if ( mPhysicsObject == NULL )
+         return;
+
+      Physics::PhysicsShape* shape = Physics::getMeshShape(mShapeType, asset);
+      if ( shape == NULL )
+      {
+         Con::warnf("[PhysicsComponent] Could not build a collision shape from %s, using a box.", asset->getMeshFile());
+         mShapeType = Physics::PhysicsShape::Box;
+      }
+
+      mPhysicsObject->setShape(mShapeType, shape);
+   }
+
    void PhysicsComponent::onRemoveFromScene()
    {
+      MeshLoader::removeListener(this);
       if ( mPhysicsObject != NULL )
          Physics::deletePhysicsObject(mPhysicsObject);
       
@@ -99,7 +208,7 @@ namespace Scene
 
    void PhysicsComponent::processMove(const Move* move)
    {
-      if ( mPhysicsObject == NULL )
+      if ( mPhysicsObject == NULL || mShapeType == Physics::PhysicsShape::Heightfield )
          return;
 
       Point3F physics_position = mPhysicsObject->getPosition();
@@ -114,19 +223,48 @@ namespace Scene
       if ( mPhysicsObject == NULL )
          return;
 
-      if ( !mPhysicsObject->initialized )
+      if ( !mPhysicsObject->added )
       {
-         mPhysicsObject->setPosition(mOwnerEntity->mPosition + mPosition);
+         if ( mShapeType == Physics::PhysicsShape::Heightfield )
+            mPhysicsObject->setPosition(Point3F(0.0f, 0.0f, 0.0f));
+         else
+            mPhysicsObject->setPosition(mOwnerEntity->mPosition + mPosition);
          mPhysicsObject->setScale(mScale * mOwnerEntity->mScale);
          mPhysicsObject->setStatic(mStatic);
       }
    }
 
-   void PhysicsComponent::onCollide(void* _hitUser)
+   // Contacts are reported once when they begin and once when they end.
+   void PhysicsComponent::onCollide(void* _hitUser, Physics::PhysicsContact::State _state)
    {
       PhysicsComponent* collideComp = (PhysicsComponent*)_hitUser;
       if ( dStrlen(mOnCollideFunction) > 0 )
-         Con::executef(mOwnerEntity, 3, mOnCollideFunction, Con::getIntArg(collideComp->mOwnerEntity->getId()), "");
+      {
+         const char* state = _state == Physics::PhysicsContact::Begin ? "begin" : "end";
+         Con::executef(mOwnerEntity, 3, mOnCollideFunction, Con::getIntArg(collideComp->mOwnerEntity->getId()), state);
+      }
+   }
+
+   // Interpolated body transform, called every frame. The body sits at the
+   // entity position plus our offset (see refresh) so take that back off and
+   // apply the entity's scale.
+   void PhysicsComponent::onTransform(const F32* _transform)
+   {
+      F32 mtxWorld[16];
+      dMemcpy(mtxWorld, _transform, sizeof(mtxWorld));
+
+      for (U32 i = 0; i < 3; ++i)
+      {
+         mtxWorld[i]     *= mOwnerEntity->mScale.x;
+         mtxWorld[4 + i] *= mOwnerEntity->mScale.y;
+         mtxWorld[8 + i] *= mOwnerEntity->mScale.z;
+      }
+
+      mtxWorld[12] -= mPosition.x;
+      mtxWorld[13] -= mPosition.y;
+      mtxWorld[14] -= mPosition.z;
+
+      mOwnerEntity->updateTransform(mtxWorld);
    }
 
    void PhysicsComponent::setLinearVelocity( Point3F pVel )
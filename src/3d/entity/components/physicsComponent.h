@@ -39,9 +39,17 @@
 #include "physics/physics.h"
 #endif
 
+#ifndef _MESH_ASSET_H_
+#include "3d/entity/meshAsset.h"
+#endif
+
+#ifndef _MESH_LOADER_H_
+#include "3d/entity/meshLoader.h"
+#endif
+
 namespace Scene 
 {
-   class PhysicsComponent : public BaseComponent
+   class PhysicsComponent : public BaseComponent, protected MeshLoader::Listener
    {
       private:
          typedef BaseComponent Parent;
@@ -52,13 +60,31 @@ namespace Scene
          Physics::PhysicsObject*    mPhysicsObject;
          bool                       mStatic;
 
+         // Collision shape: box, sphere, capsule, convex, mesh or heightfield.
+         // Convex and mesh are built from the mesh asset, heightfield from
+         // the terrain cell at mHeightfieldCell.
+         StringTableEntry              mShapeName;
+         Physics::PhysicsShape::Type   mShapeType;
+         F32                           mMass;
+         StringTableEntry              mMeshAssetId;
+         AssetPtr<MeshAsset>           mMeshAsset;
+         Point2I                       mHeightfieldCell;
+
+         Physics::PhysicsShape::Type _getShapeType();
+         void _setShape();
+
+      protected:
+         virtual void onMeshLoaded(MeshAsset* asset);
+
       public:
          PhysicsComponent();
+         ~PhysicsComponent();
 
          void onAddToScene();
          void onRemoveFromScene();
          void refresh();
-         void onCollide(void* _hitUser);
+         void onCollide(void* _hitUser, Physics::PhysicsContact::State _state);
+         void onTransform(const F32* _transform);
          void setLinearVelocity(Point3F pVel);
 
          virtual void processMove(const Move* move);
@@ -69,10 +95,17 @@ namespace Scene
          void setCollisionType(StringTableEntry type) { mCollisionType = type; }
          bool getStatic() { return mStatic; }
          void setStatic(bool isStatic) { mStatic = isStatic; }
+         StringTableEntry getShape() { return mShapeName; }
+         void setShape(StringTableEntry shape) { mShapeName = shape; }
+         F32 getMass() { return mMass; }
+         void setMass(F32 mass) { mMass = mass; }
+         void setMesh( const char* pMeshAssetId );
 
          static void initPersistFields();
 
          DECLARE_CONOBJECT(PhysicsComponent);
+
+         static bool setMesh(void* obj, const char* data) { static_cast<PhysicsComponent*>(obj)->setMesh( data ); return false; }
    };
 }
 
@@ -73,6 +73,26 @@ namespace Scene
          PhysicsComponent->setStatic(isStatic);
       }
 
+      DLL_PUBLIC const char* PhysicsComponentGetShape(PhysicsComponent* PhysicsComponent)
+      {
+         return CInterface::GetMarshallableString(PhysicsComponent->getShape());
+      }
+
+      DLL_PUBLIC void PhysicsComponentSetShape(PhysicsComponent* PhysicsComponent, const char* shape)
+      {
+         PhysicsComponent->setShape(StringTable->insert(shape));
+      }
+
+      DLL_PUBLIC F32 PhysicsComponentGetMass(PhysicsComponent* PhysicsComponent)
+      {
+         return PhysicsComponent->getMass();
+      }
+
+      DLL_PUBLIC void PhysicsComponentSetMass(PhysicsComponent* PhysicsComponent, F32 mass)
+      {
+         PhysicsComponent->setMass(mass);
+      }
+
       DLL_PUBLIC void PhysicsComponentSetLinearVelocity(PhysicsComponent* PhysicsComponent, CInterface::Point3FParam vel)
       {
          PhysicsComponent->setLinearVelocity(vel);
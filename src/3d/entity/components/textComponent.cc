@@ -54,6 +54,8 @@ namespace Scene
 
    TextComponent::~TextComponent()
    {
+      Rendering::destroyRenderData(mRenderData);
+
       if ( mNVGContext != NULL )
          nvgDelete(mNVGContext);
    }
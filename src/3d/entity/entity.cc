@@ -24,6 +24,8 @@
 #include "console/consoleInternal.h"
 #include "components/baseComponent.h"
 #include "game/moveList.h"
+#include "3d/scene/core.h"
+#include "3d/rendering/common.h"
 
 #include "entity_Binding.h"
 
@@ -38,6 +40,8 @@ namespace Scene
 
       mTemplateAssetID = StringTable->EmptyString;
       mTemplate = NULL;
+      mSceneProxy = -1;
+      mBoundingBox.set(Point3F(0.0f, 0.0f, 0.0f), Point3F(0.0f, 0.0f, 0.0f));
       mScale.set(1.0f, 1.0f, 1.0f);
       mPosition.set(0.0f, 0.0f, 0.0f);
       mRotation.set(0.0f, 0.0f, 0.0f);
@@ -79,6 +83,7 @@ namespace Scene
 
    void SceneEntity::onGroupAdd()
    {
+      Scene::updateEntityProxy(this);
       if ( mTemplate == NULL ) return;
 
       for(S32 n = 0; n < mTemplate->size(); ++n)
@@ -96,6 +101,7 @@ namespace Scene
 
    void SceneEntity::onGroupRemove()
    {
+      Scene::removeEntityProxy(this);
       if ( mTemplate == NULL ) return;
 
       for(S32 n = 0; n < mTemplate->size(); ++n)
@@ -160,6 +166,7 @@ namespace Scene
       newBoundingBox.minExtents = (newBoundingBox.minExtents * mScale) + mPosition;
       newBoundingBox.maxExtents = (newBoundingBox.maxExtents * mScale) + mPosition;
       mBoundingBox = newBoundingBox;
+      Scene::updateEntityProxy(this);
 
       // Refresh components
       for(S32 n = 0; n < mComponents.size(); ++n)
@@ -169,6 +176,12 @@ namespace Scene
       //   setMaskBits(TransformMask);
    }
 
+   void SceneEntity::updateTransform(const F32* mtxWorld)
+   {
+      for(S32 n = 0; n < mComponents.size(); ++n)
+         mComponents[n]->updateTransform(mtxWorld);
+   }
+
    SimObject* SceneEntity::findComponentByType(const char* pType)
    {
       if ( mTemplate == NULL ) return NULL;
@@ -256,6 +269,17 @@ namespace Scene
          mComponents[n]->unpackUpdate(conn, stream);
    }
 
+   // Scopes the scene around this entity for a client using it as its scope
+   // object, out to the distance the camera draws.
+   void SceneEntity::onCameraScopeQuery(NetConnection *cr, CameraScopeQuery *camInfo)
+   {
+      camInfo->camera            = this;
+      camInfo->pos               = mPosition;
+      camInfo->visibleDistance   = Rendering::farPlane;
+
+      Scene::onCameraScopeQuery(cr, camInfo);
+   }
+
    void SceneEntity::processMove( const Move *move )
    {
       for(S32 n = 0; n < mComponents.size(); ++n)
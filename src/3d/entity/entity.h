@@ -66,6 +66,9 @@ namespace Scene
          Point3F  mRotation;
          Point3F  mScale;
 
+         // Proxy in the scene BVH, see Scene::updateEntityProxy.
+         S32      mSceneProxy;
+
          // GameObject
          virtual void processMove( const Move *move );
          virtual void interpolateMove( F32 delta );
@@ -73,6 +76,10 @@ namespace Scene
 
          void refresh();
 
+         // Moves every component to the given world matrix without a full
+         // refresh, bounds are left as they were.
+         void updateTransform(const F32* mtxWorld);
+
          static void initPersistFields();
 
          virtual bool onAdd();
@@ -105,6 +112,7 @@ namespace Scene
          void readPacketData (GameConnection *conn, BitStream *stream);
          U32  packUpdate(NetConnection* conn, U32 mask, BitStream* stream);
          void unpackUpdate(NetConnection* conn, BitStream* stream);
+         virtual void onCameraScopeQuery(NetConnection *cr, CameraScopeQuery *camInfo);
          void setGhosted(bool _value);
          void setTemplateAsset(StringTableEntry assetID);
 
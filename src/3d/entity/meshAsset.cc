@@ -22,6 +22,9 @@
 
 #include "console/consoleTypes.h"
 #include "meshAsset.h"
+#include "meshSimplify.h"
+#include "meshOptimize.h"
+#include "meshLoader.h"
 #include "graphics/core.h"
 #include "math/mMatrix.h"
 
@@ -35,6 +38,7 @@
 #include <bgfx.h>
 #include <bx/fpumath.h>
 #include <bx/timer.h>
+#include <bx/uint32_t.h>
 
 // Assimp - Asset Import Library
 #include <assimp/cimport.h>
@@ -43,14 +47,105 @@
 #include <assimp/types.h>
 
 // Binary Mesh Version Number
-U8 MeshAsset::BinVersion = 101;
+U8 MeshAsset::BinVersion = 106;
+U8 MeshAsset::LegacyBinVersion = 101;
+
+const F32 MeshAsset::MaxLODError = 0.1f;
+const F32 MeshAsset::OverdrawThreshold = 1.05f;
 
 MeshAsset* getMeshAsset(const char* id)
 {
    AssetPtr<MeshAsset> result;
    StringTableEntry assetId = StringTable->insert(id);
    result.setAssetId(assetId);
-   return result;
+
+   // Meshes load in the background, callers get one that's ready to use.
+   MeshAsset* asset = result;
+   if ( asset != NULL && !asset->isLoaded() )
+      MeshLoader::wait(asset);
+
+   return asset;
+}
+
+static S16 packSnorm(F32 value)
+{
+   value = mClampF(value, -1.0f, 1.0f) * 32767.0f;
+   return (S16)(value >= 0.0f ? value + 0.5f : value - 0.5f);
+}
+
+static void packUnitVector(S16* out, F32 x, F32 y, F32 z)
+{
+   F32 length = mSqrt(x * x + y * y + z * z);
+   F32 scale = length > 0.0f ? 1.0f / length : 0.0f;
+   out[0] = packSnorm(x * scale);
+   out[1] = packSnorm(y * scale);
+   out[2] = packSnorm(z * scale);
+   out[3] = 0;
+}
+
+static void packCompactVertex(Graphics::PosUVTBNCompactVertex* out, const Graphics::PosUVTBNBonesVertex& vert)
+{
+   out->m_x = vert.m_x;
+   out->m_y = vert.m_y;
+   out->m_z = vert.m_z;
+   out->m_u = bx::halfFromFloat(vert.m_u);
+   out->m_v = bx::halfFromFloat(vert.m_v);
+   packUnitVector(out->m_tangent, vert.m_tangent_x, vert.m_tangent_y, vert.m_tangent_z);
+   packUnitVector(out->m_bitangent, vert.m_bitangent_x, vert.m_bitangent_y, vert.m_bitangent_z);
+   packUnitVector(out->m_normal, vert.m_normal_x, vert.m_normal_y, vert.m_normal_z);
+}
+
+static void unpackCompactVertex(Graphics::PosUVTBNBonesVertex* out, const Graphics::PosUVTBNCompactVertex& vert)
+{
+   dMemset(out, 0, sizeof(Graphics::PosUVTBNBonesVertex));
+   out->m_x = vert.m_x;
+   out->m_y = vert.m_y;
+   out->m_z = vert.m_z;
+   out->m_u = bx::halfToFloat(vert.m_u);
+   out->m_v = bx::halfToFloat(vert.m_v);
+   out->m_tangent_x     = vert.m_tangent[0] / 32767.0f;
+   out->m_tangent_y     = vert.m_tangent[1] / 32767.0f;
+   out->m_tangent_z     = vert.m_tangent[2] / 32767.0f;
+   out->m_bitangent_x   = vert.m_bitangent[0] / 32767.0f;
+   out->m_bitangent_y   = vert.m_bitangent[1] / 32767.0f;
+   out->m_bitangent_z   = vert.m_bitangent[2] / 32767.0f;
+   out->m_normal_x      = vert.m_normal[0] / 32767.0f;
+   out->m_normal_y      = vert.m_normal[1] / 32767.0f;
+   out->m_normal_z      = vert.m_normal[2] / 32767.0f;
+}
+
+// Full 4x4 inverse, matching what Assimp gives for the scene root.
+static MatrixF inverseTransform(const MatrixF& mat)
+{
+   const F32* m = mat;
+   aiMatrix4x4 result(m[0], m[1], m[2], m[3], 
+                      m[4], m[5], m[6], m[7], 
+                      m[8], m[9], m[10], m[11], 
+                      m[12], m[13], m[14], m[15]);
+   result.Inverse();
+   return MatrixF(result);
+}
+
+// Index lists are 16 bit wherever the vertex count allows it.
+static U32 getIndexSize(U32 vertexCount)
+{
+   return vertexCount > 0xffff ? sizeof(U32) : sizeof(U16);
+}
+
+static void appendIndices(Vector<U8>& out, const U32* indices, U32 indexCount, U32 vertexCount)
+{
+   U32 start = out.size();
+   if ( getIndexSize(vertexCount) == sizeof(U32) )
+   {
+      out.setSize(start + indexCount * sizeof(U32));
+      dMemcpy(out.address() + start, indices, indexCount * sizeof(U32));
+      return;
+   }
+
+   out.setSize(start + indexCount * sizeof(U16));
+   U16* dest = (U16*)(out.address() + start);
+   for ( U32 i = 0; i < indexCount; ++i )
+      dest[i] = (U16)indices[i];
 }
 
 //------------------------------------------------------------------------------
@@ -103,13 +198,15 @@ IMPLEMENT_CONOBJECT(MeshAsset);
 //------------------------------------------------------------------------------
 
 MeshAsset::MeshAsset() : 
-   mMeshFile(StringTable->EmptyString),
-   mScene ( NULL )
+   mMeshFile(StringTable->EmptyString)
 {
-   mImportThread = NULL;
+   mBinBuffer = NULL;
+   mStaging = NULL;
+   mGlobalInverseTransform.identity();
    mBoundingBox.minExtents.set(0, 0, 0);
    mBoundingBox.maxExtents.set(0, 0, 0);
    mIsAnimated = false;
+   mCompactVertices = false;
    mIsLoaded = false;
 }
 
@@ -117,14 +214,10 @@ MeshAsset::MeshAsset() :
 
 MeshAsset::~MeshAsset()
 {
-   for ( S32 m = 0; m < mMeshList.size(); ++m )
-   {
-      if ( mMeshList[m].mVertexBuffer.idx != bgfx::invalidHandle )
-         bgfx::destroyVertexBuffer(mMeshList[m].mVertexBuffer);
-
-      if ( mMeshList[m].mIndexBuffer.idx != bgfx::invalidHandle )
-         bgfx::destroyIndexBuffer(mMeshList[m].mIndexBuffer);
-   }
+   // Wait out a load that's still in flight.
+   MeshLoader::cancel(this);
+   SAFE_DELETE(mStaging);
+   _clearMeshList();
 }
 
 //------------------------------------------------------------------------------
@@ -190,10 +283,24 @@ void MeshAsset::initializeAsset( void )
 
    mMeshFile = expandAssetFilePath( mMeshFile );
 
-   //Con::printf("MESH IMPORT THREAD CREATED!");
-   //mImportThread = new MeshImportThread(this);
-   //mImportThread->start();
-   loadMesh();
+   // Without a loader (no canvas, tools) the mesh is loaded in place.
+   if ( !MeshLoader::isRunning() )
+   {
+      loadMesh();
+      return;
+   }
+
+   // A loaded mesh is still being drawn, so a refresh reads into a staging
+   // copy that uploadMesh() swaps in. A refresh that's already pending is
+   // dropped and started over with the new file.
+   if ( mIsLoaded )
+   {
+      MeshLoader::cancel(this);
+      SAFE_DELETE(mStaging);
+      mStaging = new MeshAsset();
+      mStaging->mMeshFile = mMeshFile;
+   }
+   MeshLoader::queue(this);
 }
 
 bool MeshAsset::isAssetValid() const
@@ -222,14 +329,41 @@ void MeshAsset::setMeshFile( const char* pMeshFile )
 
 void MeshAsset::loadMesh()
 {
+   readMesh();
+   uploadMesh();
+}
+
+// Everything up to the GPU buffers: the binary cache or a fresh import, then
+// the animation data. Doesn't touch the renderer or, on a refresh, the live
+// mesh data, so it can run on a loader thread.
+void MeshAsset::readMesh()
+{
+   if ( mStaging != NULL )
+   {
+      // The skeleton is compiled once the data is swapped in.
+      if ( !mStaging->loadBin() )
+      {
+         mStaging->importMesh();
+         mStaging->saveBin();
+      }
+      return;
+   }
+
    if ( !loadBin() )
    {
       importMesh();
-      processMesh();
       saveBin();
-   } else {
-      processMesh();
    }
+   _compileAnimation();
+}
+
+// Main thread only.
+void MeshAsset::uploadMesh()
+{
+   if ( mStaging != NULL )
+      _adoptStaging();
+
+   processMesh();
    mIsLoaded = true;
 }
 
@@ -239,18 +373,20 @@ void MeshAsset::importMesh()
    //U64 startTime = bx::getHPCounter();
    Con::printf("Importing mesh..");
 
-   // Use Assimp To Load Mesh
-   mScene = mAssimpImporter.ReadFile(mMeshFile, aiProcessPreset_TargetRealtime_MaxQuality | aiProcess_FlipWindingOrder | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
-   if ( !mScene ) return;
+   // Use Assimp To Load Mesh. The importer and its scene only live for the
+   // duration of the import, everything needed afterwards is copied out.
+   Assimp::Importer importer;
+   const aiScene* scene = importer.ReadFile(mMeshFile, aiProcessPreset_TargetRealtime_MaxQuality | aiProcess_FlipWindingOrder | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+   if ( !scene ) return;
 
    //U64 endTime = bx::getHPCounter();
    //Con::printf("ASSIMP IMPORT TOOK: %d microseconds. (1 microsecond = 0.001 milliseconds)", (U32)((endTime - startTime) / hpFreq));
 
-   mIsAnimated = mScene->HasAnimations();
+   mIsAnimated = scene->HasAnimations();
 
-   for( U32 m = 0; m < mScene->mNumMeshes; ++m )
+   for( U32 m = 0; m < scene->mNumMeshes; ++m )
    {
-      aiMesh* mMeshData = mScene->mMeshes[m];
+      aiMesh* mMeshData = scene->mMeshes[m];
       SubMesh newSubMesh;
       mMeshList.push_back(newSubMesh);
       SubMesh* subMeshData = &mMeshList[mMeshList.size()-1];
@@ -261,13 +397,14 @@ void MeshAsset::importMesh()
       subMeshData->mVertexBuffer.idx = bgfx::invalidHandle;
       subMeshData->mIndexBuffer.idx = bgfx::invalidHandle;
       subMeshData->mMaterialIndex = mMeshData->mMaterialIndex;
+      subMeshData->mIsCluster = false;
 
       // Transformation
-      aiNode* root = mScene->mRootNode;
+      aiNode* root = scene->mRootNode;
       aiMatrix4x4 transform = root->mTransformation;
-      for (U32 i = 0; i < mScene->mRootNode->mNumChildren; ++i)
+      for (U32 i = 0; i < scene->mRootNode->mNumChildren; ++i)
       {
-         aiNode* node = mScene->mRootNode->mChildren[i];
+         aiNode* node = scene->mRootNode->mChildren[i];
          if (node->mNumMeshes > 0 && node->mMeshes[0] == m)
          {
             transform = node->mTransformation;
@@ -371,7 +508,7 @@ void MeshAsset::importMesh()
          if ( mBoneMap.find(boneData->mName.C_Str()) == mBoneMap.end() )
          {
             boneIndex = mBoneOffsets.size();
-            mBoneMap.insert(boneData->mName.C_Str(), boneIndex);
+            mBoneMap.insert(StringTable->insert(boneData->mName.C_Str(), true), boneIndex);
             mBoneOffsets.push_back(boneData->mOffsetMatrix);
          } else {
             boneIndex = mBoneMap[boneData->mName.C_Str()];
@@ -405,21 +542,17 @@ void MeshAsset::importMesh()
          }
       }
          
-      // Faces
+      // Faces. The index lists are built from these once the mesh is 
+      // optimized, lines can't be drawn from a triangle list so they're 
+      // dropped.
       for ( U32 n = 0; n < mMeshData->mNumFaces; ++n)
       {
          const struct aiFace* face = &mMeshData->mFaces[n];
          if ( face->mNumIndices == 2 )
-         {
-            subMeshData->mRawIndices.push_back(face->mIndices[0]);
-            subMeshData->mRawIndices.push_back(face->mIndices[1]);
-         }
-         else if ( face->mNumIndices == 3 )
-         {
-            subMeshData->mRawIndices.push_back(face->mIndices[0]);
-            subMeshData->mRawIndices.push_back(face->mIndices[1]);
-            subMeshData->mRawIndices.push_back(face->mIndices[2]);
+            continue;
 
+         if ( face->mNumIndices == 3 )
+         {
             MeshFace meshFace;
             meshFace.verts[0] = face->mIndices[0];
             meshFace.verts[1] = face->mIndices[1];
@@ -430,347 +563,1603 @@ void MeshAsset::importMesh()
          }
       }
    }
+
+   _splitClusters();
+   _bindRawData();
+   _optimizeMeshes();
+   _generateLODs();
+
+   // Animation
+   mNodes.clear();
+   mAnimations.clear();
+   if ( mIsAnimated )
+   {
+      _importNodes(scene->mRootNode, -1);
+      _importAnimations(scene);
+      mGlobalInverseTransform = inverseTransform(mNodes[0].mTransformation);
+   }
 }
 
-bool MeshAsset::loadBin()
+void MeshAsset::_importNodes(const aiNode* pNode, S32 parentIndex)
 {
-   //U64 hpFreq = bx::getHPFrequency() / 1000000.0; // micro-seconds.
-   //U64 startTime = bx::getHPCounter();
+   MeshNode node;
+   node.mName = StringTable->insert(pNode->mName.C_Str(), true);
+   node.mParentIndex = parentIndex;
+   node.mBoneIndex = -1;
+   node.mTransformation = MatrixF(pNode->mTransformation);
 
-   char cachedFilename[256];
-   dSprintf(cachedFilename, 256, "%s.bin", mMeshFile);
-   StringTableEntry cachedPath = Platform::getCachedFilePath(cachedFilename);
+   if ( mBoneMap.find(node.mName) != mBoneMap.end() )
+      node.mBoneIndex = mBoneMap[node.mName];
 
-   FileStream stream;
-   if ( stream.open(cachedPath, FileStream::ReadWrite) )
+   mNodes.push_back(node);
+
+   S32 nodeIndex = mNodes.size() - 1;
+   for ( U32 i = 0; i < pNode->mNumChildren; ++i )
+      _importNodes(pNode->mChildren[i], nodeIndex);
+}
+
+void MeshAsset::_importAnimations(const aiScene* scene)
+{
+   for ( U32 a = 0; a < scene->mNumAnimations; ++a )
    {
-      // Check Version Number
-      U8 binVersionNumber;
-      stream.read(&binVersionNumber);
-      
-      if ( binVersionNumber != MeshAsset::BinVersion )
-         return false;
+      const aiAnimation* pAnimation = scene->mAnimations[a];
 
-      mMeshList.clear();
-      U32 meshCount = 0;
-      stream.read(&meshCount);
+      mAnimations.increment();
+      MeshAnimation* anim = &mAnimations.last();
+      anim->mName             = StringTable->insert(pAnimation->mName.C_Str(), true);
+      anim->mDuration         = pAnimation->mDuration;
+      anim->mTicksPerSecond   = pAnimation->mTicksPerSecond;
+      anim->mNodeChannels.setSize(mNodes.size());
+      anim->mNodeChannels.fill(-1);
 
-      for ( U32 n = 0; n < meshCount; ++n)
+      for ( U32 c = 0; c < pAnimation->mNumChannels; ++c )
       {
-         SubMesh newSubMesh;
-         mMeshList.push_back(newSubMesh);
-         SubMesh* subMeshData = &mMeshList[mMeshList.size()-1];
+         const aiNodeAnim* pNodeAnim = pAnimation->mChannels[c];
 
-         // Bounding Box
-         stream.read(&subMeshData->mBoundingBox.minExtents.x);
-         stream.read(&subMeshData->mBoundingBox.minExtents.y);
-         stream.read(&subMeshData->mBoundingBox.minExtents.z);
-         stream.read(&subMeshData->mBoundingBox.maxExtents.x); 
-         stream.read(&subMeshData->mBoundingBox.maxExtents.y); 
-         stream.read(&subMeshData->mBoundingBox.maxExtents.z); 
-
-         // Material
-         stream.read(&subMeshData->mMaterialIndex);
-
-         // Faces
-         U32 faceCount = 0;
-         stream.read(&faceCount);
-         for (U32 i = 0; i < faceCount; ++i)
+         // Channels are matched to nodes by name, first match wins.
+         S32 nodeIndex = -1;
+         for ( S32 n = 0; n < mNodes.size(); ++n )
          {
-            MeshFace face;
-            stream.read(&face.verts[0]);
-            stream.read(&face.verts[1]);
-            stream.read(&face.verts[2]);
-            subMeshData->mRawFaces.push_back(face);
+            if ( dStrcmp(mNodes[n].mName, pNodeAnim->mNodeName.C_Str()) == 0 )
+            {
+               nodeIndex = n;
+               break;
+            }
          }
+         if ( nodeIndex < 0 || anim->mNodeChannels[nodeIndex] >= 0 )
+            continue;
+
+         anim->mNodeChannels[nodeIndex] = anim->mChannels.size();
+         anim->mChannels.increment();
+         MeshNodeAnim* channel = &anim->mChannels.last();
+         channel->mNodeIndex = nodeIndex;
+
+         channel->mPositionKeys.setSize(pNodeAnim->mNumPositionKeys);
+         dMemcpy(channel->mPositionKeys.address(), pNodeAnim->mPositionKeys, pNodeAnim->mNumPositionKeys * sizeof(aiVectorKey));
+         channel->mRotationKeys.setSize(pNodeAnim->mNumRotationKeys);
+         dMemcpy(channel->mRotationKeys.address(), pNodeAnim->mRotationKeys, pNodeAnim->mNumRotationKeys * sizeof(aiQuatKey));
+         channel->mScalingKeys.setSize(pNodeAnim->mNumScalingKeys);
+         dMemcpy(channel->mScalingKeys.address(), pNodeAnim->mScalingKeys, pNodeAnim->mNumScalingKeys * sizeof(aiVectorKey));
+      }
+   }
+}
 
-         // Indices
-         U32 indexCount = 0;
-         stream.read(&indexCount);
-         for ( U32 i = 0; i < indexCount; ++i )
+//------------------------------------------------------------------------------
+// Import Optimization
+//------------------------------------------------------------------------------
+
+// Partially sorts a list of triangles by one coordinate of their centroids
+// so the triangle at nth is in place, with nothing before it further along
+// the axis and nothing after it closer (quickselect).
+static void selectTriangles(U32* tris, U32 count, U32 nth, const F32* centroids, U32 axis)
+{
+   S32 left = 0;
+   S32 right = count - 1;
+   while ( left < right )
+   {
+      F32 pivot = centroids[tris[(left + right) / 2] * 3 + axis];
+      S32 i = left;
+      S32 j = right;
+      while ( i <= j )
+      {
+         while ( centroids[tris[i] * 3 + axis] < pivot ) i++;
+         while ( centroids[tris[j] * 3 + axis] > pivot ) j--;
+         if ( i <= j )
          {
-            U16 index = 0;
-            stream.read(&index);
-            subMeshData->mRawIndices.push_back(index);
+            U32 tri = tris[i];
+            tris[i] = tris[j];
+            tris[j] = tri;
+            i++;
+            j--;
          }
-      
-         // Vertices
-         U32 vertexCount = 0;
-         stream.read(&vertexCount);
-         for ( U32 i = 0; i < vertexCount; ++i )
+      }
+
+      if ( (S32)nth <= j )
+         right = j;
+      else if ( (S32)nth >= i )
+         left = i;
+      else
+         break;
+   }
+}
+
+// Very large submeshes (scans, sculpts) are cut into spatially coherent 
+// clusters by median splits along the longest axis. Every cluster becomes a
+// submesh of its own with its own bounds, so it is culled and picks its LOD
+// on its own, and most clusters fit 16 bit indices again. Vertices on a cut
+// are copied into both clusters. Expects the full layout in mRawVerts.
+void MeshAsset::_splitClusters()
+{
+   S32 meshCount = mMeshList.size();
+   for ( S32 n = 0; n < meshCount; ++n )
+   {
+      if ( (U32)mMeshList[n].mRawFaces.size() <= ClusterSplitTriangles )
+         continue;
+
+      const SubMesh& source = mMeshList[n];
+      U32 vertexCount = source.mRawVerts.size();
+
+      Vector<U32> tris;
+      Vector<F32> centroids;
+      tris.reserve(source.mRawFaces.size());
+      centroids.setSize(source.mRawFaces.size() * 3);
+      for ( S32 f = 0; f < source.mRawFaces.size(); ++f )
+      {
+         const U32* face = source.mRawFaces[f].verts;
+         if ( face[0] >= vertexCount || face[1] >= vertexCount || face[2] >= vertexCount )
+            continue;
+
+         const Graphics::PosUVTBNBonesVertex* v0 = &source.mRawVerts[face[0]];
+         const Graphics::PosUVTBNBonesVertex* v1 = &source.mRawVerts[face[1]];
+         const Graphics::PosUVTBNBonesVertex* v2 = &source.mRawVerts[face[2]];
+         centroids[f * 3 + 0] = (v0->m_x + v1->m_x + v2->m_x) / 3.0f;
+         centroids[f * 3 + 1] = (v0->m_y + v1->m_y + v2->m_y) / 3.0f;
+         centroids[f * 3 + 2] = (v0->m_z + v1->m_z + v2->m_z) / 3.0f;
+         tris.push_back(f);
+      }
+
+      // Ranges of tris as start, count pairs.
+      Vector<U32> ranges;
+      Vector<U32> leaves;
+      ranges.push_back(0);
+      ranges.push_back(tris.size());
+      while ( ranges.size() > 0 )
+      {
+         U32 count = ranges.last(); ranges.pop_back();
+         U32 start = ranges.last(); ranges.pop_back();
+         if ( count <= ClusterTriangles )
          {
-            Graphics::PosUVTBNBonesVertex vert;
-         
-            // Position
-            stream.read(&vert.m_x);
-            stream.read(&vert.m_y);
-            stream.read(&vert.m_z);
-
-            // UV
-            stream.read(&vert.m_u);
-            stream.read(&vert.m_v);
-
-            // Tangent & Bitangent
-            stream.read(&vert.m_tangent_x);
-            stream.read(&vert.m_tangent_y);
-            stream.read(&vert.m_tangent_z);
-            stream.read(&vert.m_bitangent_x);
-            stream.read(&vert.m_bitangent_y);
-            stream.read(&vert.m_bitangent_z);
-
-            // Normals
-            stream.read(&vert.m_normal_x);
-            stream.read(&vert.m_normal_y);
-            stream.read(&vert.m_normal_z);
-
-            // Bone Information
-            stream.read(&vert.m_boneindex[0]);
-            stream.read(&vert.m_boneindex[1]);
-            stream.read(&vert.m_boneindex[2]);
-            stream.read(&vert.m_boneindex[3]);
-            stream.read(&vert.m_boneweight[0]);
-            stream.read(&vert.m_boneweight[1]);
-            stream.read(&vert.m_boneweight[2]);
-            stream.read(&vert.m_boneweight[3]);
-
-            subMeshData->mRawVerts.push_back(vert);
+            leaves.push_back(start);
+            leaves.push_back(count);
+            continue;
+         }
+
+         Point3F minExtents(F32_MAX, F32_MAX, F32_MAX);
+         Point3F maxExtents(-F32_MAX, -F32_MAX, -F32_MAX);
+         for ( U32 t = start; t < start + count; ++t )
+         {
+            const F32* c = &centroids[tris[t] * 3];
+            Point3F centroid(c[0], c[1], c[2]);
+            minExtents.setMin(centroid);
+            maxExtents.setMax(centroid);
          }
+
+         Point3F extents = maxExtents - minExtents;
+         U32 axis = 0;
+         if ( extents.y > extents[axis] ) axis = 1;
+         if ( extents.z > extents[axis] ) axis = 2;
+
+         U32 half = count / 2;
+         selectTriangles(&tris[start], count, half, centroids.address(), axis);
+         ranges.push_back(start);
+         ranges.push_back(half);
+         ranges.push_back(start + half);
+         ranges.push_back(count - half);
       }
 
-      stream.close();
+      U32 clusterCount = leaves.size() / 2;
+      Vector<SubMesh> clusters;
+      clusters.increment(clusterCount);
 
-      //U64 endTime = bx::getHPCounter();
-      //Con::printf("BINARY IMPORT TOOK: %d microseconds. (1 microsecond = 0.001 milliseconds)", (U32)((endTime - startTime) / hpFreq));
-      return true;
-   } 
+      Vector<U32> remap;
+      remap.setSize(vertexCount);
+      dMemset(remap.address(), 0xff, vertexCount * sizeof(U32));
 
-   return false;
-}
+      for ( U32 c = 0; c < clusterCount; ++c )
+      {
+         SubMesh* cluster = &clusters[c];
+         cluster->mVertexBuffer.idx = bgfx::invalidHandle;
+         cluster->mIndexBuffer.idx = bgfx::invalidHandle;
+         cluster->mMaterialIndex = source.mMaterialIndex;
+         cluster->mIsCluster = true;
+
+         U32 start = leaves[c * 2];
+         U32 count = leaves[c * 2 + 1];
+         cluster->mRawFaces.setSize(count);
+         for ( U32 t = 0; t < count; ++t )
+         {
+            const U32* face = source.mRawFaces[tris[start + t]].verts;
+            for ( U32 k = 0; k < 3; ++k )
+            {
+               U32 v = face[k];
+               if ( remap[v] == 0xffffffff )
+               {
+                  remap[v] = cluster->mRawVerts.size();
+                  cluster->mRawVerts.push_back(source.mRawVerts[v]);
+               }
+               cluster->mRawFaces[t].verts[k] = remap[v];
+            }
+         }
 
-void MeshAsset::saveBin()
-{
-   // For now we can't save animations.
-   if ( mIsAnimated )
-      return;
+         // Only the vertices this cluster touched need resetting.
+         for ( U32 t = 0; t < count; ++t )
+         {
+            const U32* face = source.mRawFaces[tris[start + t]].verts;
+            remap[face[0]] = remap[face[1]] = remap[face[2]] = 0xffffffff;
+         }
 
-   char cachedFilename[256];
-   dSprintf(cachedFilename, 256, "%s.bin", mMeshFile);
-   StringTableEntry cachedPath = Platform::getCachedFilePath(cachedFilename);
+         const Graphics::PosUVTBNBonesVertex* verts = cluster->mRawVerts.address();
+         cluster->mBoundingBox.minExtents.set(verts[0].m_x, verts[0].m_y, verts[0].m_z);
+         cluster->mBoundingBox.maxExtents = cluster->mBoundingBox.minExtents;
+         for ( S32 v = 1; v < cluster->mRawVerts.size(); ++v )
+            cluster->mBoundingBox.extend(Point3F(verts[v].m_x, verts[v].m_y, verts[v].m_z));
+      }
 
-   Platform::createPath(cachedPath);
-   FileStream stream;
-   if ( !stream.open(cachedPath, FileStream::Write) )
-   {
-      Con::errorf("[MeshAsset] Could save binary file: %s", cachedPath);
-      return;
+      if ( clusterCount == 0 )
+         continue;
+
+      Con::printf("Split a submesh of %d triangles into %d clusters.", tris.size(), clusterCount);
+
+      // The source is replaced by its first cluster, the rest go on the end.
+      mMeshList[n] = clusters[0];
+      for ( U32 c = 1; c < clusterCount; ++c )
+         mMeshList.push_back(clusters[c]);
    }
+}
 
-   // Bin Version
-   stream.write(MeshAsset::BinVersion);
+// Reorders freshly imported submeshes for the GPU: triangles for the post 
+// transform cache and then for overdraw, vertices in the order the 
+// triangles first use them. Static meshes are then packed into the compact
+// vertex layout. Expects the full layout in mRawVerts.
+void MeshAsset::_optimizeMeshes()
+{
+   mCompactVertices = !mIsAnimated;
 
-   U32 meshCount = mMeshList.size();
-   stream.write(meshCount);
+   U32 triangleCount = 0;
+   F32 missesBefore = 0.0f;
+   F32 missesAfter = 0.0f;
 
-   for ( U32 n = 0; n < meshCount; ++n)
+   for ( S32 n = 0; n < mMeshList.size(); ++n )
    {
       SubMesh* subMeshData = &mMeshList[n];
+      U32 vertexCount = subMeshData->mRawVerts.size();
 
-      // Bounding Box
-      stream.write(subMeshData->mBoundingBox.minExtents.x);
-      stream.write(subMeshData->mBoundingBox.minExtents.y);
-      stream.write(subMeshData->mBoundingBox.minExtents.z);
-      stream.write(subMeshData->mBoundingBox.maxExtents.x); 
-      stream.write(subMeshData->mBoundingBox.maxExtents.y); 
-      stream.write(subMeshData->mBoundingBox.maxExtents.z); 
-
-      // Material
-      stream.write(subMeshData->mMaterialIndex);
-
-      // Faces
-      U32 faceCount = subMeshData->mRawFaces.size();
-      stream.write(faceCount);
-      for (U32 i = 0; i < faceCount; ++i)
+      // Only triangles make it through. Lines and degenerate faces can't be
+      // drawn from a triangle list anyway.
+      Vector<U32> source;
+      source.reserve(subMeshData->mRawFaces.size() * 3);
+      for ( S32 f = 0; f < subMeshData->mRawFaces.size(); ++f )
       {
-         MeshFace* face = &subMeshData->mRawFaces[i];
-         stream.write(face->verts[0]);
-         stream.write(face->verts[1]);
-         stream.write(face->verts[2]);
+         const U32* face = subMeshData->mRawFaces[f].verts;
+         if ( face[0] == face[1] || face[1] == face[2] || face[0] == face[2] 
+            || face[0] >= vertexCount || face[1] >= vertexCount || face[2] >= vertexCount )
+            continue;
+
+         source.push_back(face[0]);
+         source.push_back(face[1]);
+         source.push_back(face[2]);
       }
 
-      // Indices
-      U32 indexCount = subMeshData->mRawIndices.size();
-      stream.write(indexCount);
-      for ( U32 i = 0; i < indexCount; ++i )
-         stream.write(subMeshData->mRawIndices[i]);
-      
-      // Vertices
-      U32 vertexCount = subMeshData->mRawVerts.size();
-      stream.write(vertexCount);
-      for ( U32 i = 0; i < vertexCount; ++i )
+      Vector<U32> indices;
+      indices.setSize(source.size());
+      if ( source.size() > 0 )
       {
-         Graphics::PosUVTBNBonesVertex* vert = &subMeshData->mRawVerts[i];
-         
-         // Position
-         stream.write(vert->m_x);
-         stream.write(vert->m_y);
-         stream.write(vert->m_z);
+         optimizeVertexCache(indices.address(), source.address(), source.size(), vertexCount);
+         optimizeOverdraw(indices.address(), indices.size(), &subMeshData->mRawVerts[0].m_x, vertexCount, sizeof(Graphics::PosUVTBNBonesVertex), OverdrawThreshold);
 
-         // UV
-         stream.write(vert->m_u);
-         stream.write(vert->m_v);
+         triangleCount  += source.size() / 3;
+         missesBefore   += getCacheMissRatio(source.address(), source.size(), vertexCount, MeshVertexCacheSize) * (source.size() / 3);
+         missesAfter    += getCacheMissRatio(indices.address(), indices.size(), vertexCount, MeshVertexCacheSize) * (indices.size() / 3);
+      }
 
-         // Tangent & Bitangent
-         stream.write(vert->m_tangent_x);
-         stream.write(vert->m_tangent_y);
-         stream.write(vert->m_tangent_z);
-         stream.write(vert->m_bitangent_x);
-         stream.write(vert->m_bitangent_y);
-         stream.write(vert->m_bitangent_z);
+      // Renumber the vertices in fetch order, dropping any that are unused.
+      Vector<U32> remap;
+      remap.setSize(vertexCount);
+      U32 usedCount = optimizeVertexFetchRemap(remap.address(), indices.address(), indices.size(), vertexCount);
 
-         // Normals
-         stream.write(vert->m_normal_x);
-         stream.write(vert->m_normal_y);
-         stream.write(vert->m_normal_z);
+      Vector<Graphics::PosUVTBNBonesVertex> verts;
+      verts.setSize(usedCount);
+      for ( U32 v = 0; v < vertexCount; ++v )
+      {
+         if ( remap[v] != 0xffffffff )
+            verts[remap[v]] = subMeshData->mRawVerts[v];
+      }
 
-         // Bone Information
-         stream.write(vert->m_boneindex[0]);
-         stream.write(vert->m_boneindex[1]);
-         stream.write(vert->m_boneindex[2]);
-         stream.write(vert->m_boneindex[3]);
-         stream.write(vert->m_boneweight[0]);
-         stream.write(vert->m_boneweight[1]);
-         stream.write(vert->m_boneweight[2]);
-         stream.write(vert->m_boneweight[3]);
+      subMeshData->mRawFaces.setSize(indices.size() / 3);
+      for ( S32 i = 0; i < indices.size(); ++i )
+      {
+         indices[i] = remap[indices[i]];
+         subMeshData->mRawFaces[i / 3].verts[i % 3] = indices[i];
+      }
+
+      subMeshData->mRawIndices.clear();
+      appendIndices(subMeshData->mRawIndices, indices.address(), indices.size(), usedCount);
+
+      if ( mCompactVertices )
+      {
+         subMeshData->mRawCompactVerts.setSize(usedCount);
+         for ( U32 v = 0; v < usedCount; ++v )
+            packCompactVertex(&subMeshData->mRawCompactVerts[v], verts[v]);
+         subMeshData->mRawVerts.clear();
+         subMeshData->mRawVerts.compact();
+      } else {
+         subMeshData->mRawVerts = verts;
       }
    }
 
-   stream.close();
+   _bindRawData();
+
+   if ( triangleCount > 0 )
+      Con::printf("Optimized %d triangles, vertex cache misses per triangle %.2f -> %.2f.", triangleCount, missesBefore / triangleCount, missesAfter / triangleCount);
 }
 
-void MeshAsset::processMesh()
-{
-   //U64 hpFreq = bx::getHPFrequency() / 1000000.0; // micro-seconds.
-   //U64 startTime = bx::getHPCounter();
+//------------------------------------------------------------------------------
+// LOD Generation
+//------------------------------------------------------------------------------
 
-   for ( S32 n = 0; n < mMeshList.size(); ++n)
+// Levels are simplified from the full mesh rather than from each other so
+// errors don't compound. The chain ends once a level stops paying for itself
+// or gets down to a handful of triangles.
+void MeshAsset::_generateLODs()
+{
+   for ( S32 n = 0; n < mMeshList.size(); ++n )
    {
       SubMesh* subMeshData = &mMeshList[n];
+      subMeshData->mLODs.clear();
+      subMeshData->mRawLODIndices.clear();
 
-      // Load the verts and indices into bgfx buffers
-	   subMeshData->mVertexBuffer = bgfx::createVertexBuffer(
-		      bgfx::makeRef(&subMeshData->mRawVerts[0], subMeshData->mRawVerts.size() * sizeof(Graphics::PosUVTBNBonesVertex) ), 
-            Graphics::PosUVTBNBonesVertex::ms_decl
-		   );
+      if ( subMeshData->mFaceCount < MinLODTriangles || subMeshData->mVertexData == NULL )
+         continue;
 
-	   subMeshData->mIndexBuffer = bgfx::createIndexBuffer(
-            bgfx::makeRef(&subMeshData->mRawIndices[0], subMeshData->mRawIndices.size() * sizeof(U16) )
-		   );
+      const U32* source = subMeshData->mFaces[0].verts;
+      U32 sourceCount = subMeshData->mFaceCount * 3;
+      U32 previousCount = sourceCount;
 
-      // Bounding Box
-      mBoundingBox.intersect(subMeshData->mBoundingBox);
-   }
+      Vector<U32> indices;
+      Vector<U32> ordered;
+      indices.setSize(sourceCount);
+      ordered.setSize(sourceCount);
+      Vector<U32> starts;
 
-   //U64 endTime = bx::getHPCounter();
-   //Con::printf("PROCESS MESH TOOK: %d microseconds. (1 microsecond = 0.001 milliseconds)", (U32)((endTime - startTime) / hpFreq));
+      for ( U32 level = 1; level <= MaxLODs; ++level )
+      {
+         U32 target = (sourceCount >> level) / 3 * 3;
+         F32 error = 0.0f;
+         U32 count = simplifyMesh(indices.address(), source, sourceCount, 
+            (const F32*)subMeshData->mVertexData, subMeshData->mVertexCount, getVertexStride(), 
+            target, MaxLODError, &error, subMeshData->mIsCluster);
+
+         // Seams and borders can stop a mesh from simplifying much further.
+         if ( count == 0 || count > previousCount * 4 / 5 )
+            break;
+
+         // Collapses leave the triangles in source order, so each level 
+         // gets its own cache ordering.
+         starts.push_back(subMeshData->mRawLODIndices.size());
+         optimizeVertexCache(ordered.address(), indices.address(), count, subMeshData->mVertexCount);
+         appendIndices(subMeshData->mRawLODIndices, ordered.address(), count, subMeshData->mVertexCount);
+
+         subMeshData->mLODs.increment();
+         MeshLOD* lod = &subMeshData->mLODs.last();
+         lod->mIndexCount        = count;
+         lod->mError             = error;
+         lod->mIndexBuffer.idx   = bgfx::invalidHandle;
+
+         previousCount = count;
+         if ( count / 3 < MinLODTriangles )
+            break;
+      }
+
+      for ( S32 l = 0; l < subMeshData->mLODs.size(); ++l )
+         subMeshData->mLODs[l].mIndices = subMeshData->mRawLODIndices.address() + starts[l];
+   }
 }
 
-// Returns the number of transformations loaded into transformsOut.
-U32 MeshAsset::getAnimatedTransforms(F64 TimeInSeconds, F32* transformsOut)
-{
-   if ( !mScene ) return 0;
+//------------------------------------------------------------------------------
+// Binary Cache
+//------------------------------------------------------------------------------
 
-   MatrixF Identity;
-   Identity.identity();
+static U32 alignBinOffset(U32 offset)
+{
+   return (offset + MeshAsset::BinAlignment - 1) & ~(MeshAsset::BinAlignment - 1);
+}
 
-   aiMatrix4x4t<F32> rootTransform = mScene->mRootNode->mTransformation;
-   rootTransform.Inverse();
-   MatrixF GlobalInverseTransform = rootTransform;
+static bool isBinRangeValid(U32 offset, U32 count, U32 elementSize, U32 fileSize)
+{
+   if ( count == 0 )
+      return true;
 
-   F64 TicksPerSecond = mScene->mAnimations[0]->mTicksPerSecond != 0 ? 
-                           mScene->mAnimations[0]->mTicksPerSecond : 25.0f;
-   F64 TimeInTicks = TimeInSeconds * TicksPerSecond;
-   F64 AnimationTime = fmod(TimeInTicks, mScene->mAnimations[0]->mDuration);
+   if ( (offset & (MeshAsset::BinAlignment - 1)) != 0 )
+      return false;
 
-   return _readNodeHeirarchy(AnimationTime, mScene->mRootNode, Identity, GlobalInverseTransform, transformsOut);
+   return ((U64)offset + (U64)count * elementSize) <= fileSize;
 }
 
-U32 MeshAsset::_readNodeHeirarchy(F64 AnimationTime, const aiNode* pNode, 
-                                  MatrixF ParentTransform, MatrixF GlobalInverseTransform, F32* transformsOut)
-{ 
-   U32 xfrmCount = 0;
-   const char* nodeName = pNode->mName.data;
-   const aiAnimation* pAnimation = mScene->mAnimations[0];
-   const aiNodeAnim* pNodeAnim = _findNodeAnim(pAnimation, nodeName);
-   MatrixF NodeTransformation(pNode->mTransformation);
+// Appends a blob on the next aligned offset, zero padding the gap, and
+// returns that offset. A NULL data pointer reserves zeroed space.
+static U32 appendBinBlob(Vector<U8>& file, const void* data, U32 size)
+{
+   U32 start = file.size();
+   U32 offset = alignBinOffset(start);
+   file.setSize(offset + size);
 
-   if ( pNodeAnim ) 
+   dMemset(file.address() + start, 0, offset - start);
+   if ( size > 0 )
    {
-      // Interpolate scaling and generate scaling transformation matrix
-      aiVector3D Scaling;
-      _calcInterpolatedScaling(Scaling, AnimationTime, pNodeAnim);
-      MatrixF ScalingM;
-      ScalingM.InitScaleTransform(Scaling.x, Scaling.y, Scaling.z);
-
-      // Interpolate rotation and generate rotation transformation matrix
-      aiQuaternion RotationQ;
-      _calcInterpolatedRotation(RotationQ, AnimationTime, pNodeAnim); 
-      MatrixF RotationM = MatrixF(RotationQ.GetMatrix());
-
-      // Interpolate translation and generate translation transformation matrix
-      aiVector3D Translation;
-      _calcInterpolatedPosition(Translation, AnimationTime, pNodeAnim);
-      MatrixF TranslationM;
-      TranslationM.InitTranslationTransform(Translation.x, Translation.y, Translation.z);
-
-      NodeTransformation = TranslationM * RotationM * ScalingM;
+      if ( data != NULL )
+         dMemcpy(file.address() + offset, data, size);
+      else
+         dMemset(file.address() + offset, 0, size);
    }
 
-   MatrixF GlobalTransformation = ParentTransform * NodeTransformation;
+   return offset;
+}
+
+static U32 appendBinString(Vector<char>& strings, const char* str)
+{
+   U32 offset = strings.size();
+   U32 length = dStrlen(str) + 1;
+   strings.setSize(offset + length);
+   dMemcpy(strings.address() + offset, str, length);
+   return offset;
+}
 
-   if ( mBoneMap.find(nodeName) != mBoneMap.end() ) 
+void MeshAsset::_clearMeshList()
+{
+   for ( S32 m = 0; m < mMeshList.size(); ++m )
    {
-      U32 BoneIndex = mBoneMap[nodeName];
-      xfrmCount = BoneIndex + 1;
+      if ( mMeshList[m].mVertexBuffer.idx != bgfx::invalidHandle )
+         bgfx::destroyVertexBuffer(mMeshList[m].mVertexBuffer);
+
+      if ( mMeshList[m].mIndexBuffer.idx != bgfx::invalidHandle )
+         bgfx::destroyIndexBuffer(mMeshList[m].mIndexBuffer);
 
-      MatrixF boneTransform = GlobalInverseTransform * GlobalTransformation * mBoneOffsets[BoneIndex];
-      // Assimp matricies are row-major, we need to transpose to column-major.
-      boneTransform.transpose();
-      dMemcpy(&transformsOut[BoneIndex * 16], boneTransform, sizeof(F32) * 16); 
+      for ( S32 n = 0; n < mMeshList[m].mLODs.size(); ++n )
+      {
+         if ( mMeshList[m].mLODs[n].mIndexBuffer.idx != bgfx::invalidHandle )
+            bgfx::destroyIndexBuffer(mMeshList[m].mLODs[n].mIndexBuffer);
+      }
    }
+   mMeshList.clear();
 
-   for ( U32 i = 0 ; i < pNode->mNumChildren ; i++ ) 
+   if ( mBinBuffer != NULL )
    {
-      U32 childXfrmCount = _readNodeHeirarchy(AnimationTime, pNode->mChildren[i], GlobalTransformation, GlobalInverseTransform, transformsOut);
-      if ( childXfrmCount > xfrmCount )
-         xfrmCount = childXfrmCount;
+      dFree(mBinBuffer);
+      mBinBuffer = NULL;
    }
-
-   return xfrmCount;
 }
 
-aiNodeAnim* MeshAsset::_findNodeAnim(const aiAnimation* pAnimation, const char* nodeName)
+// Main thread only. Releases the old buffers and takes over the data a
+// refresh read into mStaging. A cached mesh hands over its blob, a fresh
+// import is copied since Vector can't give up its storage.
+void MeshAsset::_adoptStaging()
 {
-   for ( U32 n = 0; n < pAnimation->mNumChannels; ++n )
+   _clearMeshList();
+
+   mMeshList               = mStaging->mMeshList;
+   mBinBuffer              = mStaging->mBinBuffer;
+   mCompactVertices        = mStaging->mCompactVertices;
+   mIsAnimated             = mStaging->mIsAnimated;
+   mBoundingBox            = mStaging->mBoundingBox;
+   mNodes                  = mStaging->mNodes;
+   mAnimations             = mStaging->mAnimations;
+   mBoneOffsets            = mStaging->mBoneOffsets;
+   mGlobalInverseTransform = mStaging->mGlobalInverseTransform;
+
+   mBoneMap.clear();
+   for ( HashMap<const char*, U32>::iterator itr = mStaging->mBoneMap.begin(); itr != mStaging->mBoneMap.end(); ++itr )
+      mBoneMap.insert(itr->key, itr->value);
+
+   // Blob backed submeshes still point into the blob. Copied ones have to be
+   // pointed at their own vectors, LODs at the same offset as before.
+   if ( mBinBuffer == NULL )
    {
-      aiNodeAnim* node = pAnimation->mChannels[n];
-      if ( dStrcmp(node->mNodeName.C_Str(), nodeName) == 0 )
-         return node;
+      _bindRawData();
+      for ( S32 n = 0; n < mMeshList.size(); ++n )
+      {
+         const SubMesh* source = &mStaging->mMeshList[n];
+         SubMesh* subMeshData = &mMeshList[n];
+         for ( S32 l = 0; l < subMeshData->mLODs.size(); ++l )
+            subMeshData->mLODs[l].mIndices = subMeshData->mRawLODIndices.address() + (source->mLODs[l].mIndices - source->mRawLODIndices.address());
+      }
    }
+   _compileAnimation();
 
-   return NULL;
+   // The staging copy never made GPU buffers and no longer owns the blob.
+   mStaging->mBinBuffer = NULL;
+   mStaging->mMeshList.clear();
+   SAFE_DELETE(mStaging);
 }
 
-void MeshAsset::_calcInterpolatedRotation(aiQuaternion& Out, F64 AnimationTime, const aiNodeAnim* pNodeAnim)
+void MeshAsset::_bindRawData()
 {
-    // we need at least two values to interpolate...
-    if (pNodeAnim->mNumRotationKeys == 1) {
-        Out = pNodeAnim->mRotationKeys[0].mValue;
-        return;
-    }
+   for ( S32 n = 0; n < mMeshList.size(); ++n )
+   {
+      SubMesh* subMeshData = &mMeshList[n];
+
+      if ( mCompactVertices )
+      {
+         subMeshData->mVertexCount  = subMeshData->mRawCompactVerts.size();
+         subMeshData->mVertexData   = subMeshData->mVertexCount > 0 ? (const U8*)subMeshData->mRawCompactVerts.address() : NULL;
+      } else {
+         subMeshData->mVertexCount  = subMeshData->mRawVerts.size();
+         subMeshData->mVertexData   = subMeshData->mVertexCount > 0 ? (const U8*)subMeshData->mRawVerts.address() : NULL;
+      }
+
+      subMeshData->mFaceCount    = subMeshData->mRawFaces.size();
+      subMeshData->mIndexCount   = subMeshData->mRawIndices.size() / getIndexSize(subMeshData->mVertexCount);
+      subMeshData->mFaces        = subMeshData->mFaceCount > 0 ? subMeshData->mRawFaces.address() : NULL;
+      subMeshData->mIndices      = subMeshData->mIndexCount > 0 ? subMeshData->mRawIndices.address() : NULL;
+   }
+}
+
+bool MeshAsset::loadBin()
+{
+   char cachedFilename[256];
+   dSprintf(cachedFilename, 256, "%s.bin", mMeshFile);
+   StringTableEntry cachedPath = Platform::getCachedFilePath(cachedFilename);
+
+   if ( _loadBinFile(cachedPath) )
+      return true;
+
+   // Upgrade caches written in the old per-field format.
+   if ( _loadLegacyBinFile(cachedPath) )
+   {
+      _optimizeMeshes();
+      _generateLODs();
+      _saveBinFile(cachedPath);
+      return true;
+   }
+
+   return false;
+}
+
+void MeshAsset::saveBin()
+{
+   char cachedFilename[256];
+   dSprintf(cachedFilename, 256, "%s.bin", mMeshFile);
+   StringTableEntry cachedPath = Platform::getCachedFilePath(cachedFilename);
+
+   _saveBinFile(cachedPath);
+}
+
+bool MeshAsset::_loadBinFile(const char* path)
+{
+   FileStream stream;
+   if ( !stream.open(path, FileStream::Read) )
+      return false;
+
+   // Check the header before committing to the full read.
+   U32 fileSize = stream.getStreamSize();
+   if ( fileSize < sizeof(BinHeader) )
+      return false;
+
+   BinHeader header;
+   if ( !stream.read(sizeof(BinHeader), &header) )
+      return false;
+
+   U32 vertexStride = (header.flags & BinCompactVertices) ? sizeof(Graphics::PosUVTBNCompactVertex) : sizeof(Graphics::PosUVTBNBonesVertex);
+   if ( header.magic != BinMagic 
+      || header.version != MeshAsset::BinVersion 
+      || header.fileSize != fileSize 
+      || header.vertexStride != vertexStride )
+      return false;
+
+   if ( (U64)sizeof(BinHeader) + (U64)header.meshCount * sizeof(BinSubMesh) > fileSize )
+      return false;
+
+   // The whole file is pulled in with a single read into an aligned buffer.
+   // The vertex and index buffers reference it directly, so it lives as long
+   // as the mesh does.
+   void* buffer = dMalloc(fileSize + BinAlignment);
+   U8* data = (U8*)(((size_t)buffer + BinAlignment - 1) & ~(size_t)(BinAlignment - 1));
+   stream.setPosition(0);
+   if ( !stream.read(fileSize, data) )
+   {
+      dFree(buffer);
+      return false;
+   }
+   stream.close();
+
+   const BinSubMesh* table = (const BinSubMesh*)(data + sizeof(BinHeader));
+   for ( U32 n = 0; n < header.meshCount; ++n )
+   {
+      const BinSubMesh* entry = &table[n];
+      U32 indexSize = getIndexSize(entry->vertexCount);
+      if ( !isBinRangeValid(entry->faceOffset, entry->faceCount, sizeof(MeshFace), fileSize)
+         || !isBinRangeValid(entry->indexOffset, entry->indexCount, indexSize, fileSize)
+         || !isBinRangeValid(entry->vertexOffset, entry->vertexCount, header.vertexStride, fileSize)
+         || entry->lodCount > MaxLODs
+         || !isBinRangeValid(entry->lodOffset, entry->lodCount, sizeof(BinLOD), fileSize) )
+      {
+         Con::warnf("[MeshAsset] Corrupt binary file: %s", path);
+         dFree(buffer);
+         return false;
+      }
+
+      const BinLOD* lods = (const BinLOD*)(data + entry->lodOffset);
+      for ( U32 l = 0; l < entry->lodCount; ++l )
+      {
+         if ( !isBinRangeValid(lods[l].indexOffset, lods[l].indexCount, indexSize, fileSize) )
+         {
+            Con::warnf("[MeshAsset] Corrupt binary file: %s", path);
+            dFree(buffer);
+            return false;
+         }
+      }
+   }
+
+   // Skinned meshes carry their hierarchy and animations, so they load
+   // without touching Assimp.
+   mIsAnimated = (header.flags & BinAnimated) != 0;
+   mNodes.clear();
+   mAnimations.clear();
+   if ( mIsAnimated && !_loadBinAnimation(data, header) )
+   {
+      Con::warnf("[MeshAsset] Corrupt binary file: %s", path);
+      mIsAnimated = false;
+      mNodes.clear();
+      mAnimations.clear();
+      dFree(buffer);
+      return false;
+   }
+
+   _clearMeshList();
+   mBinBuffer = buffer;
+   mCompactVertices = (header.flags & BinCompactVertices) != 0;
+   mMeshList.increment(header.meshCount);
+
+   for ( U32 n = 0; n < header.meshCount; ++n )
+   {
+      const BinSubMesh* entry = &table[n];
+      SubMesh* subMeshData = &mMeshList[n];
+
+      subMeshData->mBoundingBox.minExtents.set(entry->minExtents[0], entry->minExtents[1], entry->minExtents[2]);
+      subMeshData->mBoundingBox.maxExtents.set(entry->maxExtents[0], entry->maxExtents[1], entry->maxExtents[2]);
+      subMeshData->mMaterialIndex   = entry->materialIndex;
+      subMeshData->mVertexBuffer.idx = bgfx::invalidHandle;
+      subMeshData->mIndexBuffer.idx  = bgfx::invalidHandle;
+      subMeshData->mIsCluster        = false;
+
+      subMeshData->mFaceCount    = entry->faceCount;
+      subMeshData->mIndexCount   = entry->indexCount;
+      subMeshData->mVertexCount  = entry->vertexCount;
+      subMeshData->mFaces        = entry->faceCount > 0 ? (const MeshFace*)(data + entry->faceOffset) : NULL;
+      subMeshData->mIndices      = entry->indexCount > 0 ? data + entry->indexOffset : NULL;
+      subMeshData->mVertexData   = entry->vertexCount > 0 ? data + entry->vertexOffset : NULL;
+
+      const BinLOD* lods = (const BinLOD*)(data + entry->lodOffset);
+      subMeshData->mLODs.increment(entry->lodCount);
+      for ( U32 l = 0; l < entry->lodCount; ++l )
+      {
+         MeshLOD* lod = &subMeshData->mLODs[l];
+         lod->mIndices           = lods[l].indexCount > 0 ? data + lods[l].indexOffset : NULL;
+         lod->mIndexCount        = lods[l].indexCount;
+         lod->mError             = lods[l].error;
+         lod->mIndexBuffer.idx   = bgfx::invalidHandle;
+      }
+   }
+
+   return true;
+}
+
+bool MeshAsset::_saveBinFile(const char* path)
+{
+   U32 meshCount = mMeshList.size();
+
+   // The file is assembled in memory and written with a single call. The
+   // header and submesh table are reserved up front and patched once every
+   // blob offset is known.
+   U32 estimatedSize = sizeof(BinHeader) + meshCount * sizeof(BinSubMesh);
+   for ( U32 n = 0; n < meshCount; ++n )
+   {
+      U32 indexSize = getIndexSize(mMeshList[n].mVertexCount);
+      estimatedSize += mMeshList[n].mFaceCount * sizeof(MeshFace) + mMeshList[n].mIndexCount * indexSize
+         + mMeshList[n].mVertexCount * getVertexStride() + BinAlignment * 3;
+
+      for ( S32 l = 0; l < mMeshList[n].mLODs.size(); ++l )
+         estimatedSize += mMeshList[n].mLODs[l].mIndexCount * indexSize + sizeof(BinLOD) + BinAlignment;
+   }
+
+   Vector<U8> file;
+   file.reserve(estimatedSize);
+
+   BinHeader header;
+   dMemset(&header, 0, sizeof(BinHeader));
+   header.magic         = BinMagic;
+   header.version       = MeshAsset::BinVersion;
+   header.meshCount     = meshCount;
+   header.vertexStride  = getVertexStride();
+   header.flags         = mCompactVertices ? BinCompactVertices : 0;
+
+   Vector<BinSubMesh> table;
+   table.setSize(meshCount);
+
+   appendBinBlob(file, NULL, sizeof(BinHeader));
+   U32 tableOffset = appendBinBlob(file, NULL, meshCount * sizeof(BinSubMesh));
+
+   for ( U32 n = 0; n < meshCount; ++n )
+   {
+      SubMesh* subMeshData = &mMeshList[n];
+      BinSubMesh* entry = &table[n];
+      dMemset(entry, 0, sizeof(BinSubMesh));
+      U32 indexSize = getIndexSize(subMeshData->mVertexCount);
+
+      entry->minExtents[0] = subMeshData->mBoundingBox.minExtents.x;
+      entry->minExtents[1] = subMeshData->mBoundingBox.minExtents.y;
+      entry->minExtents[2] = subMeshData->mBoundingBox.minExtents.z;
+      entry->maxExtents[0] = subMeshData->mBoundingBox.maxExtents.x;
+      entry->maxExtents[1] = subMeshData->mBoundingBox.maxExtents.y;
+      entry->maxExtents[2] = subMeshData->mBoundingBox.maxExtents.z;
+      entry->materialIndex = subMeshData->mMaterialIndex;
+
+      entry->faceCount     = subMeshData->mFaceCount;
+      entry->faceOffset    = appendBinBlob(file, subMeshData->mFaces, entry->faceCount * sizeof(MeshFace));
+      entry->indexCount    = subMeshData->mIndexCount;
+      entry->indexOffset   = appendBinBlob(file, subMeshData->mIndices, entry->indexCount * indexSize);
+      entry->vertexCount   = subMeshData->mVertexCount;
+      entry->vertexOffset  = appendBinBlob(file, subMeshData->mVertexData, entry->vertexCount * header.vertexStride);
+
+      Vector<BinLOD> lods;
+      lods.setSize(subMeshData->mLODs.size());
+      for ( S32 l = 0; l < subMeshData->mLODs.size(); ++l )
+      {
+         BinLOD* lodEntry = &lods[l];
+         dMemset(lodEntry, 0, sizeof(BinLOD));
+         lodEntry->error         = subMeshData->mLODs[l].mError;
+         lodEntry->indexCount    = subMeshData->mLODs[l].mIndexCount;
+         lodEntry->indexOffset   = appendBinBlob(file, subMeshData->mLODs[l].mIndices, lodEntry->indexCount * indexSize);
+      }
+      entry->lodCount      = lods.size();
+      entry->lodOffset     = appendBinBlob(file, lods.address(), lods.size() * sizeof(BinLOD));
+   }
+
+   if ( mIsAnimated )
+      _appendBinAnimation(file, header);
+
+   header.fileSize = file.size();
+   dMemcpy(file.address(), &header, sizeof(BinHeader));
+   if ( meshCount > 0 )
+      dMemcpy(file.address() + tableOffset, table.address(), meshCount * sizeof(BinSubMesh));
+
+   Platform::createPath(path);
+   FileStream stream;
+   if ( !stream.open(path, FileStream::Write) )
+   {
+      Con::errorf("[MeshAsset] Could not save binary file: %s", path);
+      return false;
+   }
+
+   stream.write(file.size(), file.address());
+   stream.close();
+   return true;
+}
+
+void MeshAsset::_appendBinAnimation(Vector<U8>& file, BinHeader& header)
+{
+   Vector<char> strings;
+
+   // Nodes
+   Vector<BinNode> nodes;
+   nodes.setSize(mNodes.size());
+   for ( S32 n = 0; n < mNodes.size(); ++n )
+   {
+      BinNode* entry = &nodes[n];
+      dMemset(entry, 0, sizeof(BinNode));
+      dMemcpy(entry->transformation, (const F32*)mNodes[n].mTransformation, sizeof(F32) * 16);
+      entry->nameOffset    = appendBinString(strings, mNodes[n].mName);
+      entry->parentIndex   = mNodes[n].mParentIndex;
+      entry->boneIndex     = mNodes[n].mBoneIndex;
+   }
+   header.nodeCount  = nodes.size();
+   header.nodeOffset = appendBinBlob(file, nodes.address(), nodes.size() * sizeof(BinNode));
+
+   // Bone Offsets
+   Vector<F32> bones;
+   bones.setSize(mBoneOffsets.size() * 16);
+   for ( S32 n = 0; n < mBoneOffsets.size(); ++n )
+      dMemcpy(&bones[n * 16], (const F32*)mBoneOffsets[n], sizeof(F32) * 16);
+   header.boneCount  = mBoneOffsets.size();
+   header.boneOffset = appendBinBlob(file, bones.address(), bones.size() * sizeof(F32));
+
+   // Animations and their channels. Keys are stored as Assimp lays them out.
+   Vector<BinAnimation> animations;
+   animations.setSize(mAnimations.size());
+   for ( S32 a = 0; a < mAnimations.size(); ++a )
+   {
+      MeshAnimation* anim = &mAnimations[a];
+      BinAnimation* animEntry = &animations[a];
+      dMemset(animEntry, 0, sizeof(BinAnimation));
+      animEntry->duration         = anim->mDuration;
+      animEntry->ticksPerSecond   = anim->mTicksPerSecond;
+      animEntry->nameOffset       = appendBinString(strings, anim->mName);
+
+      Vector<BinNodeAnim> channels;
+      channels.setSize(anim->mChannels.size());
+      for ( S32 c = 0; c < anim->mChannels.size(); ++c )
+      {
+         MeshNodeAnim* channel = &anim->mChannels[c];
+         BinNodeAnim* entry = &channels[c];
+         dMemset(entry, 0, sizeof(BinNodeAnim));
+         entry->nodeIndex           = channel->mNodeIndex;
+         entry->positionKeyCount    = channel->mPositionKeys.size();
+         entry->positionKeyOffset   = appendBinBlob(file, channel->mPositionKeys.address(), entry->positionKeyCount * sizeof(aiVectorKey));
+         entry->rotationKeyCount    = channel->mRotationKeys.size();
+         entry->rotationKeyOffset   = appendBinBlob(file, channel->mRotationKeys.address(), entry->rotationKeyCount * sizeof(aiQuatKey));
+         entry->scalingKeyCount     = channel->mScalingKeys.size();
+         entry->scalingKeyOffset    = appendBinBlob(file, channel->mScalingKeys.address(), entry->scalingKeyCount * sizeof(aiVectorKey));
+      }
+      animEntry->channelCount    = channels.size();
+      animEntry->channelOffset   = appendBinBlob(file, channels.address(), channels.size() * sizeof(BinNodeAnim));
+   }
+   header.animationCount  = animations.size();
+   header.animationOffset = appendBinBlob(file, animations.address(), animations.size() * sizeof(BinAnimation));
+
+   header.stringSize    = strings.size();
+   header.stringOffset  = appendBinBlob(file, strings.address(), strings.size());
+   header.flags        |= BinAnimated;
+}
+
+bool MeshAsset::_loadBinAnimation(const U8* data, const BinHeader& header)
+{
+   if ( header.nodeCount == 0 
+      || !isBinRangeValid(header.nodeOffset, header.nodeCount, sizeof(BinNode), header.fileSize)
+      || !isBinRangeValid(header.boneOffset, header.boneCount, sizeof(F32) * 16, header.fileSize)
+      || !isBinRangeValid(header.animationOffset, header.animationCount, sizeof(BinAnimation), header.fileSize)
+      || !isBinRangeValid(header.stringOffset, header.stringSize, 1, header.fileSize) )
+      return false;
+
+   const char* strings = (const char*)(data + header.stringOffset);
+   if ( header.stringSize == 0 || strings[header.stringSize - 1] != 0 )
+      return false;
+
+   // Nodes and the bone map built from them.
+   const BinNode* nodes = (const BinNode*)(data + header.nodeOffset);
+   mNodes.setSize(header.nodeCount);
+   mBoneMap.clear();
+   for ( U32 n = 0; n < header.nodeCount; ++n )
+   {
+      const BinNode* entry = &nodes[n];
+      if ( entry->nameOffset >= header.stringSize 
+         || entry->parentIndex >= (S32)n 
+         || entry->boneIndex >= (S32)header.boneCount )
+         return false;
+
+      MeshNode* node = &mNodes[n];
+      node->mName             = StringTable->insert(strings + entry->nameOffset, true);
+      node->mParentIndex      = entry->parentIndex;
+      node->mBoneIndex        = entry->boneIndex;
+      dMemcpy((F32*)node->mTransformation, entry->transformation, sizeof(F32) * 16);
+
+      if ( node->mBoneIndex >= 0 )
+         mBoneMap.insert(node->mName, node->mBoneIndex);
+   }
+   mGlobalInverseTransform = inverseTransform(mNodes[0].mTransformation);
+
+   // Bone Offsets
+   const F32* bones = (const F32*)(data + header.boneOffset);
+   mBoneOffsets.setSize(header.boneCount);
+   for ( U32 n = 0; n < header.boneCount; ++n )
+      dMemcpy((F32*)mBoneOffsets[n], &bones[n * 16], sizeof(F32) * 16);
+
+   // Animations
+   const BinAnimation* animations = (const BinAnimation*)(data + header.animationOffset);
+   mAnimations.clear();
+   mAnimations.increment(header.animationCount);
+   for ( U32 a = 0; a < header.animationCount; ++a )
+   {
+      const BinAnimation* animEntry = &animations[a];
+      if ( animEntry->nameOffset >= header.stringSize
+         || !isBinRangeValid(animEntry->channelOffset, animEntry->channelCount, sizeof(BinNodeAnim), header.fileSize) )
+         return false;
+
+      MeshAnimation* anim = &mAnimations[a];
+      anim->mName             = StringTable->insert(strings + animEntry->nameOffset, true);
+      anim->mDuration         = animEntry->duration;
+      anim->mTicksPerSecond   = animEntry->ticksPerSecond;
+      anim->mNodeChannels.setSize(header.nodeCount);
+      anim->mNodeChannels.fill(-1);
+
+      const BinNodeAnim* channels = (const BinNodeAnim*)(data + animEntry->channelOffset);
+      anim->mChannels.increment(animEntry->channelCount);
+      for ( U32 c = 0; c < animEntry->channelCount; ++c )
+      {
+         const BinNodeAnim* entry = &channels[c];
+         if ( entry->nodeIndex >= header.nodeCount 
+            || !isBinRangeValid(entry->positionKeyOffset, entry->positionKeyCount, sizeof(aiVectorKey), header.fileSize)
+            || !isBinRangeValid(entry->rotationKeyOffset, entry->rotationKeyCount, sizeof(aiQuatKey), header.fileSize)
+            || !isBinRangeValid(entry->scalingKeyOffset, entry->scalingKeyCount, sizeof(aiVectorKey), header.fileSize) )
+            return false;
+
+         MeshNodeAnim* channel = &anim->mChannels[c];
+         channel->mNodeIndex = entry->nodeIndex;
+         anim->mNodeChannels[entry->nodeIndex] = c;
+
+         channel->mPositionKeys.setSize(entry->positionKeyCount);
+         dMemcpy(channel->mPositionKeys.address(), data + entry->positionKeyOffset, entry->positionKeyCount * sizeof(aiVectorKey));
+         channel->mRotationKeys.setSize(entry->rotationKeyCount);
+         dMemcpy(channel->mRotationKeys.address(), data + entry->rotationKeyOffset, entry->rotationKeyCount * sizeof(aiQuatKey));
+         channel->mScalingKeys.setSize(entry->scalingKeyCount);
+         dMemcpy(channel->mScalingKeys.address(), data + entry->scalingKeyOffset, entry->scalingKeyCount * sizeof(aiVectorKey));
+      }
+   }
+
+   return true;
+}
+
+// The original per-field format. Still read so existing caches upgrade in
+// place, and kept writable for benchmarkBin comparisons.
+bool MeshAsset::_loadLegacyBinFile(const char* path)
+{
+   FileStream stream;
+   if ( !stream.open(path, FileStream::Read) )
+      return false;
+
+   // Check Version Number
+   U8 binVersionNumber;
+   stream.read(&binVersionNumber);
+      
+   if ( binVersionNumber != MeshAsset::LegacyBinVersion )
+      return false;
+
+   _clearMeshList();
+   mCompactVertices = false;
+   U32 meshCount = 0;
+   stream.read(&meshCount);
+
+   for ( U32 n = 0; n < meshCount; ++n)
+   {
+      SubMesh newSubMesh;
+      mMeshList.push_back(newSubMesh);
+      SubMesh* subMeshData = &mMeshList[mMeshList.size()-1];
+      subMeshData->mVertexBuffer.idx = bgfx::invalidHandle;
+      subMeshData->mIndexBuffer.idx = bgfx::invalidHandle;
+      subMeshData->mIsCluster = false;
+
+      // Bounding Box
+      stream.read(&subMeshData->mBoundingBox.minExtents.x);
+      stream.read(&subMeshData->mBoundingBox.minExtents.y);
+      stream.read(&subMeshData->mBoundingBox.minExtents.z);
+      stream.read(&subMeshData->mBoundingBox.maxExtents.x); 
+      stream.read(&subMeshData->mBoundingBox.maxExtents.y); 
+      stream.read(&subMeshData->mBoundingBox.maxExtents.z); 
+
+      // Material
+      stream.read(&subMeshData->mMaterialIndex);
+
+      // Faces
+      U32 faceCount = 0;
+      stream.read(&faceCount);
+      for (U32 i = 0; i < faceCount; ++i)
+      {
+         U16 verts[3] = { 0, 0, 0 };
+         stream.read(&verts[0]);
+         stream.read(&verts[1]);
+         stream.read(&verts[2]);
+
+         MeshFace face;
+         face.verts[0] = verts[0];
+         face.verts[1] = verts[1];
+         face.verts[2] = verts[2];
+         subMeshData->mRawFaces.push_back(face);
+      }
+
+      // Indices, always 16 bit in this format.
+      U32 indexCount = 0;
+      stream.read(&indexCount);
+      subMeshData->mRawIndices.setSize(indexCount * sizeof(U16));
+      U16* indices = (U16*)subMeshData->mRawIndices.address();
+      for ( U32 i = 0; i < indexCount; ++i )
+         stream.read(&indices[i]);
+      
+      // Vertices
+      U32 vertexCount = 0;
+      stream.read(&vertexCount);
+      for ( U32 i = 0; i < vertexCount; ++i )
+      {
+         Graphics::PosUVTBNBonesVertex vert;
+         
+         // Position
+         stream.read(&vert.m_x);
+         stream.read(&vert.m_y);
+         stream.read(&vert.m_z);
+
+         // UV
+         stream.read(&vert.m_u);
+         stream.read(&vert.m_v);
+
+         // Tangent & Bitangent
+         stream.read(&vert.m_tangent_x);
+         stream.read(&vert.m_tangent_y);
+         stream.read(&vert.m_tangent_z);
+         stream.read(&vert.m_bitangent_x);
+         stream.read(&vert.m_bitangent_y);
+         stream.read(&vert.m_bitangent_z);
+
+         // Normals
+         stream.read(&vert.m_normal_x);
+         stream.read(&vert.m_normal_y);
+         stream.read(&vert.m_normal_z);
+
+         // Bone Information
+         stream.read(&vert.m_boneindex[0]);
+         stream.read(&vert.m_boneindex[1]);
+         stream.read(&vert.m_boneindex[2]);
+         stream.read(&vert.m_boneindex[3]);
+         stream.read(&vert.m_boneweight[0]);
+         stream.read(&vert.m_boneweight[1]);
+         stream.read(&vert.m_boneweight[2]);
+         stream.read(&vert.m_boneweight[3]);
+
+         subMeshData->mRawVerts.push_back(vert);
+      }
+   }
+
+   stream.close();
+   _bindRawData();
+   return true;
+}
+
+bool MeshAsset::_saveLegacyBinFile(const char* path)
+{
+   // The legacy format only has 16 bit indices.
+   for ( S32 n = 0; n < mMeshList.size(); ++n )
+   {
+      if ( getIndexSize(mMeshList[n].mVertexCount) != sizeof(U16) )
+      {
+         Con::warnf("[MeshAsset] %s has too many vertices for the legacy binary format.", mMeshFile);
+         return false;
+      }
+   }
+
+   Platform::createPath(path);
+   FileStream stream;
+   if ( !stream.open(path, FileStream::Write) )
+   {
+      Con::errorf("[MeshAsset] Could not save binary file: %s", path);
+      return false;
+   }
+
+   // Bin Version
+   stream.write(MeshAsset::LegacyBinVersion);
+
+   U32 meshCount = mMeshList.size();
+   stream.write(meshCount);
+
+   for ( U32 n = 0; n < meshCount; ++n)
+   {
+      SubMesh* subMeshData = &mMeshList[n];
+
+      // Bounding Box
+      stream.write(subMeshData->mBoundingBox.minExtents.x);
+      stream.write(subMeshData->mBoundingBox.minExtents.y);
+      stream.write(subMeshData->mBoundingBox.minExtents.z);
+      stream.write(subMeshData->mBoundingBox.maxExtents.x); 
+      stream.write(subMeshData->mBoundingBox.maxExtents.y); 
+      stream.write(subMeshData->mBoundingBox.maxExtents.z); 
+
+      // Material
+      stream.write(subMeshData->mMaterialIndex);
+
+      // Faces
+      stream.write(subMeshData->mFaceCount);
+      for (U32 i = 0; i < subMeshData->mFaceCount; ++i)
+      {
+         const MeshFace* face = &subMeshData->mFaces[i];
+         stream.write((U16)face->verts[0]);
+         stream.write((U16)face->verts[1]);
+         stream.write((U16)face->verts[2]);
+      }
+
+      // Indices
+      const U16* indices = (const U16*)subMeshData->mIndices;
+      stream.write(subMeshData->mIndexCount);
+      for ( U32 i = 0; i < subMeshData->mIndexCount; ++i )
+         stream.write(indices[i]);
+      
+      // Vertices
+      stream.write(subMeshData->mVertexCount);
+      for ( U32 i = 0; i < subMeshData->mVertexCount; ++i )
+      {
+         // The legacy format only knows the full layout.
+         Graphics::PosUVTBNBonesVertex unpacked;
+         const Graphics::PosUVTBNBonesVertex* vert = (const Graphics::PosUVTBNBonesVertex*)subMeshData->mVertexData + i;
+         if ( mCompactVertices )
+         {
+            unpackCompactVertex(&unpacked, ((const Graphics::PosUVTBNCompactVertex*)subMeshData->mVertexData)[i]);
+            vert = &unpacked;
+         }
+         
+         // Position
+         stream.write(vert->m_x);
+         stream.write(vert->m_y);
+         stream.write(vert->m_z);
+
+         // UV
+         stream.write(vert->m_u);
+         stream.write(vert->m_v);
+
+         // Tangent & Bitangent
+         stream.write(vert->m_tangent_x);
+         stream.write(vert->m_tangent_y);
+         stream.write(vert->m_tangent_z);
+         stream.write(vert->m_bitangent_x);
+         stream.write(vert->m_bitangent_y);
+         stream.write(vert->m_bitangent_z);
+
+         // Normals
+         stream.write(vert->m_normal_x);
+         stream.write(vert->m_normal_y);
+         stream.write(vert->m_normal_z);
+
+         // Bone Information
+         stream.write(vert->m_boneindex[0]);
+         stream.write(vert->m_boneindex[1]);
+         stream.write(vert->m_boneindex[2]);
+         stream.write(vert->m_boneindex[3]);
+         stream.write(vert->m_boneweight[0]);
+         stream.write(vert->m_boneweight[1]);
+         stream.write(vert->m_boneweight[2]);
+         stream.write(vert->m_boneweight[3]);
+      }
+   }
+
+   stream.close();
+   return true;
+}
+
+// Times loading this mesh from the legacy per-field cache against the
+// aligned bulk cache. Cold is the first load of each file, warm is the
+// average of the following iterations. Neither includes GPU upload.
+void MeshAsset::benchmarkBin(U32 iterations)
+{
+   if ( !mIsLoaded || mMeshList.size() == 0 )
+   {
+      Con::warnf("MeshAsset::benchmarkBin - No mesh data loaded for %s", mMeshFile);
+      return;
+   }
+   iterations = getMax(iterations, (U32)1);
+
+   char legacyFilename[256];
+   char binFilename[256];
+   dSprintf(legacyFilename, 256, "%s.bench-legacy.bin", mMeshFile);
+   dSprintf(binFilename, 256, "%s.bench.bin", mMeshFile);
+   StringTableEntry legacyPath = Platform::getCachedFilePath(legacyFilename);
+   StringTableEntry binPath = Platform::getCachedFilePath(binFilename);
+
+   if ( !_saveLegacyBinFile(legacyPath) || !_saveBinFile(binPath) )
+      return;
+
+   U32 vertexCount = 0;
+   for ( S32 n = 0; n < mMeshList.size(); ++n )
+      vertexCount += mMeshList[n].mVertexCount;
+
+   F64 hpFreq = (F64)bx::getHPFrequency() / 1000.0; // milli-seconds.
+   F64 coldTime[2];
+   F64 warmTime[2];
+   MeshAsset scratch;
+
+   for ( U32 format = 0; format < 2; ++format )
+   {
+      F64 warmTotal = 0.0;
+      for ( U32 i = 0; i <= iterations; ++i )
+      {
+         scratch._clearMeshList();
+
+         U64 startTime = bx::getHPCounter();
+         bool loaded = (format == 0) ? scratch._loadLegacyBinFile(legacyPath) : scratch._loadBinFile(binPath);
+         F64 elapsed = (F64)(bx::getHPCounter() - startTime) / hpFreq;
+
+         if ( !loaded )
+         {
+            Con::warnf("MeshAsset::benchmarkBin - Failed to reload %s", (format == 0) ? legacyPath : binPath);
+            Platform::fileDelete(legacyPath);
+            Platform::fileDelete(binPath);
+            return;
+         }
+
+         if ( i == 0 )
+            coldTime[format] = elapsed;
+         else
+            warmTime[format] = (warmTotal += elapsed) / iterations;
+      }
+   }
+
+   Platform::fileDelete(legacyPath);
+   Platform::fileDelete(binPath);
+
+   Con::printf("MeshAsset::benchmarkBin - %s: %d submeshes, %d vertices, %d iterations.", mMeshFile, mMeshList.size(), vertexCount, iterations);
+   Con::printf("   Legacy: cold %.3f ms, warm %.3f ms", coldTime[0], warmTime[0]);
+   Con::printf("   Bulk:   cold %.3f ms, warm %.3f ms (%.1fx faster warm)", coldTime[1], warmTime[1], 
+      warmTime[1] > 0.0 ? warmTime[0] / warmTime[1] : 0.0);
+}
+
+void MeshAsset::processMesh()
+{
+   //U64 hpFreq = bx::getHPFrequency() / 1000000.0; // micro-seconds.
+   //U64 startTime = bx::getHPCounter();
+
+   for ( S32 n = 0; n < mMeshList.size(); ++n)
+   {
+      SubMesh* subMeshData = &mMeshList[n];
+      if ( subMeshData->mVertexCount == 0 || subMeshData->mIndexCount == 0 )
+         continue;
+
+      U32 indexSize = getIndexSize(subMeshData->mVertexCount);
+      U16 indexFlags = (indexSize == sizeof(U32)) ? BGFX_BUFFER_INDEX32 : BGFX_BUFFER_NONE;
+      if ( indexFlags == BGFX_BUFFER_INDEX32 && (bgfx::getCaps()->supported & BGFX_CAPS_INDEX32) == 0 )
+      {
+         Con::warnf("[MeshAsset] %s needs 32 bit indices, which this renderer doesn't support.", mMeshFile);
+         continue;
+      }
+
+      // Load the verts and indices into bgfx buffers. Both reference either
+      // the imported vectors or the binary cache blob, no copy is made here.
+      const bgfx::Memory* vertexMemory = bgfx::makeRef(subMeshData->mVertexData, subMeshData->mVertexCount * getVertexStride());
+      const bgfx::VertexDecl* vertexDecl = &getVertexDecl();
+
+      // Renderers without half float attributes get the full layout, 
+      // converted on the way up.
+      if ( mCompactVertices && (bgfx::getCaps()->supported & BGFX_CAPS_VERTEX_ATTRIB_HALF) == 0 )
+      {
+         vertexMemory = bgfx::alloc(subMeshData->mVertexCount * sizeof(Graphics::PosUVTBNBonesVertex));
+         bgfx::vertexConvert(Graphics::PosUVTBNBonesVertex::ms_decl, vertexMemory->data, 
+            Graphics::PosUVTBNCompactVertex::ms_decl, subMeshData->mVertexData, subMeshData->mVertexCount);
+         vertexDecl = &Graphics::PosUVTBNBonesVertex::ms_decl;
+      }
+
+	   subMeshData->mVertexBuffer = bgfx::createVertexBuffer(vertexMemory, *vertexDecl);
+
+	   subMeshData->mIndexBuffer = bgfx::createIndexBuffer(
+            bgfx::makeRef(subMeshData->mIndices, subMeshData->mIndexCount * indexSize), indexFlags
+		   );
+
+      // LODs only bring their own indices.
+      for ( S32 l = 0; l < subMeshData->mLODs.size(); ++l )
+      {
+         MeshLOD* lod = &subMeshData->mLODs[l];
+         if ( lod->mIndexCount > 0 )
+            lod->mIndexBuffer = bgfx::createIndexBuffer(bgfx::makeRef(lod->mIndices, lod->mIndexCount * indexSize), indexFlags);
+      }
+
+      // Bounding Box
+      mBoundingBox.intersect(subMeshData->mBoundingBox);
+   }
+
+   //U64 endTime = bx::getHPCounter();
+   //Con::printf("PROCESS MESH TOOK: %d microseconds. (1 microsecond = 0.001 milliseconds)", (U32)((endTime - startTime) / hpFreq));
+}
+
+// Builds the runtime skeleton and SoA clips from the imported (or cached)
+// node hierarchy and channels.
+void MeshAsset::_compileAnimation()
+{
+   mSkeleton.clear();
+   mClips.clear();
+
+   if ( !mIsAnimated || mNodes.size() == 0 )
+      return;
+
+   mSkeleton.init(mNodes.size(), mBoneOffsets.size());
+   for ( S32 n = 0; n < mNodes.size(); ++n )
+      mSkeleton.setNode(n, mNodes[n].mParentIndex, mNodes[n].mBoneIndex, mNodes[n].mTransformation);
+   for ( S32 n = 0; n < mBoneOffsets.size(); ++n )
+      mSkeleton.setBoneOffset(n, mBoneOffsets[n]);
+   mSkeleton.setGlobalInverseTransform(mGlobalInverseTransform);
+
+   mClips.increment(mAnimations.size());
+   for ( S32 a = 0; a < mAnimations.size(); ++a )
+   {
+      const MeshAnimation* anim = &mAnimations[a];
+      AnimationClip* clip = &mClips[a];
+      clip->mName             = anim->mName;
+      clip->mDuration         = (F32)anim->mDuration;
+      clip->mTicksPerSecond   = (F32)anim->mTicksPerSecond;
+      clip->init(mNodes.size());
+
+      for ( S32 c = 0; c < anim->mChannels.size(); ++c )
+      {
+         const MeshNodeAnim* channel = &anim->mChannels[c];
+
+         U32 first = clip->addTrack(channel->mNodeIndex, AnimationClip::Position, channel->mPositionKeys.size());
+         for ( S32 k = 0; k < channel->mPositionKeys.size(); ++k )
+         {
+            const aiVectorKey& key = channel->mPositionKeys[k];
+            F32* value = &clip->mValues[(first + k) * 4];
+            clip->mTimes[first + k] = (F32)key.mTime;
+            value[0] = key.mValue.x;
+            value[1] = key.mValue.y;
+            value[2] = key.mValue.z;
+            value[3] = 0.0f;
+         }
+
+         first = clip->addTrack(channel->mNodeIndex, AnimationClip::Rotation, channel->mRotationKeys.size());
+         for ( S32 k = 0; k < channel->mRotationKeys.size(); ++k )
+         {
+            const aiQuatKey& key = channel->mRotationKeys[k];
+            F32* value = &clip->mValues[(first + k) * 4];
+            clip->mTimes[first + k] = (F32)key.mTime;
+            value[0] = key.mValue.x;
+            value[1] = key.mValue.y;
+            value[2] = key.mValue.z;
+            value[3] = key.mValue.w;
+         }
+
+         first = clip->addTrack(channel->mNodeIndex, AnimationClip::Scaling, channel->mScalingKeys.size());
+         for ( S32 k = 0; k < channel->mScalingKeys.size(); ++k )
+         {
+            const aiVectorKey& key = channel->mScalingKeys[k];
+            F32* value = &clip->mValues[(first + k) * 4];
+            clip->mTimes[first + k] = (F32)key.mTime;
+            value[0] = key.mValue.x;
+            value[1] = key.mValue.y;
+            value[2] = key.mValue.z;
+            value[3] = 0.0f;
+         }
+      }
+   }
+}
+
+S32 MeshAsset::findClip(const char* name)
+{
+   for ( S32 n = 0; n < mClips.size(); ++n )
+   {
+      if ( dStricmp(mClips[n].mName, name) == 0 )
+         return n;
+   }
+
+   return -1;
+}
+
+// Samples the first clip into state and returns the number of
+// transformations loaded into transformsOut.
+U32 MeshAsset::getAnimatedTransforms(AnimationState* state, F64 TimeInSeconds, F32* transformsOut)
+{
+   if ( mClips.size() == 0 ) return 0;
+
+   if ( !state->isValid(&mSkeleton) )
+      state->init(&mSkeleton);
+
+   const AnimationClip* clip = &mClips[0];
+   clip->sample(clip->getTicks(TimeInSeconds), state->mCursors.address(), mSkeleton.getRestPose(), state->mLocalPose.address());
+   return mSkeleton.buildSkinTransforms(state, transformsOut);
+}
+
+// Blends every layer into the state's local pose and composes it once, so
+// extra layers only cost their key sampling.
+U32 MeshAsset::getAnimatedTransforms(AnimationState* state, AnimationLayer* layers, U32 layerCount, F32* transformsOut)
+{
+   if ( mClips.size() == 0 ) return 0;
+
+   if ( !state->isValid(&mSkeleton) )
+      state->init(&mSkeleton);
+
+   const U32 nodeCount = mSkeleton.getNodeCount();
+   const BoneTransform* restPose = mSkeleton.getRestPose();
+   BoneTransform* pose = state->mLocalPose.address();
+
+   for ( U32 n = 0; n < layerCount; ++n )
+   {
+      if ( layers[n].mCursors.size() != nodeCount * AnimationClip::ChannelCount )
+      {
+         layers[n].mCursors.setSize(nodeCount * AnimationClip::ChannelCount);
+         dMemset(layers[n].mCursors.address(), 0, layers[n].mCursors.size() * sizeof(U32));
+      }
+   }
+
+   // Weighted layers first.
+   AnimationClip::beginBlend(pose, nodeCount);
+   for ( U32 n = 0; n < layerCount; ++n )
+   {
+      AnimationLayer* layer = &layers[n];
+      if ( layer->mMode != AnimationLayer::Blend || layer->mWeight <= 0.0f || layer->mClip < 0 || layer->mClip >= mClips.size() )
+         continue;
+
+      const AnimationClip* clip = &mClips[layer->mClip];
+      const F32* mask = layer->mMask.size() == (S32)nodeCount ? layer->mMask.address() : NULL;
+      clip->accumulate(clip->getTicks(layer->mTime), layer->mCursors.address(), restPose, layer->mWeight, mask, pose);
+   }
+   AnimationClip::endBlend(pose, restPose, nodeCount);
+
+   // Then additive layers on top.
+   for ( U32 n = 0; n < layerCount; ++n )
+   {
+      AnimationLayer* layer = &layers[n];
+      if ( layer->mMode != AnimationLayer::Additive || layer->mWeight <= 0.0f || layer->mClip < 0 || layer->mClip >= mClips.size() )
+         continue;
+
+      const AnimationClip* clip = &mClips[layer->mClip];
+      const F32* mask = layer->mMask.size() == (S32)nodeCount ? layer->mMask.address() : NULL;
+      clip->applyAdditive(clip->getTicks(layer->mTime), layer->mCursors.address(), restPose, layer->mWeight, mask, pose);
+   }
+
+   return mSkeleton.buildSkinTransforms(state, transformsOut);
+}
+
+S32 MeshAsset::findNode(const char* name)
+{
+   for ( S32 n = 0; n < mNodes.size(); ++n )
+   {
+      if ( dStricmp(mNodes[n].mName, name) == 0 )
+         return n;
+   }
+
+   return -1;
+}
+
+// Fills maskOut with 1 for the named node and everything below it, 0 for
+// the rest of the skeleton.
+bool MeshAsset::buildNodeMask(const char* rootNodeName, Vector<F32>& maskOut)
+{
+   S32 root = findNode(rootNodeName);
+   if ( root < 0 )
+   {
+      maskOut.clear();
+      return false;
+   }
+
+   maskOut.setSize(mNodes.size());
+   for ( S32 n = 0; n < mNodes.size(); ++n )
+   {
+      S32 parent = mNodes[n].mParentIndex;
+      maskOut[n] = (n == root || (parent >= 0 && maskOut[parent] > 0.0f)) ? 1.0f : 0.0f;
+   }
+
+   return true;
+}
+
+// Times posing characters copies of this mesh with the compiled runtime
+// against the reference node walk, in bones per second.
+void MeshAsset::benchmarkAnimation(U32 characters, U32 frames)
+{
+   if ( !mIsLoaded || mClips.size() == 0 )
+   {
+      Con::warnf("MeshAsset::benchmarkAnimation - %s has no animations.", mMeshFile);
+      return;
+   }
+   characters = getMax(characters, (U32)1);
+   frames = getMax(frames, (U32)1);
+
+   const U32 boneCount = mSkeleton.getBoneCount();
+   const F32 frameTime = 1.0f / 60.0f;
+
+   Vector<F32> offsets;
+   offsets.setSize(characters);
+   for ( U32 c = 0; c < characters; ++c )
+      offsets[c] = mRandF(0.0f, 10.0f);
+
+   Vector<F32> referenceOut;
+   Vector<F32> compiledOut;
+   referenceOut.setSize(characters * boneCount * 16);
+   compiledOut.setSize(characters * boneCount * 16);
+
+   AnimationState* states = new AnimationState[characters];
+   for ( U32 c = 0; c < characters; ++c )
+      states[c].init(&mSkeleton);
+
+   F64 hpFreq = (F64)bx::getHPFrequency();
+
+   U64 startTime = bx::getHPCounter();
+   for ( U32 f = 0; f < frames; ++f )
+   {
+      for ( U32 c = 0; c < characters; ++c )
+         _getReferenceTransforms(offsets[c] + f * frameTime, &referenceOut[c * boneCount * 16]);
+   }
+   F64 referenceSeconds = (F64)(bx::getHPCounter() - startTime) / hpFreq;
+
+   startTime = bx::getHPCounter();
+   for ( U32 f = 0; f < frames; ++f )
+   {
+      for ( U32 c = 0; c < characters; ++c )
+         getAnimatedTransforms(&states[c], offsets[c] + f * frameTime, &compiledOut[c * boneCount * 16]);
+   }
+   F64 compiledSeconds = (F64)(bx::getHPCounter() - startTime) / hpFreq;
+
+   // Both paths evaluated the same final frame, so they should agree.
+   F32 maxError = 0.0f;
+   for ( S32 n = 0; n < compiledOut.size(); ++n )
+      maxError = getMax(maxError, mFabs(compiledOut[n] - referenceOut[n]));
+
+   delete [] states;
+
+   F64 bones = (F64)characters * frames * boneCount;
+   Con::printf("MeshAsset::benchmarkAnimation - %s: %d characters, %d bones, %d frames.", mMeshFile, characters, boneCount, frames);
+   Con::printf("   Reference: %.2f ms, %.2f million bones/sec", referenceSeconds * 1000.0, referenceSeconds > 0.0 ? bones / referenceSeconds / 1000000.0 : 0.0);
+   Con::printf("   Compiled:  %.2f ms, %.2f million bones/sec", compiledSeconds * 1000.0, compiledSeconds > 0.0 ? bones / compiledSeconds / 1000000.0 : 0.0);
+   Con::printf("   Max difference: %f", maxError);
+}
+
+// The original per node evaluation with MatrixF temporaries and linear key
+// searches. Kept as the reference for benchmarkAnimation.
+U32 MeshAsset::_getReferenceTransforms(F64 TimeInSeconds, F32* transformsOut)
+
+{
+   if ( mAnimations.size() == 0 || mNodes.size() == 0 ) return 0;
+
+   const MeshAnimation* pAnimation = &mAnimations[0];
+   F64 TicksPerSecond = pAnimation->mTicksPerSecond != 0 ? 
+                           pAnimation->mTicksPerSecond : 25.0f;
+   F64 TimeInTicks = TimeInSeconds * TicksPerSecond;
+   F64 AnimationTime = fmod(TimeInTicks, pAnimation->mDuration);
+
+   // Nodes are stored parents first so a single pass resolves every
+   // global transform.
+   Vector<MatrixF> globalTransforms;
+   globalTransforms.setSize(mNodes.size());
+
+   MatrixF Identity;
+   Identity.identity();
+
+   U32 xfrmCount = 0;
+   for ( S32 n = 0; n < mNodes.size(); ++n )
+   {
+      const MeshNode* pNode = &mNodes[n];
+      MatrixF NodeTransformation = pNode->mTransformation;
+
+      S32 channelIndex = pAnimation->mNodeChannels[n];
+      if ( channelIndex >= 0 ) 
+      {
+         const MeshNodeAnim* pNodeAnim = &pAnimation->mChannels[channelIndex];
+
+         // Interpolate scaling and generate scaling transformation matrix
+         aiVector3D Scaling;
+         _calcInterpolatedScaling(Scaling, AnimationTime, pNodeAnim);
+         MatrixF ScalingM;
+         ScalingM.InitScaleTransform(Scaling.x, Scaling.y, Scaling.z);
+
+         // Interpolate rotation and generate rotation transformation matrix
+         aiQuaternion RotationQ;
+         _calcInterpolatedRotation(RotationQ, AnimationTime, pNodeAnim); 
+         MatrixF RotationM = MatrixF(RotationQ.GetMatrix());
+
+         // Interpolate translation and generate translation transformation matrix
+         aiVector3D Translation;
+         _calcInterpolatedPosition(Translation, AnimationTime, pNodeAnim);
+         MatrixF TranslationM;
+         TranslationM.InitTranslationTransform(Translation.x, Translation.y, Translation.z);
+
+         NodeTransformation = TranslationM * RotationM * ScalingM;
+      }
+
+      const MatrixF& ParentTransform = pNode->mParentIndex >= 0 ? globalTransforms[pNode->mParentIndex] : Identity;
+      globalTransforms[n] = ParentTransform * NodeTransformation;
+
+      if ( pNode->mBoneIndex >= 0 ) 
+      {
+         U32 BoneIndex = pNode->mBoneIndex;
+         xfrmCount = getMax(xfrmCount, BoneIndex + 1);
+
+         MatrixF boneTransform = mGlobalInverseTransform * globalTransforms[n] * mBoneOffsets[BoneIndex];
+         // Assimp matricies are row-major, we need to transpose to column-major.
+         boneTransform.transpose();
+         dMemcpy(&transformsOut[BoneIndex * 16], boneTransform, sizeof(F32) * 16); 
+      }
+   }
+
+   return xfrmCount;
+}
+
+void MeshAsset::_calcInterpolatedRotation(aiQuaternion& Out, F64 AnimationTime, const MeshNodeAnim* pNodeAnim)
+{
+    // we need at least two values to interpolate...
+    if (pNodeAnim->mRotationKeys.size() == 1) {
+        Out = pNodeAnim->mRotationKeys[0].mValue;
+        return;
+    }
 
     U32 RotationIndex = _findRotation(AnimationTime, pNodeAnim);
     U32 NextRotationIndex = (RotationIndex + 1);
-    assert(NextRotationIndex < pNodeAnim->mNumRotationKeys);
+    assert(NextRotationIndex < pNodeAnim->mRotationKeys.size());
     F64 DeltaTime = (pNodeAnim->mRotationKeys[NextRotationIndex].mTime - pNodeAnim->mRotationKeys[RotationIndex].mTime);
     F64 Factor = (AnimationTime - pNodeAnim->mRotationKeys[RotationIndex].mTime) / DeltaTime;
     assert(Factor >= 0.0f && Factor <= 1.0f);
@@ -780,11 +2169,11 @@ void MeshAsset::_calcInterpolatedRotation(aiQuaternion& Out, F64 AnimationTime,
     Out = Out.Normalize();
 }
 
-U32 MeshAsset::_findRotation(F64 AnimationTime, const aiNodeAnim* pNodeAnim)
+U32 MeshAsset::_findRotation(F64 AnimationTime, const MeshNodeAnim* pNodeAnim)
 {
-    assert(pNodeAnim->mNumRotationKeys > 0);
+    assert(pNodeAnim->mRotationKeys.size() > 0);
 
-    for (U32 i = 0 ; i < pNodeAnim->mNumRotationKeys - 1 ; i++) {
+    for (U32 i = 0 ; i < pNodeAnim->mRotationKeys.size() - 1 ; i++) {
         if (AnimationTime < (F32)pNodeAnim->mRotationKeys[i + 1].mTime) {
             return i;
         }
@@ -794,17 +2183,17 @@ U32 MeshAsset::_findRotation(F64 AnimationTime, const aiNodeAnim* pNodeAnim)
     return 0;
 }
 
-void MeshAsset::_calcInterpolatedScaling(aiVector3D& Out, F64 AnimationTime, const aiNodeAnim* pNodeAnim)
+void MeshAsset::_calcInterpolatedScaling(aiVector3D& Out, F64 AnimationTime, const MeshNodeAnim* pNodeAnim)
 {
     // we need at least two values to interpolate...
-    if (pNodeAnim->mNumScalingKeys == 1) {
+    if (pNodeAnim->mScalingKeys.size() == 1) {
         Out = pNodeAnim->mScalingKeys[0].mValue;
         return;
     }
 
     U32 ScalingIndex = _findScaling(AnimationTime, pNodeAnim);
     U32 NextScalingIndex = (ScalingIndex + 1);
-    assert(NextScalingIndex < pNodeAnim->mNumScalingKeys);
+    assert(NextScalingIndex < pNodeAnim->mScalingKeys.size());
     F64 DeltaTime = (pNodeAnim->mScalingKeys[NextScalingIndex].mTime - pNodeAnim->mScalingKeys[ScalingIndex].mTime);
     F64 Factor = (AnimationTime - pNodeAnim->mScalingKeys[ScalingIndex].mTime) / DeltaTime;
     assert(Factor >= 0.0f && Factor <= 1.0f);
@@ -814,11 +2203,11 @@ void MeshAsset::_calcInterpolatedScaling(aiVector3D& Out, F64 AnimationTime, con
     Out = Start + (F32)Factor * Delta;
 }
 
-U32 MeshAsset::_findScaling(F64 AnimationTime, const aiNodeAnim* pNodeAnim)
+U32 MeshAsset::_findScaling(F64 AnimationTime, const MeshNodeAnim* pNodeAnim)
 {
-    assert(pNodeAnim->mNumScalingKeys > 0);
+    assert(pNodeAnim->mScalingKeys.size() > 0);
 
-    for (U32 i = 0 ; i < pNodeAnim->mNumScalingKeys - 1 ; i++) {
+    for (U32 i = 0 ; i < pNodeAnim->mScalingKeys.size() - 1 ; i++) {
         if (AnimationTime < (F32)pNodeAnim->mScalingKeys[i + 1].mTime) {
             return i;
         }
@@ -828,17 +2217,17 @@ U32 MeshAsset::_findScaling(F64 AnimationTime, const aiNodeAnim* pNodeAnim)
     return 0;
 }
 
-void MeshAsset::_calcInterpolatedPosition(aiVector3D& Out, F64 AnimationTime, const aiNodeAnim* pNodeAnim)
+void MeshAsset::_calcInterpolatedPosition(aiVector3D& Out, F64 AnimationTime, const MeshNodeAnim* pNodeAnim)
 {
     // we need at least two values to interpolate...
-    if (pNodeAnim->mNumPositionKeys == 1) {
+    if (pNodeAnim->mPositionKeys.size() == 1) {
         Out = pNodeAnim->mPositionKeys[0].mValue;
         return;
     }
 
     U32 PositionIndex = _findPosition(AnimationTime, pNodeAnim);
     U32 NextPositionIndex = (PositionIndex + 1);
-    assert(NextPositionIndex < pNodeAnim->mNumPositionKeys);
+    assert(NextPositionIndex < pNodeAnim->mPositionKeys.size());
     F64 DeltaTime = (pNodeAnim->mPositionKeys[NextPositionIndex].mTime - pNodeAnim->mPositionKeys[PositionIndex].mTime);
     F64 Factor = (AnimationTime - pNodeAnim->mPositionKeys[PositionIndex].mTime) / DeltaTime;
     assert(Factor >= 0.0f && Factor <= 1.0f);
@@ -848,11 +2237,11 @@ void MeshAsset::_calcInterpolatedPosition(aiVector3D& Out, F64 AnimationTime, co
     Out = Start + (F32)Factor * Delta;
 }
 
-U32 MeshAsset::_findPosition(F64 AnimationTime, const aiNodeAnim* pNodeAnim)
+U32 MeshAsset::_findPosition(F64 AnimationTime, const MeshNodeAnim* pNodeAnim)
 {
-    assert(pNodeAnim->mNumPositionKeys > 0);
+    assert(pNodeAnim->mPositionKeys.size() > 0);
 
-    for (U32 i = 0 ; i < pNodeAnim->mNumPositionKeys - 1 ; i++) {
+    for (U32 i = 0 ; i < pNodeAnim->mPositionKeys.size() - 1 ; i++) {
         if (AnimationTime < (float)pNodeAnim->mPositionKeys[i + 1].mTime) {
             return i;
         }
@@ -861,15 +2250,3 @@ U32 MeshAsset::_findPosition(F64 AnimationTime, const aiNodeAnim* pNodeAnim)
     // TODO: Need Error Handling
     return 0;
 }
-
-// Threaded Mesh Import
-MeshImportThread::MeshImportThread(MeshAsset* _meshAsset)
-{
-   mMeshAsset = _meshAsset;
-}
-
-void MeshImportThread::run(void *arg)
-{
-   mMeshAsset->loadMesh();
-   Con::printf("ASSET LOADED FROM THREAD!");
-}
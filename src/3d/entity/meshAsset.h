@@ -59,18 +59,9 @@
 #include "collection/hashTable.h"
 #endif
 
-// Threaded Import
-class MeshAsset;
-class MeshImportThread : public Thread
-{
-   protected:
-      MeshAsset*    mMeshAsset;
-
-   public:
-      MeshImportThread(MeshAsset* _meshAsset);
-
-      virtual void run(void *arg = 0);
-};
+#ifndef _SKELETON_H_
+#include "skeleton.h"
+#endif
 
 //-----------------------------------------------------------------------------
 
@@ -82,33 +73,185 @@ class MeshAsset : public AssetBase
 {
    struct MeshFace
    {
-      U16 verts[3];
+      U32 verts[3];
+   };
+
+   // A simplified index list over the same vertices as its SubMesh. mError
+   // is how far the surface moved, relative to the diagonal of the mesh.
+   struct MeshLOD
+   {
+      const U8*                                 mIndices;
+      U32                                       mIndexCount;
+      F32                                       mError;
+      bgfx::IndexBufferHandle                   mIndexBuffer;
    };
 
    struct SubMesh
    {
       Vector<MeshFace>                          mRawFaces;
       Vector<Graphics::PosUVTBNBonesVertex>     mRawVerts;
-      Vector<U16>                               mRawIndices;
+      Vector<Graphics::PosUVTBNCompactVertex>   mRawCompactVerts;
+      Vector<U8>                                mRawIndices;
+
+      // Points either at the raw vectors above (fresh import) or straight
+      // into the binary cache blob, so both paths upload without a copy.
+      // Vertices are in the asset's layout, see getVertexDecl(). Index lists
+      // are 16 bit unless the submesh has more vertices than that addresses.
+      const MeshFace*                           mFaces;
+      const U8*                                 mIndices;
+      const U8*                                 mVertexData;
+      U32                                       mFaceCount;
+      U32                                       mIndexCount;
+      U32                                       mVertexCount;
+
       bgfx::VertexBufferHandle                  mVertexBuffer;
       bgfx::IndexBufferHandle                   mIndexBuffer;
       Box3F                                     mBoundingBox;
       U32                                       mMaterialIndex;
+
+      // Simplified levels, coarsest last. The full mesh above is level 0.
+      // Fresh imports keep every level back to back in mRawLODIndices.
+      Vector<U8>                                mRawLODIndices;
+      Vector<MeshLOD>                           mLODs;
+
+      // Set on import for the pieces of a split mesh, see _splitClusters().
+      bool                                      mIsCluster;
+   };
+
+   // Node hierarchy flattened depth first, so a parent always comes
+   // before its children.
+   struct MeshNode
+   {
+      StringTableEntry                          mName;
+      S32                                       mParentIndex;
+      S32                                       mBoneIndex;
+      MatrixF                                   mTransformation;
+   };
+
+   struct MeshNodeAnim
+   {
+      U32                                       mNodeIndex;
+      Vector<aiVectorKey>                       mPositionKeys;
+      Vector<aiQuatKey>                         mRotationKeys;
+      Vector<aiVectorKey>                       mScalingKeys;
+   };
+
+   struct MeshAnimation
+   {
+      StringTableEntry                          mName;
+      F64                                       mDuration;
+      F64                                       mTicksPerSecond;
+      Vector<MeshNodeAnim>                      mChannels;
+      Vector<S32>                               mNodeChannels;    // Channel index per node, -1 if not animated.
+   };
+
+   // Binary cache layout: a BinHeader, then meshCount BinSubMesh entries,
+   // then the face, index, vertex, LOD index and BinLOD blobs of each 
+   // submesh. Vertices are PosUVTBNCompactVertex when BinCompactVertices is
+   // set. Faces use 32 bit indices, index lists use 32 bit indices only when
+   // the submesh has more than 65535 vertices. Skinned meshes follow with the node, bone, animation, channel and
+   // key tables plus a string blob for names. Every blob starts on a BinAlignment boundary and
+   // offsets are relative to the start of the file, so the whole file can be
+   // mapped or read in one call and used in place. Data is stored in host
+   // (little endian) order.
+   struct BinHeader
+   {
+      U32 magic;
+      U32 version;
+      U32 fileSize;
+      U32 meshCount;
+      U32 vertexStride;
+      U32 flags;
+      U32 nodeCount;
+      U32 nodeOffset;
+      U32 boneCount;
+      U32 boneOffset;
+      U32 animationCount;
+      U32 animationOffset;
+      U32 stringSize;
+      U32 stringOffset;
+      U32 reserved[2];
+   };
+
+   enum BinFlags
+   {
+      BinAnimated          = BIT(0),
+      BinCompactVertices   = BIT(1)
+   };
+
+   struct BinSubMesh
+   {
+      F32 minExtents[3];
+      F32 maxExtents[3];
+      U32 materialIndex;
+      U32 faceCount;
+      U32 faceOffset;
+      U32 indexCount;
+      U32 indexOffset;
+      U32 vertexCount;
+      U32 vertexOffset;
+      U32 lodCount;
+      U32 lodOffset;
+      U32 reserved;
+   };
+
+   struct BinLOD
+   {
+      F32 error;
+      U32 indexCount;
+      U32 indexOffset;
+      U32 reserved;
+   };
+
+   struct BinNode
+   {
+      F32 transformation[16];
+      U32 nameOffset;
+      S32 parentIndex;
+      S32 boneIndex;
+      U32 reserved;
+   };
+
+   struct BinAnimation
+   {
+      F64 duration;
+      F64 ticksPerSecond;
+      U32 nameOffset;
+      U32 channelCount;
+      U32 channelOffset;
+      U32 reserved;
+   };
+
+   struct BinNodeAnim
+   {
+      U32 nodeIndex;
+      U32 positionKeyCount;
+      U32 positionKeyOffset;
+      U32 rotationKeyCount;
+      U32 rotationKeyOffset;
+      U32 scalingKeyCount;
+      U32 scalingKeyOffset;
+      U32 reserved;
    };
 
 private:
    typedef AssetBase  Parent;
 
-   Assimp::Importer                       mAssimpImporter;
    bool                                   mIsLoaded;
    HashMap<const char*, U32>              mBoneMap;
    Vector<MatrixF>                        mBoneOffsets;
+   Vector<MeshNode>                       mNodes;
+   Vector<MeshAnimation>                  mAnimations;
+   MatrixF                                mGlobalInverseTransform;
+   Skeleton                               mSkeleton;
+   Vector<AnimationClip>                  mClips;
    Vector<SubMesh>                        mMeshList;
    StringTableEntry                       mMeshFile;
-   const aiScene*                         mScene;
    Box3F                                  mBoundingBox;
    bool                                   mIsAnimated;
-   MeshImportThread*                      mImportThread;
+   bool                                   mCompactVertices;
+   void*                                  mBinBuffer;
+   MeshAsset*                             mStaging;      // Refresh read by a loader thread, see initializeAsset().
 
 public:
    MeshAsset();
@@ -127,15 +270,28 @@ public:
    void                       setMeshFile( const char* pMeshFile );
    inline StringTableEntry    getMeshFile( void ) const { return mMeshFile; };
    U32                        getMeshCount() { return mMeshList.size(); }
+   U32                        getTriangleCount(U32 idx) { return mMeshList[idx].mIndexCount / 3; }
    Box3F                      getBoundingBox() { return mBoundingBox; }
+   Box3F                      getBoundingBox(U32 idx) { return mMeshList[idx].mBoundingBox; }
    void                       loadMesh();
+   void                       readMesh();
+   void                       uploadMesh();
    void                       importMesh();
    void                       saveBin();
    bool                       loadBin();
    void                       processMesh();
+   void                       benchmarkBin(U32 iterations);
 
    // Animation Functions
-   U32 getAnimatedTransforms(F64 TimeInSeconds, F32* transformsOut);
+   U32                        getAnimatedTransforms(AnimationState* state, F64 TimeInSeconds, F32* transformsOut);
+   U32                        getAnimatedTransforms(AnimationState* state, AnimationLayer* layers, U32 layerCount, F32* transformsOut);
+   S32                        findNode(const char* name);
+   bool                       buildNodeMask(const char* rootNodeName, Vector<F32>& maskOut);
+   const Skeleton*            getSkeleton() { return &mSkeleton; }
+   U32                        getClipCount() { return mClips.size(); }
+   const AnimationClip*       getClip(U32 idx) { return &mClips[idx]; }
+   S32                        findClip(const char* name);
+   void                       benchmarkAnimation(U32 characters, U32 frames);
 
    // Buffers
    bgfx::VertexBufferHandle  getVertexBuffer(U32 idx) { return mMeshList[idx].mVertexBuffer; }
@@ -143,24 +299,77 @@ public:
    U32                       getMaterialIndex(U32 idx) { return mMeshList[idx].mMaterialIndex; }
    bool                      isSkinned() { return mIsAnimated; }
 
+   // CPU side geometry, kept for as long as the mesh is loaded. Positions are
+   // the first three floats of each vertex, see getVertexStride().
+   U32                       getVertexCount(U32 idx) { return mMeshList[idx].mVertexCount; }
+   const U8*                 getVertexData(U32 idx) { return mMeshList[idx].mVertexData; }
+   U32                       getFaceCount(U32 idx) { return mMeshList[idx].mFaceCount; }
+   const U32*                getFaces(U32 idx) { return mMeshList[idx].mFaces ? mMeshList[idx].mFaces[0].verts : NULL; }
+
+   // Skinned meshes keep the full PosUVTBNBonesVertex layout, static meshes
+   // are packed into PosUVTBNCompactVertex on import.
+   const bgfx::VertexDecl&   getVertexDecl() { return mCompactVertices ? Graphics::PosUVTBNCompactVertex::ms_decl : Graphics::PosUVTBNBonesVertex::ms_decl; }
+   U32                       getVertexStride() { return mCompactVertices ? sizeof(Graphics::PosUVTBNCompactVertex) : sizeof(Graphics::PosUVTBNBonesVertex); }
+
+   // LODs. Level 0 is the full mesh, every level shares its vertex buffer.
+   U32                       getLODCount(U32 idx) { return mMeshList[idx].mLODs.size() + 1; }
+   bgfx::IndexBufferHandle   getLODIndexBuffer(U32 idx, U32 lod) { return lod == 0 ? mMeshList[idx].mIndexBuffer : mMeshList[idx].mLODs[lod - 1].mIndexBuffer; }
+   U32                       getLODTriangleCount(U32 idx, U32 lod) { return (lod == 0 ? mMeshList[idx].mIndexCount : mMeshList[idx].mLODs[lod - 1].mIndexCount) / 3; }
+   F32                       getLODError(U32 idx, U32 lod) { return lod == 0 ? 0.0f : mMeshList[idx].mLODs[lod - 1].mError; }
+
    /// Declare Console Object.
    DECLARE_CONOBJECT(MeshAsset);
 
    static U8 BinVersion;
+   static U8 LegacyBinVersion;
+   static const U32 BinMagic = 0x424D3654; // 'T6MB'
+   static const U32 BinAlignment = 16;
+
+   // LOD generation. Each level aims for half the triangles of the one 
+   // before it, without moving the surface further than MaxLODError.
+   static const U32 MaxLODs = 4;
+   static const U32 MinLODTriangles = 64;
+   static const F32 MaxLODError;
+
+   // Overdraw ordering may cost this much in vertex cache misses.
+   static const F32 OverdrawThreshold;
+
+   // Submeshes with more triangles than ClusterSplitTriangles are split into
+   // clusters of at most ClusterTriangles on import.
+   static const U32 ClusterSplitTriangles = 262144;
+   static const U32 ClusterTriangles = 32768;
 
 protected:
    virtual void initializeAsset( void );
    virtual void onAssetRefresh( void );
 
+   // Import Optimization.
+   void _splitClusters();
+   void _optimizeMeshes();
+   void _generateLODs();
+
+   // Binary Cache.
+   void _clearMeshList();
+   void _bindRawData();
+   void _adoptStaging();
+   bool _loadBinFile(const char* path);
+   bool _saveBinFile(const char* path);
+   bool _loadLegacyBinFile(const char* path);
+   bool _saveLegacyBinFile(const char* path);
+   void _appendBinAnimation(Vector<U8>& file, BinHeader& header);
+   bool _loadBinAnimation(const U8* data, const BinHeader& header);
+
    // Animation Functions.
-   U32 _readNodeHeirarchy(F64 AnimationTime, const aiNode* pNode, MatrixF ParentTransform, MatrixF GlobalInverseTransform, F32* transformsOut);
-   aiNodeAnim* _findNodeAnim(const aiAnimation* pAnimation, const char* nodeName);
-   void _calcInterpolatedRotation(aiQuaternion& Out, F64 AnimationTime, const aiNodeAnim* pNodeAnim);
-   U32 _findRotation(F64 AnimationTime, const aiNodeAnim* pNodeAnim);
-   void _calcInterpolatedScaling(aiVector3D& Out, F64 AnimationTime, const aiNodeAnim* pNodeAnim);
-   U32 _findScaling(F64 AnimationTime, const aiNodeAnim* pNodeAnim);
-   void _calcInterpolatedPosition(aiVector3D& Out, F64 AnimationTime, const aiNodeAnim* pNodeAnim);
-   U32 _findPosition(F64 AnimationTime, const aiNodeAnim* pNodeAnim);
+   void _compileAnimation();
+   U32 _getReferenceTransforms(F64 TimeInSeconds, F32* transformsOut);
+   void _importNodes(const aiNode* pNode, S32 parentIndex);
+   void _importAnimations(const aiScene* scene);
+   void _calcInterpolatedRotation(aiQuaternion& Out, F64 AnimationTime, const MeshNodeAnim* pNodeAnim);
+   U32 _findRotation(F64 AnimationTime, const MeshNodeAnim* pNodeAnim);
+   void _calcInterpolatedScaling(aiVector3D& Out, F64 AnimationTime, const MeshNodeAnim* pNodeAnim);
+   U32 _findScaling(F64 AnimationTime, const MeshNodeAnim* pNodeAnim);
+   void _calcInterpolatedPosition(aiVector3D& Out, F64 AnimationTime, const MeshNodeAnim* pNodeAnim);
+   U32 _findPosition(F64 AnimationTime, const MeshNodeAnim* pNodeAnim);
 
    static bool setMeshFile( void* obj, const char* data )                 { static_cast<MeshAsset*>(obj)->setMeshFile(data); return false; }
    static const char* getMeshFile(void* obj, const char* data)            { return static_cast<MeshAsset*>(obj)->getMeshFile(); }
@@ -24,7 +24,64 @@
 
 ConsoleMethodGroupBeginWithDocs(MeshAsset, AssetBase)
 
-// Nothing Yet
+/*! Compares cold and warm load times of the legacy and bulk binary caches for this mesh.
+    @param iterations Number of warm loads to average (default 10).
+    @return No return value.
+*/
+ConsoleMethodWithDocs( MeshAsset, benchmarkBin, ConsoleVoid, 2, 3, ([iterations]))
+{
+    U32 iterations = argc > 2 ? dAtoi(argv[2]) : 10;
+    object->benchmarkBin(iterations);
+}
+
+/*! Measures skeleton posing in bones per second for a crowd of characters using this mesh.
+    @param characters Number of characters to pose each frame (default 1000).
+    @param frames Number of frames to evaluate (default 60).
+    @return No return value.
+*/
+ConsoleMethodWithDocs( MeshAsset, benchmarkAnimation, ConsoleVoid, 2, 4, ([characters], [frames]))
+{
+    U32 characters = argc > 2 ? dAtoi(argv[2]) : 1000;
+    U32 frames = argc > 3 ? dAtoi(argv[3]) : 60;
+    object->benchmarkAnimation(characters, frames);
+}
+
+/*! Lists the LOD chain of a submesh, finest first.
+    @param subMesh Index of the submesh.
+    @return A space separated "triangles error" pair per level. Errors are relative to the size of the mesh.
+*/
+ConsoleMethodWithDocs( MeshAsset, getLODInfo, ConsoleString, 3, 3, (subMesh))
+{
+    U32 idx = dAtoi(argv[2]);
+    if ( !object->isLoaded() || idx >= object->getMeshCount() )
+       return "";
+
+    const U32 bufferSize = 256;
+    char* buffer = Con::getReturnBuffer(bufferSize);
+    buffer[0] = 0;
+
+    U32 length = 0;
+    for ( U32 n = 0; n < object->getLODCount(idx) && length < bufferSize; ++n )
+       length += dSprintf(buffer + length, bufferSize - length, n == 0 ? "%d %g" : " %d %g", object->getLODTriangleCount(idx, n), object->getLODError(idx, n));
+
+    return buffer;
+}
+
+/*! Moves this mesh to the front of the mesh loader queue.
+    @return No return value.
+*/
+ConsoleMethodWithDocs( MeshAsset, requestLoad, ConsoleVoid, 2, 2, ())
+{
+    MeshLoader::request(object);
+}
+
+/*! Returns true once the mesh data and its GPU buffers are ready.
+    @return Whether the mesh is loaded.
+*/
+ConsoleMethodWithDocs( MeshAsset, isLoaded, ConsoleBool, 2, 2, ())
+{
+    return object->isLoaded();
+}
 
 ConsoleMethodGroupEndWithDocs(MeshAsset)
 
@@ -43,4 +100,24 @@ extern "C"{
    {
       meshAsset->setMeshFile(val);
    }
+
+   DLL_PUBLIC void MeshAssetRequestLoad(MeshAsset* meshAsset)
+   {
+      MeshLoader::request(meshAsset);
+   }
+
+   DLL_PUBLIC bool MeshAssetIsLoaded(MeshAsset* meshAsset)
+   {
+      return meshAsset->isLoaded();
+   }
+
+   DLL_PUBLIC void MeshAssetBenchmarkBin(MeshAsset* meshAsset, U32 iterations)
+   {
+      meshAsset->benchmarkBin(iterations);
+   }
+
+   DLL_PUBLIC void MeshAssetBenchmarkAnimation(MeshAsset* meshAsset, U32 characters, U32 frames)
+   {
+      meshAsset->benchmarkAnimation(characters, frames);
+   }
 }
\ No newline at end of file
@@ -0,0 +1,488 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "platform/threads/thread.h"
+#include "platform/threads/semaphore.h"
+#include "platform/threads/mutex.h"
+#include "collection/vector.h"
+#include "console/console.h"
+#include "memory/safeDelete.h"
+#include "3d/scene/core.h"
+#include "3d/scene/camera.h"
+#include "meshAsset.h"
+#include "meshLoader.h"
+
+#include <bx/timer.h>
+
+// Script bindings.
+#include "meshLoader_Binding.h"
+
+namespace MeshLoader
+{
+   enum EntryState
+   {
+      Queued,
+      Loading,
+      Staged
+   };
+
+   struct Entry
+   {
+      MeshAsset*  asset;
+      U32         state;
+      U32         sequence;
+      bool        requested;
+      bool        hasPosition;
+      Point3F     position;
+   };
+
+   struct ListenerEntry
+   {
+      MeshAsset*  asset;
+      Listener*   listener;
+   };
+
+   class LoaderThread : public Thread
+   {
+      public:
+         LoaderThread() : Thread(0, 0, false) { }
+         virtual void run(void *arg = 0);
+   };
+
+   static Vector<LoaderThread*>  gThreads;
+   static Vector<Entry>          gEntries;
+   static Vector<ListenerEntry>  gListeners;
+   static Mutex*                 gMutex            = NULL;
+   static Semaphore*             gWorkSemaphore    = NULL;
+   static volatile bool          gShutdown         = false;
+   static Point3F                gCameraPosition(0.0f, 0.0f, 0.0f);
+   static bool                   gHasCamera        = false;
+   static U32                    gSequence         = 0;
+   static U32                    gLoadedCount      = 0;
+   static U32                    gTotalCount       = 0;
+   static F32                    gUploadBudget     = 2.0f;
+
+   // Everything below that touches gEntries expects gMutex to be held.
+   static S32 _findEntry(MeshAsset* asset)
+   {
+      for (S32 n = 0; n < gEntries.size(); ++n)
+      {
+         if ( gEntries[n].asset == asset )
+            return n;
+      }
+      return -1;
+   }
+
+   static U32 _getRank(const Entry& entry)
+   {
+      if ( entry.requested )
+         return 0;
+      if ( entry.hasPosition && gHasCamera )
+         return 1;
+      return 2;
+   }
+
+   // Requested meshes in the order they were asked for, then the closest
+   // placed mesh, then the rest in queue order. Distances are checked when a
+   // mesh is picked since the camera keeps moving while the queue drains.
+   static bool _isBefore(const Entry& a, const Entry& b)
+   {
+      U32 rankA = _getRank(a);
+      U32 rankB = _getRank(b);
+      if ( rankA != rankB )
+         return rankA < rankB;
+
+      if ( rankA == 1 )
+      {
+         F32 distA = (a.position - gCameraPosition).lenSquared();
+         F32 distB = (b.position - gCameraPosition).lenSquared();
+         if ( distA != distB )
+            return distA < distB;
+      }
+
+      return a.sequence < b.sequence;
+   }
+
+   static S32 _pickEntry(U32 state)
+   {
+      S32 best = -1;
+      for (S32 n = 0; n < gEntries.size(); ++n)
+      {
+         if ( gEntries[n].state != state )
+            continue;
+
+         if ( best < 0 || _isBefore(gEntries[n], gEntries[best]) )
+            best = n;
+      }
+      return best;
+   }
+
+   void LoaderThread::run(void *arg)
+   {
+      for (;;)
+      {
+         gWorkSemaphore->acquire();
+         if ( gShutdown )
+            break;
+
+         MeshAsset* asset = NULL;
+         {
+            MutexHandle mutex;
+            mutex.lock(gMutex, true);
+
+            // The mesh may have been cancelled since it was queued.
+            S32 idx = _pickEntry(Queued);
+            if ( idx < 0 )
+               continue;
+
+            gEntries[idx].state = Loading;
+            asset = gEntries[idx].asset;
+         }
+
+         // Cancelling waits for Loading entries so the asset stays alive.
+         asset->readMesh();
+
+         MutexHandle mutex;
+         mutex.lock(gMutex, true);
+         gEntries[_findEntry(asset)].state = Staged;
+      }
+   }
+
+   void init(U32 threadCount)
+   {
+      if ( gMutex != NULL )
+         return;
+
+      gShutdown      = false;
+      gMutex         = new Mutex();
+      gWorkSemaphore = new Semaphore(0);
+      gLoadedCount   = 0;
+      gTotalCount    = 0;
+
+      threadCount = getMax(threadCount, (U32)1);
+      for (U32 n = 0; n < threadCount; ++n)
+      {
+         LoaderThread* thread = new LoaderThread();
+         thread->start();
+         gThreads.push_back(thread);
+      }
+   }
+
+   void destroy()
+   {
+      if ( gMutex == NULL )
+         return;
+
+      // Loads in flight finish first, anything still queued is dropped.
+      gShutdown = true;
+      for (S32 n = 0; n < gThreads.size(); ++n)
+         gWorkSemaphore->release();
+
+      for (S32 n = 0; n < gThreads.size(); ++n)
+      {
+         gThreads[n]->join();
+         delete gThreads[n];
+      }
+      gThreads.clear();
+      gEntries.clear();
+      gListeners.clear();
+
+      SAFE_DELETE(gMutex);
+      SAFE_DELETE(gWorkSemaphore);
+   }
+
+   bool isRunning()
+   {
+      return gMutex != NULL;
+   }
+
+   void queue(MeshAsset* asset)
+   {
+      if ( gMutex == NULL )
+         return;
+
+      {
+         MutexHandle mutex;
+         mutex.lock(gMutex, true);
+         if ( _findEntry(asset) >= 0 )
+            return;
+
+         Entry entry;
+         entry.asset       = asset;
+         entry.state       = Queued;
+         entry.sequence    = gSequence++;
+         entry.requested   = false;
+         entry.hasPosition = false;
+         entry.position.set(0.0f, 0.0f, 0.0f);
+         gEntries.push_back(entry);
+         gTotalCount++;
+      }
+
+      gWorkSemaphore->release();
+   }
+
+   void request(MeshAsset* asset)
+   {
+      if ( gMutex == NULL )
+         return;
+
+      MutexHandle mutex;
+      mutex.lock(gMutex, true);
+      S32 idx = _findEntry(asset);
+      if ( idx < 0 || gEntries[idx].state != Queued || gEntries[idx].requested )
+         return;
+
+      gEntries[idx].requested = true;
+      gEntries[idx].sequence  = gSequence++;
+   }
+
+   // A mesh used in several places loads as early as its closest user needs it.
+   void setLoadPosition(MeshAsset* asset, const Point3F& position)
+   {
+      if ( gMutex == NULL )
+         return;
+
+      MutexHandle mutex;
+      mutex.lock(gMutex, true);
+      S32 idx = _findEntry(asset);
+      if ( idx < 0 )
+         return;
+
+      Entry* entry = &gEntries[idx];
+      if ( !entry->hasPosition || (position - gCameraPosition).lenSquared() < (entry->position - gCameraPosition).lenSquared() )
+      {
+         entry->position    = position;
+         entry->hasPosition = true;
+      }
+   }
+
+   void cancel(MeshAsset* asset)
+   {
+      if ( gMutex == NULL )
+         return;
+
+      for (;;)
+      {
+         {
+            MutexHandle mutex;
+            mutex.lock(gMutex, true);
+            S32 idx = _findEntry(asset);
+            if ( idx < 0 )
+               break;
+
+            if ( gEntries[idx].state != Loading )
+            {
+               gEntries.erase_fast(idx);
+               gTotalCount--;
+               break;
+            }
+         }
+
+         // A worker is reading it, wait for it to finish.
+         Platform::sleep(1);
+      }
+
+      for (S32 n = 0; n < gListeners.size(); )
+      {
+         if ( gListeners[n].asset == asset )
+            gListeners.erase_fast(n);
+         else
+            ++n;
+      }
+   }
+
+   void addListener(MeshAsset* asset, Listener* listener)
+   {
+      ListenerEntry entry;
+      entry.asset    = asset;
+      entry.listener = listener;
+      gListeners.push_back(entry);
+   }
+
+   void removeListener(Listener* listener)
+   {
+      for (S32 n = 0; n < gListeners.size(); )
+      {
+         if ( gListeners[n].listener == listener )
+            gListeners.erase_fast(n);
+         else
+            ++n;
+      }
+   }
+
+   // Listeners can add or remove others from their callback, so the search
+   // starts over after each one.
+   static void _notifyListeners(MeshAsset* asset)
+   {
+      for (S32 n = 0; n < gListeners.size(); )
+      {
+         if ( gListeners[n].asset != asset )
+         {
+            ++n;
+            continue;
+         }
+
+         Listener* listener = gListeners[n].listener;
+         gListeners.erase(n);
+         listener->onMeshLoaded(asset);
+         n = 0;
+      }
+   }
+
+   // Creates GPU buffers for staged meshes until the budget runs out. At 
+   // least one mesh goes up per call so the queue always drains.
+   static void _uploadStaged(bool limitTime)
+   {
+      U64 startTime = bx::getHPCounter();
+      F64 ticksPerMS = bx::getHPFrequency() / 1000.0;
+
+      for (;;)
+      {
+         MeshAsset* asset = NULL;
+         {
+            MutexHandle mutex;
+            mutex.lock(gMutex, true);
+            S32 idx = _pickEntry(Staged);
+            if ( idx < 0 )
+               break;
+
+            asset = gEntries[idx].asset;
+            gEntries.erase_fast(idx);
+         }
+
+         asset->uploadMesh();
+         gLoadedCount++;
+         _notifyListeners(asset);
+
+         if ( limitTime && (bx::getHPCounter() - startTime) / ticksPerMS >= gUploadBudget )
+            break;
+      }
+   }
+
+   void update()
+   {
+      if ( gMutex == NULL )
+         return;
+
+      Scene::SceneCamera* camera = Scene::getActiveCamera();
+      {
+         MutexHandle mutex;
+         mutex.lock(gMutex, true);
+         gHasCamera = (camera != NULL);
+         if ( camera != NULL )
+            gCameraPosition = camera->getPosition();
+      }
+
+      _uploadStaged(true);
+   }
+
+   // Blocks until everything queued so far is loaded, loading screens and 
+   // tools use this.
+   void finish()
+   {
+      if ( gMutex == NULL )
+         return;
+
+      for (;;)
+      {
+         _uploadStaged(false);
+
+         {
+            MutexHandle mutex;
+            mutex.lock(gMutex, true);
+            if ( gEntries.size() == 0 )
+               break;
+         }
+
+         Platform::sleep(1);
+      }
+   }
+
+   // Blocks until one mesh is loaded. It's requested first so the workers
+   // take it next, anything else staged by then goes up along with it.
+   void wait(MeshAsset* asset)
+   {
+      if ( gMutex == NULL )
+         return;
+
+      request(asset);
+      for (;;)
+      {
+         _uploadStaged(false);
+
+         {
+            MutexHandle mutex;
+            mutex.lock(gMutex, true);
+            if ( _findEntry(asset) < 0 )
+               break;
+         }
+
+         Platform::sleep(1);
+      }
+   }
+
+   void setUploadBudget(F32 milliseconds)
+   {
+      gUploadBudget = getMax(milliseconds, 0.0f);
+   }
+
+   F32 getUploadBudget()
+   {
+      return gUploadBudget;
+   }
+
+   LoadStats getStats()
+   {
+      LoadStats stats;
+      stats.queued   = 0;
+      stats.loading  = 0;
+      stats.staged   = 0;
+      stats.loaded   = gLoadedCount;
+      stats.total    = gTotalCount;
+
+      if ( gMutex == NULL )
+         return stats;
+
+      MutexHandle mutex;
+      mutex.lock(gMutex, true);
+      for (S32 n = 0; n < gEntries.size(); ++n)
+      {
+         switch ( gEntries[n].state )
+         {
+            case Queued:   stats.queued++;   break;
+            case Loading:  stats.loading++;  break;
+            case Staged:   stats.staged++;   break;
+         }
+      }
+
+      return stats;
+   }
+
+   F32 getProgress()
+   {
+      if ( gTotalCount == 0 )
+         return 1.0f;
+
+      return (F32)gLoadedCount / (F32)gTotalCount;
+   }
+}
@@ -0,0 +1,95 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _MESH_LOADER_H_
+#define _MESH_LOADER_H_
+
+#ifndef _TORQUE_TYPES_H_
+#include "platform/types.h"
+#endif
+
+#ifndef _MPOINT_H_
+#include "math/mPoint.h"
+#endif
+
+class MeshAsset;
+
+// ------------------------------------------------------------------------------
+//  Mesh Loader
+// ------------------------------------------------------------------------------
+//
+//   A fixed set of threads that read mesh assets from their binary cache (or
+//   import them) in the background. Workers always take explicitly requested
+//   meshes first, then whichever mesh is closest to the camera. Meshes nobody
+//   has placed in the world yet go last.
+//
+//   Finished meshes are staged until update() creates their GPU buffers on
+//   the main thread, spending at most the upload budget per frame. Listeners
+//   are told once a mesh is ready.
+//
+//   Everything except the worker side of the queue is main thread only.
+//
+// ------------------------------------------------------------------------------
+
+namespace MeshLoader
+{
+   class Listener
+   {
+      public:
+         virtual void onMeshLoaded(MeshAsset* asset) = 0;
+   };
+
+   struct LoadStats
+   {
+      U32 queued;       // Waiting for a worker.
+      U32 loading;      // Being read by a worker.
+      U32 staged;       // Waiting for GPU buffers.
+      U32 loaded;       // Finished since init.
+      U32 total;        // Queued since init.
+   };
+
+   void init(U32 threadCount);
+   void destroy();
+   bool isRunning();
+
+   // Queue Control
+   void queue(MeshAsset* asset);
+   void request(MeshAsset* asset);
+   void setLoadPosition(MeshAsset* asset, const Point3F& position);
+   void cancel(MeshAsset* asset);
+   void finish();
+   void wait(MeshAsset* asset);
+
+   // Listeners stay registered until the mesh loads or they're removed.
+   void addListener(MeshAsset* asset, Listener* listener);
+   void removeListener(Listener* listener);
+
+   // Called once per frame.
+   void update();
+
+   void  setUploadBudget(F32 milliseconds);
+   F32   getUploadBudget();
+   LoadStats getStats();
+   F32   getProgress();
+}
+
+#endif // _MESH_LOADER_H_
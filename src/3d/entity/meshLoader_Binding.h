@@ -0,0 +1,106 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _CONSOLE_H_
+#include "console/console.h"
+#endif
+
+#ifndef _MESH_LOADER_H_
+#include "meshLoader.h"
+#endif
+
+#include "c-interface/c-interface.h"
+
+ConsoleNamespaceFunction( MeshLoader, getQueueDepth, ConsoleInt, 1, 1, ("Returns the number of meshes that are queued, loading or waiting for their GPU buffers."))
+{
+   MeshLoader::LoadStats stats = MeshLoader::getStats();
+   return stats.queued + stats.loading + stats.staged;
+}
+
+ConsoleNamespaceFunction( MeshLoader, getProgress, ConsoleFloat, 1, 1, ("Returns the fraction of queued meshes that have finished loading, 1 when idle."))
+{
+   return MeshLoader::getProgress();
+}
+
+ConsoleNamespaceFunction( MeshLoader, getStats, ConsoleString, 1, 1, ("Returns \"queued loading staged loaded total\" mesh counts."))
+{
+   MeshLoader::LoadStats stats = MeshLoader::getStats();
+
+   char* buffer = Con::getReturnBuffer(64);
+   dSprintf(buffer, 64, "%d %d %d %d %d", stats.queued, stats.loading, stats.staged, stats.loaded, stats.total);
+   return buffer;
+}
+
+ConsoleNamespaceFunction( MeshLoader, setUploadBudget, ConsoleVoid, 2, 2, ("(milliseconds) Sets the time spent creating mesh GPU buffers each frame."))
+{
+   MeshLoader::setUploadBudget(dAtof(argv[1]));
+}
+
+ConsoleNamespaceFunction( MeshLoader, getUploadBudget, ConsoleFloat, 1, 1, ("Returns the time spent creating mesh GPU buffers each frame in milliseconds."))
+{
+   return MeshLoader::getUploadBudget();
+}
+
+ConsoleNamespaceFunction( MeshLoader, finish, ConsoleVoid, 1, 1, ("Blocks until every queued mesh is loaded."))
+{
+   MeshLoader::finish();
+}
+
+namespace MeshLoader{
+   extern "C" {
+      DLL_PUBLIC U32 MeshLoader_GetQueueDepth()
+      {
+         MeshLoader::LoadStats stats = MeshLoader::getStats();
+         return stats.queued + stats.loading + stats.staged;
+      }
+
+      DLL_PUBLIC F32 MeshLoader_GetProgress()
+      {
+         return MeshLoader::getProgress();
+      }
+
+      DLL_PUBLIC void MeshLoader_GetStats(U32* queued, U32* loading, U32* staged, U32* loaded, U32* total)
+      {
+         MeshLoader::LoadStats stats = MeshLoader::getStats();
+         *queued  = stats.queued;
+         *loading = stats.loading;
+         *staged  = stats.staged;
+         *loaded  = stats.loaded;
+         *total   = stats.total;
+      }
+
+      DLL_PUBLIC void MeshLoader_SetUploadBudget(F32 milliseconds)
+      {
+         MeshLoader::setUploadBudget(milliseconds);
+      }
+
+      DLL_PUBLIC F32 MeshLoader_GetUploadBudget()
+      {
+         return MeshLoader::getUploadBudget();
+      }
+
+      DLL_PUBLIC void MeshLoader_Finish()
+      {
+         MeshLoader::finish();
+      }
+   }
+}
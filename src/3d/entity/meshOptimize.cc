@@ -0,0 +1,447 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "meshOptimize.h"
+#include "collection/vector.h"
+#include "math/mMathFn.h"
+
+//-----------------------------------------------------------------------------
+// Vertex Cache
+//-----------------------------------------------------------------------------
+
+// Scoring constants from Forsyth's paper. The three most recent vertices
+// get a flat score so the next triangle doesn't favour one strip direction.
+static const F32 CacheDecayPower    = 1.5f;
+static const F32 LastTriangleScore  = 0.75f;
+static const F32 ValenceBoostScale  = 2.0f;
+static const F32 ValenceBoostPower  = 0.5f;
+static const U32 MaxValenceScore    = 64;
+
+static F32 gCacheScores[MeshVertexCacheSize];
+static F32 gValenceScores[MaxValenceScore];
+static bool gScoreTablesReady = false;
+
+static void initScoreTables()
+{
+   if ( gScoreTablesReady )
+      return;
+
+   for ( U32 n = 0; n < MeshVertexCacheSize; ++n )
+   {
+      if ( n < 3 )
+         gCacheScores[n] = LastTriangleScore;
+      else
+         gCacheScores[n] = mPow(1.0f - (F32)(n - 3) / (F32)(MeshVertexCacheSize - 3), CacheDecayPower);
+   }
+
+   gValenceScores[0] = 0.0f;
+   for ( U32 n = 1; n < MaxValenceScore; ++n )
+      gValenceScores[n] = ValenceBoostScale * mPow((F32)n, -ValenceBoostPower);
+
+   gScoreTablesReady = true;
+}
+
+// Vertices with fewer triangles left score higher so lone triangles get
+// picked up before they're stranded.
+static F32 getVertexScore(S32 cachePosition, U32 remaining)
+{
+   if ( remaining == 0 )
+      return -1.0f;
+
+   F32 score = cachePosition >= 0 ? gCacheScores[cachePosition] : 0.0f;
+   if ( remaining < MaxValenceScore )
+      score += gValenceScores[remaining];
+   else
+      score += ValenceBoostScale * mPow((F32)remaining, -ValenceBoostPower);
+
+   return score;
+}
+
+void optimizeVertexCache(U32* indicesOut, const U32* indices, U32 indexCount, U32 vertexCount)
+{
+   initScoreTables();
+
+   U32 triCount = indexCount / 3;
+   if ( triCount == 0 || vertexCount == 0 )
+      return;
+
+   // Vertex to triangle adjacency. The first remaining[v] entries of each 
+   // vertex are the triangles it still has to emit.
+   Vector<U32> offsets;
+   Vector<U32> remaining;
+   Vector<U32> adjacency;
+   offsets.setSize(vertexCount + 1);
+   remaining.setSize(vertexCount);
+   adjacency.setSize(triCount * 3);
+   dMemset(remaining.address(), 0, vertexCount * sizeof(U32));
+
+   for ( U32 i = 0; i < triCount * 3; ++i )
+      remaining[indices[i]]++;
+
+   offsets[0] = 0;
+   for ( U32 v = 0; v < vertexCount; ++v )
+      offsets[v + 1] = offsets[v] + remaining[v];
+
+   dMemset(remaining.address(), 0, vertexCount * sizeof(U32));
+   for ( U32 i = 0; i < triCount * 3; ++i )
+   {
+      U32 v = indices[i];
+      adjacency[offsets[v] + remaining[v]] = i / 3;
+      remaining[v]++;
+   }
+
+   Vector<S32> cachePositions;
+   Vector<F32> vertexScores;
+   Vector<F32> triangleScores;
+   Vector<U8> emitted;
+   cachePositions.setSize(vertexCount);
+   vertexScores.setSize(vertexCount);
+   triangleScores.setSize(triCount);
+   emitted.setSize(triCount);
+   dMemset(emitted.address(), 0, triCount);
+
+   for ( U32 v = 0; v < vertexCount; ++v )
+   {
+      cachePositions[v] = -1;
+      vertexScores[v] = getVertexScore(-1, remaining[v]);
+   }
+
+   S32 best = -1;
+   F32 bestScore = -1.0f;
+   for ( U32 t = 0; t < triCount; ++t )
+   {
+      triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+      if ( triangleScores[t] > bestScore )
+      {
+         best = t;
+         bestScore = triangleScores[t];
+      }
+   }
+
+   U32 cache[MeshVertexCacheSize + 3];
+   U32 newCache[MeshVertexCacheSize + 3];
+   U32 cacheCount = 0;
+   U32 cursor = 0;
+
+   for ( U32 n = 0; n < triCount; ++n )
+   {
+      // Nothing left around the cache, carry on from the next triangle in
+      // source order.
+      if ( best < 0 )
+      {
+         while ( emitted[cursor] )
+            cursor++;
+         best = cursor;
+      }
+
+      const U32* tri = &indices[best * 3];
+      indicesOut[n * 3 + 0] = tri[0];
+      indicesOut[n * 3 + 1] = tri[1];
+      indicesOut[n * 3 + 2] = tri[2];
+      emitted[best] = 1;
+
+      // Drop the triangle from its vertices and push them to the front of
+      // the cache.
+      U32 newCount = 0;
+      for ( U32 k = 0; k < 3; ++k )
+      {
+         U32 v = tri[k];
+         U32* list = &adjacency[offsets[v]];
+         for ( U32 i = 0; i < remaining[v]; ++i )
+         {
+            if ( list[i] == (U32)best )
+            {
+               list[i] = list[remaining[v] - 1];
+               break;
+            }
+         }
+         remaining[v]--;
+         newCache[newCount++] = v;
+      }
+
+      for ( U32 i = 0; i < cacheCount; ++i )
+      {
+         U32 v = cache[i];
+         if ( v != tri[0] && v != tri[1] && v != tri[2] )
+            newCache[newCount++] = v;
+      }
+
+      // Rescore everything that moved in or out of the cache.
+      for ( U32 i = 0; i < newCount; ++i )
+      {
+         U32 v = newCache[i];
+         cachePositions[v] = i < MeshVertexCacheSize ? (S32)i : -1;
+         vertexScores[v] = getVertexScore(cachePositions[v], remaining[v]);
+      }
+
+      best = -1;
+      bestScore = -1.0f;
+      for ( U32 i = 0; i < newCount; ++i )
+      {
+         U32 v = newCache[i];
+         const U32* list = &adjacency[offsets[v]];
+         for ( U32 j = 0; j < remaining[v]; ++j )
+         {
+            U32 t = list[j];
+            triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+            if ( triangleScores[t] > bestScore )
+            {
+               best = t;
+               bestScore = triangleScores[t];
+            }
+         }
+      }
+
+      cacheCount = getMin(newCount, MeshVertexCacheSize);
+      dMemcpy(cache, newCache, cacheCount * sizeof(U32));
+   }
+}
+
+//-----------------------------------------------------------------------------
+// Overdraw
+//-----------------------------------------------------------------------------
+
+// FIFO cache simulation. A vertex is a hit while fewer than cacheSize 
+// misses have happened since it was loaded. Bumping time by more than 
+// cacheSize flushes the cache.
+struct CacheSimulator
+{
+   Vector<U32> timestamps;
+   U32         time;
+   U32         size;
+
+   void init(U32 vertexCount, U32 cacheSize)
+   {
+      timestamps.setSize(vertexCount);
+      dMemset(timestamps.address(), 0, vertexCount * sizeof(U32));
+      size = cacheSize;
+      time = cacheSize + 1;
+   }
+
+   void flush()
+   {
+      time += size + 1;
+   }
+
+   U32 addTriangle(const U32* tri)
+   {
+      U32 misses = 0;
+      for ( U32 k = 0; k < 3; ++k )
+      {
+         if ( time - timestamps[tri[k]] > size )
+         {
+            timestamps[tri[k]] = time++;
+            misses++;
+         }
+      }
+      return misses;
+   }
+};
+
+struct ClusterSort
+{
+   F32 key;
+   U32 cluster;
+};
+
+static S32 QSORT_CALLBACK compareClusters(const void* a, const void* b)
+{
+   const ClusterSort* clusterA = (const ClusterSort*)a;
+   const ClusterSort* clusterB = (const ClusterSort*)b;
+
+   // Highest key first, source order breaks ties.
+   if ( clusterA->key != clusterB->key )
+      return (clusterA->key > clusterB->key) ? -1 : 1;
+   return (clusterA->cluster < clusterB->cluster) ? -1 : ((clusterA->cluster > clusterB->cluster) ? 1 : 0);
+}
+
+void optimizeOverdraw(U32* indices, U32 indexCount, const F32* positions, U32 vertexCount, U32 vertexStride, F32 threshold)
+{
+   U32 triCount = indexCount / 3;
+   if ( triCount < 2 || vertexCount == 0 )
+      return;
+
+   // Hard boundaries sit where the cache ordering had to start over, a 
+   // triangle that misses on all three vertices.
+   CacheSimulator cache;
+   cache.init(vertexCount, MeshVertexCacheSize);
+
+   Vector<U32> hardClusters;
+   for ( U32 t = 0; t < triCount; ++t )
+   {
+      if ( cache.addTriangle(&indices[t * 3]) == 3 || t == 0 )
+         hardClusters.push_back(t);
+   }
+   hardClusters.push_back(triCount);
+
+   // Soft boundaries split each hard cluster wherever the part so far is 
+   // about as cache friendly as the whole cluster. Every cluster starts 
+   // with a cold cache since it can end up anywhere in the order.
+   Vector<U32> clusters;
+   for ( S32 c = 0; c + 1 < hardClusters.size(); ++c )
+   {
+      U32 start = hardClusters[c];
+      U32 end = hardClusters[c + 1];
+
+      cache.flush();
+      U32 clusterMisses = 0;
+      for ( U32 t = start; t < end; ++t )
+         clusterMisses += cache.addTriangle(&indices[t * 3]);
+      F32 clusterThreshold = threshold * (F32)clusterMisses / (F32)(end - start);
+
+      cache.flush();
+      clusters.push_back(start);
+      U32 softStart = start;
+      U32 misses = 0;
+      for ( U32 t = start; t < end; ++t )
+      {
+         misses += cache.addTriangle(&indices[t * 3]);
+         if ( t + 1 < end && (F32)misses / (F32)(t + 1 - softStart) <= clusterThreshold )
+         {
+            clusters.push_back(t + 1);
+            softStart = t + 1;
+            misses = 0;
+            cache.flush();
+         }
+      }
+   }
+   clusters.push_back(triCount);
+
+   // Each cluster is keyed by how far its area weighted centroid sits out
+   // along its average normal from the centre of the mesh. Clusters on the
+   // outside facing out are drawn first.
+   const U8* vertexData = (const U8*)positions;
+   U32 clusterCount = clusters.size() - 1;
+   Vector<F32> centroids;
+   Vector<F32> normals;
+   centroids.setSize(clusterCount * 3);
+   normals.setSize(clusterCount * 3);
+   dMemset(centroids.address(), 0, clusterCount * 3 * sizeof(F32));
+   dMemset(normals.address(), 0, clusterCount * 3 * sizeof(F32));
+
+   F32 meshCentroid[3] = { 0.0f, 0.0f, 0.0f };
+   F32 meshArea = 0.0f;
+
+   for ( U32 c = 0; c < clusterCount; ++c )
+   {
+      F32* centroid = &centroids[c * 3];
+      F32* normal = &normals[c * 3];
+      F32 clusterArea = 0.0f;
+
+      for ( U32 t = clusters[c]; t < clusters[c + 1]; ++t )
+      {
+         const F32* p0 = (const F32*)(vertexData + indices[t * 3 + 0] * vertexStride);
+         const F32* p1 = (const F32*)(vertexData + indices[t * 3 + 1] * vertexStride);
+         const F32* p2 = (const F32*)(vertexData + indices[t * 3 + 2] * vertexStride);
+
+         F32 e0[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+         F32 e1[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+         F32 n[3] = { e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0] };
+         F32 area = mSqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+         for ( U32 k = 0; k < 3; ++k )
+         {
+            centroid[k] += (p0[k] + p1[k] + p2[k]) * (area / 3.0f);
+            normal[k] += n[k];
+         }
+         clusterArea += area;
+      }
+
+      for ( U32 k = 0; k < 3; ++k )
+         meshCentroid[k] += centroid[k];
+      meshArea += clusterArea;
+
+      F32 invArea = clusterArea > 0.0f ? 1.0f / clusterArea : 0.0f;
+      for ( U32 k = 0; k < 3; ++k )
+         centroid[k] *= invArea;
+   }
+
+   F32 invMeshArea = meshArea > 0.0f ? 1.0f / meshArea : 0.0f;
+   for ( U32 k = 0; k < 3; ++k )
+      meshCentroid[k] *= invMeshArea;
+
+   Vector<ClusterSort> order;
+   order.setSize(clusterCount);
+   for ( U32 c = 0; c < clusterCount; ++c )
+   {
+      const F32* centroid = &centroids[c * 3];
+      const F32* normal = &normals[c * 3];
+      F32 length = mSqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+      F32 invLength = length > 0.0f ? 1.0f / length : 0.0f;
+
+      order[c].cluster = c;
+      order[c].key = ((centroid[0] - meshCentroid[0]) * normal[0]
+                    + (centroid[1] - meshCentroid[1]) * normal[1]
+                    + (centroid[2] - meshCentroid[2]) * normal[2]) * invLength;
+   }
+
+   dQsort(order.address(), clusterCount, sizeof(ClusterSort), compareClusters);
+
+   Vector<U32> sorted;
+   sorted.setSize(triCount * 3);
+   U32 count = 0;
+   for ( U32 c = 0; c < clusterCount; ++c )
+   {
+      U32 cluster = order[c].cluster;
+      U32 first = clusters[cluster] * 3;
+      U32 size = (clusters[cluster + 1] - clusters[cluster]) * 3;
+      dMemcpy(&sorted[count], &indices[first], size * sizeof(U32));
+      count += size;
+   }
+
+   dMemcpy(indices, sorted.address(), count * sizeof(U32));
+}
+
+//-----------------------------------------------------------------------------
+// Vertex Fetch
+//-----------------------------------------------------------------------------
+
+U32 optimizeVertexFetchRemap(U32* remap, const U32* indices, U32 indexCount, U32 vertexCount)
+{
+   dMemset(remap, 0xff, vertexCount * sizeof(U32));
+
+   U32 next = 0;
+   for ( U32 i = 0; i < indexCount; ++i )
+   {
+      U32 v = indices[i];
+      if ( remap[v] == 0xffffffff )
+         remap[v] = next++;
+   }
+
+   return next;
+}
+
+F32 getCacheMissRatio(const U32* indices, U32 indexCount, U32 vertexCount, U32 cacheSize)
+{
+   U32 triCount = indexCount / 3;
+   if ( triCount == 0 || vertexCount == 0 )
+      return 0.0f;
+
+   CacheSimulator cache;
+   cache.init(vertexCount, cacheSize);
+
+   U32 misses = 0;
+   for ( U32 t = 0; t < triCount; ++t )
+      misses += cache.addTriangle(&indices[t * 3]);
+
+   return (F32)misses / (F32)triCount;
+}
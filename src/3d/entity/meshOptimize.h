@@ -0,0 +1,58 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _MESH_OPTIMIZE_H_
+#define _MESH_OPTIMIZE_H_
+
+#ifndef _PLATFORM_H_
+#include "platform/platform.h"
+#endif
+
+// Index and vertex order optimizations run on import. All of them work on
+// triangle lists and only reorder, the rendered result is unchanged.
+
+// Size of the post-transform cache the orderings are tuned for.
+const U32 MeshVertexCacheSize = 32;
+
+// Reorders triangles so vertices are reused while they're still in the 
+// post-transform cache (Forsyth, "Linear-Speed Vertex Cache Optimisation").
+// indicesOut and indices must not overlap.
+void optimizeVertexCache(U32* indicesOut, const U32* indices, U32 indexCount, U32 vertexCount);
+
+// Reorders clusters of a cache optimized list so the outward facing parts 
+// of the mesh are drawn first and occlude the rest (Sander et al, "Fast 
+// Triangle Reordering for Vertex Locality and Reduced Overdraw"). Clusters
+// are only split where it costs at most threshold times the cache misses,
+// 1.05 keeps nearly all of the vertex cache win. Works in place.
+void optimizeOverdraw(U32* indices, U32 indexCount, const F32* positions, U32 vertexCount, U32 vertexStride, F32 threshold);
+
+// Builds a remap table that numbers vertices in the order the indices first
+// use them, so vertex fetch walks memory forwards. Unused vertices map to
+// 0xffffffff. Returns the number of vertices still in use.
+U32 optimizeVertexFetchRemap(U32* remap, const U32* indices, U32 indexCount, U32 vertexCount);
+
+// Average cache misses per triangle (ACMR) of an index list with a FIFO
+// cache of cacheSize entries. 3 is the worst case, 0.5 is about the best a 
+// regular grid can do.
+F32 getCacheMissRatio(const U32* indices, U32 indexCount, U32 vertexCount, U32 cacheSize);
+
+#endif // _MESH_OPTIMIZE_H_
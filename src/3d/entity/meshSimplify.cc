@@ -0,0 +1,479 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "meshSimplify.h"
+#include "collection/vector.h"
+#include "math/mMathFn.h"
+
+//-----------------------------------------------------------------------------
+// Helpers
+//-----------------------------------------------------------------------------
+
+enum VertexKind
+{
+   ManifoldVertex,   // Free to collapse onto any neighbour.
+   BorderVertex,     // On an open border, only collapses along the border.
+   LockedVertex      // Shares its position with another vertex (or sits on a
+                     // locked border), never moves.
+};
+
+// Symmetric 4x4 error quadric (upper triangle) plus the total weight that
+// went into it, so errors come out as a mean squared distance.
+struct Quadric
+{
+   F64 a00, a01, a02, a03;
+   F64 a11, a12, a13;
+   F64 a22, a23;
+   F64 a33;
+   F64 weight;
+};
+
+static void addPlaneQuadric(Quadric* q, F64 nx, F64 ny, F64 nz, F64 d, F64 w)
+{
+   q->a00 += w * nx * nx; q->a01 += w * nx * ny; q->a02 += w * nx * nz; q->a03 += w * nx * d;
+   q->a11 += w * ny * ny; q->a12 += w * ny * nz; q->a13 += w * ny * d;
+   q->a22 += w * nz * nz; q->a23 += w * nz * d;
+   q->a33 += w * d * d;
+   q->weight += w;
+}
+
+static void addQuadric(Quadric* q, const Quadric& r)
+{
+   q->a00 += r.a00; q->a01 += r.a01; q->a02 += r.a02; q->a03 += r.a03;
+   q->a11 += r.a11; q->a12 += r.a12; q->a13 += r.a13;
+   q->a22 += r.a22; q->a23 += r.a23;
+   q->a33 += r.a33;
+   q->weight += r.weight;
+}
+
+static F32 evalQuadric(const Quadric& q, const F32* p)
+{
+   const F64 x = p[0], y = p[1], z = p[2];
+   F64 error = q.a00 * x * x + 2.0 * q.a01 * x * y + 2.0 * q.a02 * x * z + 2.0 * q.a03 * x
+             + q.a11 * y * y + 2.0 * q.a12 * y * z + 2.0 * q.a13 * y
+             + q.a22 * z * z + 2.0 * q.a23 * z
+             + q.a33;
+
+   // Rounding can push a zero error slightly negative.
+   return error > 0.0 ? (F32)(q.weight > 0.0 ? error / q.weight : error) : 0.0f;
+}
+
+static void triangleNormal(F32* out, const F32* p0, const F32* p1, const F32* p2)
+{
+   const F32 e0[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+   const F32 e1[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+   out[0] = e0[1] * e1[2] - e0[2] * e1[1];
+   out[1] = e0[2] * e1[0] - e0[0] * e1[2];
+   out[2] = e0[0] * e1[1] - e0[1] * e1[0];
+}
+
+static U32 hashU32(U32 key)
+{
+   key ^= key >> 16;
+   key *= 0x7feb352d;
+   key ^= key >> 15;
+   key *= 0x846ca68b;
+   key ^= key >> 16;
+   return key;
+}
+
+// Open addressing set of directed edges keyed (from << 32) | to. A key
+// with both halves equal is never a valid edge so it marks empty slots.
+class EdgeSet
+{
+   static const U64 Empty = 0xffffffffffffffffULL;
+
+   Vector<U64> mKeys;
+   U32         mMask;
+
+   static U32 hashKey(U64 key)
+   {
+      return hashU32((U32)key ^ hashU32((U32)(key >> 32)));
+   }
+
+public:
+   void init(U32 edgeCount)
+   {
+      U32 size = getNextPow2(getMax(edgeCount * 2, (U32)16));
+      mKeys.setSize(size);
+      dMemset(mKeys.address(), 0xff, size * sizeof(U64));
+      mMask = size - 1;
+   }
+
+   void insert(U32 from, U32 to)
+   {
+      U64 key = ((U64)from << 32) | to;
+      U32 slot = hashKey(key) & mMask;
+      while ( mKeys[slot] != Empty && mKeys[slot] != key )
+         slot = (slot + 1) & mMask;
+      mKeys[slot] = key;
+   }
+
+   bool contains(U32 from, U32 to) const
+   {
+      U64 key = ((U64)from << 32) | to;
+      U32 slot = hashKey(key) & mMask;
+      while ( mKeys[slot] != Empty )
+      {
+         if ( mKeys[slot] == key )
+            return true;
+         slot = (slot + 1) & mMask;
+      }
+      return false;
+   }
+};
+
+struct Collapse
+{
+   F32 cost;
+   U32 from;
+   U32 to;
+};
+
+static S32 QSORT_CALLBACK compareCollapses(const void* a, const void* b)
+{
+   F32 costA = ((const Collapse*)a)->cost;
+   F32 costB = ((const Collapse*)b)->cost;
+   return (costA < costB) ? -1 : ((costA > costB) ? 1 : 0);
+}
+
+// Vertices that share a position with another vertex sit on a UV or normal
+// seam. Collapsing one side of a seam without the other would tear the 
+// mesh open, so both sides are locked.
+static void lockSeams(U8* kinds, const U8* positions, U32 vertexCount, U32 vertexStride)
+{
+   const U32 Empty = 0xffffffff;
+   U32 size = getNextPow2(getMax(vertexCount * 2, (U32)16));
+   Vector<U32> table;
+   table.setSize(size);
+   dMemset(table.address(), 0xff, size * sizeof(U32));
+
+   for ( U32 v = 0; v < vertexCount; ++v )
+   {
+      const U32* bits = (const U32*)(positions + v * vertexStride);
+      U32 slot = hashU32(bits[0] ^ hashU32(bits[1] ^ hashU32(bits[2]))) & (size - 1);
+
+      bool shared = false;
+      while ( table[slot] != Empty )
+      {
+         const U32* other = (const U32*)(positions + table[slot] * vertexStride);
+         if ( dMemcmp(bits, other, sizeof(F32) * 3) == 0 )
+         {
+            kinds[v] = LockedVertex;
+            kinds[table[slot]] = LockedVertex;
+            shared = true;
+            break;
+         }
+         slot = (slot + 1) & (size - 1);
+      }
+
+      if ( !shared )
+         table[slot] = v;
+   }
+}
+
+// Moving from onto to must not turn any of the surviving triangles around 
+// from it. Corners are resolved through remap so collapses made earlier in
+// the same pass are taken into account.
+static bool collapseFlips(const F32* points, const U32* indices, const U32* tris, U32 triCount, const U32* remap, U32 from, U32 to)
+{
+   for ( U32 t = 0; t < triCount; ++t )
+   {
+      U32 v[3] = { remap[indices[tris[t] * 3 + 0]], remap[indices[tris[t] * 3 + 1]], remap[indices[tris[t] * 3 + 2]] };
+
+      // Triangles holding both ends disappear, degenerate ones already have.
+      if ( v[0] == to || v[1] == to || v[2] == to )
+         continue;
+      if ( v[0] == v[1] || v[1] == v[2] || v[0] == v[2] )
+         continue;
+
+      F32 before[3];
+      triangleNormal(before, &points[v[0] * 3], &points[v[1] * 3], &points[v[2] * 3]);
+
+      const F32* p[3];
+      for ( U32 k = 0; k < 3; ++k )
+         p[k] = &points[(v[k] == from ? to : v[k]) * 3];
+
+      F32 after[3];
+      triangleNormal(after, p[0], p[1], p[2]);
+
+      if ( before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0.0f )
+         return true;
+   }
+
+   return false;
+}
+
+//-----------------------------------------------------------------------------
+
+U32 simplifyMesh(U32* indicesOut, const U32* indices, U32 indexCount, 
+   const F32* positions, U32 vertexCount, U32 vertexStride, 
+   U32 targetIndexCount, F32 targetError, F32* errorOut, bool lockBorders)
+{
+   if ( errorOut != NULL )
+      *errorOut = 0.0f;
+
+   // Start from the source list without degenerate triangles.
+   U32 count = 0;
+   for ( U32 i = 0; i + 2 < indexCount; i += 3 )
+   {
+      U32 a = indices[i], b = indices[i + 1], c = indices[i + 2];
+      if ( a == b || b == c || a == c || a >= vertexCount || b >= vertexCount || c >= vertexCount )
+         continue;
+
+      indicesOut[count++] = a;
+      indicesOut[count++] = b;
+      indicesOut[count++] = c;
+   }
+
+   if ( count <= targetIndexCount )
+      return count;
+
+   // Positions are scaled by the bounds diagonal so errors are relative.
+   const U8* vertexData = (const U8*)positions;
+   F32 minExtents[3] = {  F32_MAX,  F32_MAX,  F32_MAX };
+   F32 maxExtents[3] = { -F32_MAX, -F32_MAX, -F32_MAX };
+   for ( U32 v = 0; v < vertexCount; ++v )
+   {
+      const F32* p = (const F32*)(vertexData + v * vertexStride);
+      for ( U32 k = 0; k < 3; ++k )
+      {
+         minExtents[k] = getMin(minExtents[k], p[k]);
+         maxExtents[k] = getMax(maxExtents[k], p[k]);
+      }
+   }
+
+   F32 diagonal = mSqrt((maxExtents[0] - minExtents[0]) * (maxExtents[0] - minExtents[0])
+                      + (maxExtents[1] - minExtents[1]) * (maxExtents[1] - minExtents[1])
+                      + (maxExtents[2] - minExtents[2]) * (maxExtents[2] - minExtents[2]));
+   F32 scale = diagonal > 0.0f ? 1.0f / diagonal : 1.0f;
+
+   Vector<F32> points;
+   points.setSize(vertexCount * 3);
+   for ( U32 v = 0; v < vertexCount; ++v )
+   {
+      const F32* p = (const F32*)(vertexData + v * vertexStride);
+      for ( U32 k = 0; k < 3; ++k )
+         points[v * 3 + k] = (p[k] - minExtents[k]) * scale;
+   }
+
+   Vector<U8> kinds;
+   kinds.setSize(vertexCount);
+   dMemset(kinds.address(), ManifoldVertex, vertexCount);
+   lockSeams(kinds.address(), vertexData, vertexCount, vertexStride);
+
+   // Each vertex starts with the planes of its triangles, weighted by area.
+   // Open border edges add a plane through the edge at right angles to the
+   // triangle so borders resist being pulled in.
+   const F32 BorderWeight = 10.0f;
+
+   EdgeSet edges;
+   edges.init(count);
+   for ( U32 i = 0; i < count; i += 3 )
+   {
+      edges.insert(indicesOut[i + 0], indicesOut[i + 1]);
+      edges.insert(indicesOut[i + 1], indicesOut[i + 2]);
+      edges.insert(indicesOut[i + 2], indicesOut[i + 0]);
+   }
+
+   Vector<Quadric> quadrics;
+   quadrics.setSize(vertexCount);
+   dMemset(quadrics.address(), 0, vertexCount * sizeof(Quadric));
+   for ( U32 i = 0; i < count; i += 3 )
+   {
+      const U32* tri = &indicesOut[i];
+      const F32* p0 = &points[tri[0] * 3];
+
+      F32 normal[3];
+      triangleNormal(normal, p0, &points[tri[1] * 3], &points[tri[2] * 3]);
+      F32 length = mSqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+      if ( length <= 0.0f )
+         continue;
+
+      normal[0] /= length;
+      normal[1] /= length;
+      normal[2] /= length;
+      F32 d = -(normal[0] * p0[0] + normal[1] * p0[1] + normal[2] * p0[2]);
+      for ( U32 k = 0; k < 3; ++k )
+         addPlaneQuadric(&quadrics[tri[k]], normal[0], normal[1], normal[2], d, length * 0.5f);
+
+      for ( U32 k = 0; k < 3; ++k )
+      {
+         U32 a = tri[k];
+         U32 b = tri[(k + 1) % 3];
+         if ( edges.contains(b, a) )
+            continue;
+
+         if ( kinds[a] == ManifoldVertex ) kinds[a] = lockBorders ? LockedVertex : BorderVertex;
+         if ( kinds[b] == ManifoldVertex ) kinds[b] = lockBorders ? LockedVertex : BorderVertex;
+
+         const F32* pa = &points[a * 3];
+         const F32* pb = &points[b * 3];
+         F32 edge[3] = { pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2] };
+         F32 edgeLengthSq = edge[0] * edge[0] + edge[1] * edge[1] + edge[2] * edge[2];
+
+         F32 plane[3] = { edge[1] * normal[2] - edge[2] * normal[1],
+                          edge[2] * normal[0] - edge[0] * normal[2],
+                          edge[0] * normal[1] - edge[1] * normal[0] };
+         F32 planeLength = mSqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+         if ( planeLength <= 0.0f )
+            continue;
+
+         plane[0] /= planeLength;
+         plane[1] /= planeLength;
+         plane[2] /= planeLength;
+         F32 planeD = -(plane[0] * pa[0] + plane[1] * pa[1] + plane[2] * pa[2]);
+         addPlaneQuadric(&quadrics[a], plane[0], plane[1], plane[2], planeD, edgeLengthSq * BorderWeight);
+         addPlaneQuadric(&quadrics[b], plane[0], plane[1], plane[2], planeD, edgeLengthSq * BorderWeight);
+      }
+   }
+
+   // Collapses are made in passes. Each pass ranks every edge by cost and 
+   // takes the cheapest ones that don't touch a vertex already moved in the
+   // same pass, until enough triangles are gone for the target.
+   const F32 maxCost = targetError * targetError;
+   F32 resultCost = 0.0f;
+
+   Vector<U32> triOffsets;
+   Vector<U32> triList;
+   Vector<U32> remap;
+   Vector<U8> touched;
+   Vector<Collapse> collapses;
+   triOffsets.setSize(vertexCount + 1);
+   remap.setSize(vertexCount);
+   touched.setSize(vertexCount);
+
+   while ( count > targetIndexCount )
+   {
+      // Vertex to triangle adjacency.
+      dMemset(triOffsets.address(), 0, (vertexCount + 1) * sizeof(U32));
+      for ( U32 i = 0; i < count; ++i )
+         triOffsets[indicesOut[i] + 1]++;
+      for ( U32 v = 0; v < vertexCount; ++v )
+         triOffsets[v + 1] += triOffsets[v];
+
+      triList.setSize(count);
+      for ( U32 i = 0; i < count; ++i )
+         triList[triOffsets[indicesOut[i]]++] = i / 3;
+      for ( U32 v = vertexCount; v > 0; --v )
+         triOffsets[v] = triOffsets[v - 1];
+      triOffsets[0] = 0;
+
+      edges.init(count);
+      for ( U32 i = 0; i < count; i += 3 )
+      {
+         edges.insert(indicesOut[i + 0], indicesOut[i + 1]);
+         edges.insert(indicesOut[i + 1], indicesOut[i + 2]);
+         edges.insert(indicesOut[i + 2], indicesOut[i + 0]);
+      }
+
+      // Rank the edges, each one by the cheaper of its two directions.
+      collapses.clear();
+      for ( U32 i = 0; i < count; ++i )
+      {
+         U32 a = indicesOut[i];
+         U32 b = indicesOut[(i % 3 == 2) ? i - 2 : i + 1];
+         bool border = !edges.contains(b, a);
+
+         // Interior edges are seen from both of their triangles.
+         if ( !border && a > b )
+            continue;
+
+         bool canMoveA = kinds[a] == ManifoldVertex || (kinds[a] == BorderVertex && border);
+         bool canMoveB = kinds[b] == ManifoldVertex || (kinds[b] == BorderVertex && border);
+         if ( !canMoveA && !canMoveB )
+            continue;
+
+         Quadric q = quadrics[a];
+         addQuadric(&q, quadrics[b]);
+
+         Collapse collapse;
+         F32 costA = canMoveA ? evalQuadric(q, &points[b * 3]) : F32_MAX;
+         F32 costB = canMoveB ? evalQuadric(q, &points[a * 3]) : F32_MAX;
+         collapse.cost  = getMin(costA, costB);
+         collapse.from  = (costA <= costB) ? a : b;
+         collapse.to    = (costA <= costB) ? b : a;
+         if ( collapse.cost <= maxCost )
+            collapses.push_back(collapse);
+      }
+
+      if ( collapses.size() == 0 )
+         break;
+
+      dQsort(collapses.address(), collapses.size(), sizeof(Collapse), compareCollapses);
+
+      for ( U32 v = 0; v < vertexCount; ++v )
+         remap[v] = v;
+      dMemset(touched.address(), 0, vertexCount);
+
+      U32 trianglesNeeded = (count - targetIndexCount + 2) / 3;
+      U32 trianglesRemoved = 0;
+      U32 collapseCount = 0;
+      for ( S32 c = 0; c < collapses.size() && trianglesRemoved < trianglesNeeded; ++c )
+      {
+         const Collapse& collapse = collapses[c];
+         if ( touched[collapse.from] || touched[collapse.to] )
+            continue;
+
+         const U32* tris = &triList[triOffsets[collapse.from]];
+         U32 triCount = triOffsets[collapse.from + 1] - triOffsets[collapse.from];
+         if ( collapseFlips(points.address(), indicesOut, tris, triCount, remap.address(), collapse.from, collapse.to) )
+            continue;
+
+         for ( U32 t = 0; t < triCount; ++t )
+         {
+            const U32* tri = &indicesOut[tris[t] * 3];
+            if ( remap[tri[0]] == collapse.to || remap[tri[1]] == collapse.to || remap[tri[2]] == collapse.to )
+               trianglesRemoved++;
+         }
+
+         remap[collapse.from] = collapse.to;
+         touched[collapse.from] = 1;
+         touched[collapse.to] = 1;
+         addQuadric(&quadrics[collapse.to], quadrics[collapse.from]);
+         resultCost = getMax(resultCost, collapse.cost);
+         collapseCount++;
+      }
+
+      if ( collapseCount == 0 )
+         break;
+
+      // Apply the pass and drop the triangles it collapsed.
+      U32 newCount = 0;
+      for ( U32 i = 0; i < count; i += 3 )
+      {
+         U32 a = remap[indicesOut[i]], b = remap[indicesOut[i + 1]], c = remap[indicesOut[i + 2]];
+         if ( a == b || b == c || a == c )
+            continue;
+
+         indicesOut[newCount++] = a;
+         indicesOut[newCount++] = b;
+         indicesOut[newCount++] = c;
+      }
+      count = newCount;
+   }
+
+   if ( errorOut != NULL )
+      *errorOut = mSqrt(resultCost);
+
+   return count;
+}
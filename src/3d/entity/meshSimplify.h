@@ -0,0 +1,53 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _MESH_SIMPLIFY_H_
+#define _MESH_SIMPLIFY_H_
+
+#ifndef _PLATFORM_H_
+#include "platform/platform.h"
+#endif
+
+// Quadric error edge collapse simplification (Garland and Heckbert). 
+// Vertices are only ever collapsed onto one another and never moved, so the
+// result indexes the same vertex buffer as the source and a LOD only needs
+// an index buffer of its own.
+//
+// Positions are read as three floats at the start of every vertexStride 
+// bytes. Vertices that share their position with another vertex (UV and 
+// normal seams) stay put and open borders only collapse along themselves, 
+// so texturing and silhouettes hold up.
+//
+// indices is a triangle list. Collapsing stops once the triangle list is 
+// down to targetIndexCount or the next collapse would exceed targetError.
+// Errors are relative to the diagonal of the mesh bounds, so 0.01 means the
+// surface moved by about 1% of the size of the mesh. Writes at most 
+// indexCount indices to indicesOut, returns how many were written and 
+// stores the largest error in errorOut.
+//
+// With lockBorders open borders don't move at all. Pieces of a mesh that was
+// split apart use it so neighbouring pieces keep meeting along their seams.
+U32 simplifyMesh(U32* indicesOut, const U32* indices, U32 indexCount, 
+   const F32* positions, U32 vertexCount, U32 vertexStride, 
+   U32 targetIndexCount, F32 targetError, F32* errorOut, bool lockBorders = false);
+
+#endif // _MESH_SIMPLIFY_H_
@@ -0,0 +1,604 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "skeleton.h"
+#include "math/mMathFn.h"
+
+// Assimp - Asset Import Library
+#include <assimp/matrix4x4.h>
+#include <assimp/quaternion.h>
+
+//-----------------------------------------------------------------------------
+// Helpers
+//-----------------------------------------------------------------------------
+
+// SIMD loads and stores need 16 byte alignment which dMalloc doesn't promise,
+// so the original pointer is stashed just before the aligned block.
+static void* allocAligned(U32 size)
+{
+   U8* raw = (U8*)dMalloc(size + 16 + sizeof(void*));
+   U8* aligned = (U8*)(((size_t)(raw + sizeof(void*)) + 15) & ~(size_t)15);
+   ((void**)aligned)[-1] = raw;
+   return aligned;
+}
+
+static void freeAligned(void* ptr)
+{
+   if ( ptr != NULL )
+      dFree(((void**)ptr)[-1]);
+}
+
+static void setIdentity(bx::float4x4_t* mtx)
+{
+   mtx->col[0] = bx::float4_ld(1.0f, 0.0f, 0.0f, 0.0f);
+   mtx->col[1] = bx::float4_ld(0.0f, 1.0f, 0.0f, 0.0f);
+   mtx->col[2] = bx::float4_ld(0.0f, 0.0f, 1.0f, 0.0f);
+   mtx->col[3] = bx::float4_ld(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+// Builds T * R * S as a row major matrix (translation in the last column),
+// the same layout MatrixF and Assimp use. Rows go in float4x4_t::col.
+static void composeTransform(bx::float4x4_t* out, const BoneTransform& xfrm)
+{
+   const F32 x = xfrm.rotation[0];
+   const F32 y = xfrm.rotation[1];
+   const F32 z = xfrm.rotation[2];
+   const F32 w = xfrm.rotation[3];
+
+   const F32 x2 = x + x;
+   const F32 y2 = y + y;
+   const F32 z2 = z + z;
+   const F32 xx = x * x2;
+   const F32 xy = x * y2;
+   const F32 xz = x * z2;
+   const F32 yy = y * y2;
+   const F32 yz = y * z2;
+   const F32 zz = z * z2;
+   const F32 wx = w * x2;
+   const F32 wy = w * y2;
+   const F32 wz = w * z2;
+
+   const bx::float4_t scale = bx::float4_ld(xfrm.scale[0], xfrm.scale[1], xfrm.scale[2], 1.0f);
+
+   out->col[0] = bx::float4_mul(bx::float4_ld(1.0f - (yy + zz), xy - wz, xz + wy, xfrm.translation[0]), scale);
+   out->col[1] = bx::float4_mul(bx::float4_ld(xy + wz, 1.0f - (xx + zz), yz - wx, xfrm.translation[1]), scale);
+   out->col[2] = bx::float4_mul(bx::float4_ld(xz - wy, yz + wx, 1.0f - (xx + yy), xfrm.translation[2]), scale);
+   out->col[3] = bx::float4_ld(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+// Finds the key pair surrounding time, starting from the cached cursor. Only
+// rewinds when time moves backwards (looping), so playing forward is O(1).
+static F32 findKey(const F32* times, U32 count, F32 time, U32& cursor, U32& key, U32& nextKey)
+{
+   if ( count == 1 )
+   {
+      key = nextKey = 0;
+      return 0.0f;
+   }
+
+   U32 k = cursor;
+   if ( k > count - 2 || times[k] > time )
+      k = 0;
+
+   while ( k < count - 2 && times[k + 1] <= time )
+      ++k;
+
+   cursor   = k;
+   key      = k;
+   nextKey  = k + 1;
+
+   F32 delta = times[k + 1] - times[k];
+   if ( delta <= 0.0f )
+      return 0.0f;
+
+   return mClampF((time - times[k]) / delta, 0.0f, 1.0f);
+}
+
+static void lerpKeys(const F32* a, const F32* b, F32 t, F32* out)
+{
+   out[0] = a[0] + (b[0] - a[0]) * t;
+   out[1] = a[1] + (b[1] - a[1]) * t;
+   out[2] = a[2] + (b[2] - a[2]) * t;
+   out[3] = 0.0f;
+}
+
+// Matches aiQuaternion::Interpolate followed by Normalize().
+static void slerpKeys(const F32* a, const F32* b, F32 t, F32* out)
+{
+   F32 cosom = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+   F32 sign = 1.0f;
+   if ( cosom < 0.0f )
+   {
+      cosom = -cosom;
+      sign = -1.0f;
+   }
+
+   F32 sclp, sclq;
+   if ( (1.0f - cosom) > 0.0001f )
+   {
+      F32 omega = mAcos(cosom);
+      F32 sinom = mSin(omega);
+      sclp = mSin((1.0f - t) * omega) / sinom;
+      sclq = mSin(t * omega) / sinom;
+   } else {
+      sclp = 1.0f - t;
+      sclq = t;
+   }
+   sclq *= sign;
+
+   F32 x = sclp * a[0] + sclq * b[0];
+   F32 y = sclp * a[1] + sclq * b[1];
+   F32 z = sclp * a[2] + sclq * b[2];
+   F32 w = sclp * a[3] + sclq * b[3];
+
+   F32 length = mSqrt(x * x + y * y + z * z + w * w);
+   F32 invLength = length > 0.0f ? 1.0f / length : 0.0f;
+   out[0] = x * invLength;
+   out[1] = y * invLength;
+   out[2] = z * invLength;
+   out[3] = w * invLength;
+}
+
+//-----------------------------------------------------------------------------
+// BoneTransform
+//-----------------------------------------------------------------------------
+
+void BoneTransform::set(const MatrixF& mat)
+{
+   const F32* m = mat;
+   aiMatrix4x4 transform(m[0], m[1], m[2], m[3], 
+                         m[4], m[5], m[6], m[7], 
+                         m[8], m[9], m[10], m[11], 
+                         m[12], m[13], m[14], m[15]);
+
+   aiVector3D aiScaling;
+   aiQuaternion aiRotation;
+   aiVector3D aiPosition;
+   transform.Decompose(aiScaling, aiRotation, aiPosition);
+
+   translation[0] = aiPosition.x;
+   translation[1] = aiPosition.y;
+   translation[2] = aiPosition.z;
+   translation[3] = 0.0f;
+   rotation[0]    = aiRotation.x;
+   rotation[1]    = aiRotation.y;
+   rotation[2]    = aiRotation.z;
+   rotation[3]    = aiRotation.w;
+   scale[0]       = aiScaling.x;
+   scale[1]       = aiScaling.y;
+   scale[2]       = aiScaling.z;
+   scale[3]       = 0.0f;
+}
+
+//-----------------------------------------------------------------------------
+// Skeleton
+//-----------------------------------------------------------------------------
+
+Skeleton::Skeleton()
+{
+   mBoneCount = 0;
+   mMatrices = NULL;
+}
+
+Skeleton::~Skeleton()
+{
+   clear();
+}
+
+void Skeleton::clear()
+{
+   mParents.clear();
+   mBoneIndices.clear();
+   mRestPose.clear();
+   mBoneCount = 0;
+
+   freeAligned(mMatrices);
+   mMatrices = NULL;
+}
+
+void Skeleton::init(U32 nodeCount, U32 boneCount)
+{
+   clear();
+
+   mParents.setSize(nodeCount);
+   mBoneIndices.setSize(nodeCount);
+   mRestPose.setSize(nodeCount);
+   mBoneCount = boneCount;
+
+   MatrixF identity(true);
+   for ( U32 n = 0; n < nodeCount; ++n )
+   {
+      mParents[n] = -1;
+      mBoneIndices[n] = -1;
+      mRestPose[n].set(identity);
+   }
+
+   mMatrices = (bx::float4x4_t*)allocAligned((boneCount + 1) * sizeof(bx::float4x4_t));
+   for ( U32 n = 0; n <= boneCount; ++n )
+      setIdentity(&mMatrices[n]);
+}
+
+void Skeleton::setNode(U32 index, S32 parent, S32 boneIndex, const MatrixF& restTransform)
+{
+   AssertFatal(parent < (S32)index, "Skeleton::setNode - Parents must come before their children.");
+   AssertFatal(boneIndex < (S32)mBoneCount, "Skeleton::setNode - Bone index out of range.");
+
+   mParents[index] = parent;
+   mBoneIndices[index] = boneIndex;
+   mRestPose[index].set(restTransform);
+}
+
+void Skeleton::setBoneOffset(U32 boneIndex, const MatrixF& offset)
+{
+   AssertFatal(boneIndex < mBoneCount, "Skeleton::setBoneOffset - Bone index out of range.");
+   dMemcpy(&mMatrices[boneIndex], (const F32*)offset, sizeof(F32) * 16);
+}
+
+void Skeleton::setGlobalInverseTransform(const MatrixF& transform)
+{
+   dMemcpy(&mMatrices[mBoneCount], (const F32*)transform, sizeof(F32) * 16);
+}
+
+U32 Skeleton::buildSkinTransforms(AnimationState* state, F32* transformsOut) const
+{
+   const U32 nodeCount = mParents.size();
+   const BoneTransform* pose = state->mLocalPose.address();
+   const bx::float4x4_t* globalInverse = &mMatrices[mBoneCount];
+   bx::float4x4_t* model = state->mModelSpace;
+
+   bx::float4x4_t local;
+   bx::float4x4_t skin;
+   bx::float4x4_t skinTransposed;
+
+   U32 xfrmCount = 0;
+   for ( U32 n = 0; n < nodeCount; ++n )
+   {
+      composeTransform(&local, pose[n]);
+
+      // The global inverse is folded into the roots, so every model space
+      // matrix is already relative to the mesh.
+      const S32 parent = mParents[n];
+      bx::float4x4_mul(&model[n], parent >= 0 ? &model[parent] : globalInverse, &local);
+
+      const S32 boneIndex = mBoneIndices[n];
+      if ( boneIndex < 0 )
+         continue;
+
+      bx::float4x4_mul(&skin, &model[n], &mMatrices[boneIndex]);
+
+      // Row major to column major for the shaders.
+      bx::float4x4_transpose(&skinTransposed, &skin);
+      dMemcpy(&transformsOut[boneIndex * 16], &skinTransposed, sizeof(F32) * 16);
+
+      xfrmCount = getMax(xfrmCount, (U32)boneIndex + 1);
+   }
+
+   return xfrmCount;
+}
+
+//-----------------------------------------------------------------------------
+// AnimationClip
+//-----------------------------------------------------------------------------
+
+AnimationClip::AnimationClip()
+{
+   mName = StringTable->EmptyString;
+   mDuration = 0.0f;
+   mTicksPerSecond = 0.0f;
+   mNodeCount = 0;
+}
+
+void AnimationClip::init(U32 nodeCount)
+{
+   mNodeCount = nodeCount;
+   mTracks.setSize(nodeCount * ChannelCount);
+   for ( S32 n = 0; n < mTracks.size(); ++n )
+   {
+      mTracks[n].mFirstKey = 0;
+      mTracks[n].mKeyCount = 0;
+   }
+   mTimes.clear();
+   mValues.clear();
+}
+
+U32 AnimationClip::addTrack(U32 node, Channel channel, U32 keyCount)
+{
+   Track* track = &mTracks[node * ChannelCount + channel];
+   track->mFirstKey = mTimes.size();
+   track->mKeyCount = keyCount;
+
+   mTimes.setSize(track->mFirstKey + keyCount);
+   mValues.setSize((track->mFirstKey + keyCount) * 4);
+   return track->mFirstKey;
+}
+
+F32 AnimationClip::getTicks(F64 timeInSeconds) const
+{
+   if ( mDuration <= 0.0f )
+      return 0.0f;
+
+   F64 ticksPerSecond = mTicksPerSecond != 0.0f ? mTicksPerSecond : 25.0f;
+   return (F32)fmod(timeInSeconds * ticksPerSecond, (F64)mDuration);
+}
+
+void AnimationClip::_sampleNode(U32 node, F32 time, U32* cursors, const BoneTransform& rest, BoneTransform& out) const
+{
+   const Track* tracks = &mTracks[node * ChannelCount];
+   const F32* times = mTimes.address();
+   const F32* values = mValues.address();
+   U32 key, nextKey;
+
+   // Position
+   const Track& position = tracks[Position];
+   if ( position.mKeyCount > 0 )
+   {
+      F32 factor = findKey(&times[position.mFirstKey], position.mKeyCount, time, cursors[Position], key, nextKey);
+      lerpKeys(&values[(position.mFirstKey + key) * 4], &values[(position.mFirstKey + nextKey) * 4], factor, out.translation);
+   } else {
+      dMemcpy(out.translation, rest.translation, sizeof(out.translation));
+   }
+
+   // Rotation
+   const Track& rotation = tracks[Rotation];
+   if ( rotation.mKeyCount > 0 )
+   {
+      F32 factor = findKey(&times[rotation.mFirstKey], rotation.mKeyCount, time, cursors[Rotation], key, nextKey);
+      slerpKeys(&values[(rotation.mFirstKey + key) * 4], &values[(rotation.mFirstKey + nextKey) * 4], factor, out.rotation);
+   } else {
+      dMemcpy(out.rotation, rest.rotation, sizeof(out.rotation));
+   }
+
+   // Scaling
+   const Track& scaling = tracks[Scaling];
+   if ( scaling.mKeyCount > 0 )
+   {
+      F32 factor = findKey(&times[scaling.mFirstKey], scaling.mKeyCount, time, cursors[Scaling], key, nextKey);
+      lerpKeys(&values[(scaling.mFirstKey + key) * 4], &values[(scaling.mFirstKey + nextKey) * 4], factor, out.scale);
+   } else {
+      dMemcpy(out.scale, rest.scale, sizeof(out.scale));
+   }
+}
+
+void AnimationClip::sample(F32 time, U32* cursors, const BoneTransform* restPose, BoneTransform* poseOut) const
+{
+   for ( U32 n = 0; n < mNodeCount; ++n )
+      _sampleNode(n, time, &cursors[n * ChannelCount], restPose[n], poseOut[n]);
+}
+
+// The accumulated weight of each node rides in the unused w lane of its
+// translation until endBlend.
+void AnimationClip::beginBlend(BoneTransform* pose, U32 nodeCount)
+{
+   dMemset(pose, 0, nodeCount * sizeof(BoneTransform));
+}
+
+static void accumulateTransform(BoneTransform& pose, const BoneTransform& xfrm, F32 weight)
+{
+   pose.translation[0] += xfrm.translation[0] * weight;
+   pose.translation[1] += xfrm.translation[1] * weight;
+   pose.translation[2] += xfrm.translation[2] * weight;
+   pose.translation[3] += weight;
+
+   // Keep every rotation in the same hemisphere before summing.
+   F32 dot = pose.rotation[0] * xfrm.rotation[0] + pose.rotation[1] * xfrm.rotation[1] 
+           + pose.rotation[2] * xfrm.rotation[2] + pose.rotation[3] * xfrm.rotation[3];
+   F32 rotationWeight = dot < 0.0f ? -weight : weight;
+   pose.rotation[0] += xfrm.rotation[0] * rotationWeight;
+   pose.rotation[1] += xfrm.rotation[1] * rotationWeight;
+   pose.rotation[2] += xfrm.rotation[2] * rotationWeight;
+   pose.rotation[3] += xfrm.rotation[3] * rotationWeight;
+
+   pose.scale[0] += xfrm.scale[0] * weight;
+   pose.scale[1] += xfrm.scale[1] * weight;
+   pose.scale[2] += xfrm.scale[2] * weight;
+}
+
+void AnimationClip::accumulate(F32 time, U32* cursors, const BoneTransform* restPose, F32 weight, const F32* mask, BoneTransform* pose) const
+{
+   BoneTransform sampled;
+   for ( U32 n = 0; n < mNodeCount; ++n )
+   {
+      F32 nodeWeight = mask != NULL ? weight * mask[n] : weight;
+      if ( nodeWeight <= 0.0f )
+         continue;
+
+      _sampleNode(n, time, &cursors[n * ChannelCount], restPose[n], sampled);
+      accumulateTransform(pose[n], sampled, nodeWeight);
+   }
+}
+
+void AnimationClip::endBlend(BoneTransform* pose, const BoneTransform* restPose, U32 nodeCount)
+{
+   for ( U32 n = 0; n < nodeCount; ++n )
+   {
+      BoneTransform& xfrm = pose[n];
+
+      // Nodes not fully covered by the layers (masks, fades) fall back
+      // towards the rest pose.
+      F32 total = xfrm.translation[3];
+      if ( total < 1.0f )
+      {
+         accumulateTransform(xfrm, restPose[n], 1.0f - total);
+         total = 1.0f;
+      }
+
+      F32 invTotal = 1.0f / total;
+      xfrm.translation[0] *= invTotal;
+      xfrm.translation[1] *= invTotal;
+      xfrm.translation[2] *= invTotal;
+      xfrm.translation[3] = 0.0f;
+      xfrm.scale[0] *= invTotal;
+      xfrm.scale[1] *= invTotal;
+      xfrm.scale[2] *= invTotal;
+
+      F32 length = mSqrt(xfrm.rotation[0] * xfrm.rotation[0] + xfrm.rotation[1] * xfrm.rotation[1] 
+                       + xfrm.rotation[2] * xfrm.rotation[2] + xfrm.rotation[3] * xfrm.rotation[3]);
+      if ( length > 0.0f )
+      {
+         F32 invLength = 1.0f / length;
+         xfrm.rotation[0] *= invLength;
+         xfrm.rotation[1] *= invLength;
+         xfrm.rotation[2] *= invLength;
+         xfrm.rotation[3] *= invLength;
+      } else {
+         dMemcpy(xfrm.rotation, restPose[n].rotation, sizeof(xfrm.rotation));
+      }
+   }
+}
+
+void AnimationClip::applyAdditive(F32 time, U32* cursors, const BoneTransform* restPose, F32 weight, const F32* mask, BoneTransform* pose) const
+{
+   BoneTransform sampled;
+   for ( U32 n = 0; n < mNodeCount; ++n )
+   {
+      F32 w = mask != NULL ? weight * mask[n] : weight;
+      if ( w <= 0.0f )
+         continue;
+
+      const BoneTransform& rest = restPose[n];
+      BoneTransform& xfrm = pose[n];
+      _sampleNode(n, time, &cursors[n * ChannelCount], rest, sampled);
+
+      // Translation
+      xfrm.translation[0] += (sampled.translation[0] - rest.translation[0]) * w;
+      xfrm.translation[1] += (sampled.translation[1] - rest.translation[1]) * w;
+      xfrm.translation[2] += (sampled.translation[2] - rest.translation[2]) * w;
+
+      // Rotation: delta = conjugate(rest) * sampled, weighted towards
+      // identity and applied in the node's local space.
+      const F32* r = rest.rotation;
+      const F32* q = sampled.rotation;
+      F32 dx =  r[3] * q[0] - r[0] * q[3] - r[1] * q[2] + r[2] * q[1];
+      F32 dy =  r[3] * q[1] + r[0] * q[2] - r[1] * q[3] - r[2] * q[0];
+      F32 dz =  r[3] * q[2] - r[0] * q[1] + r[1] * q[0] - r[2] * q[3];
+      F32 dw =  r[3] * q[3] + r[0] * q[0] + r[1] * q[1] + r[2] * q[2];
+      if ( dw < 0.0f )
+      {
+         dx = -dx; dy = -dy; dz = -dz; dw = -dw;
+      }
+      dx *= w; dy *= w; dz *= w;
+      dw = 1.0f + (dw - 1.0f) * w;
+      F32 length = mSqrt(dx * dx + dy * dy + dz * dz + dw * dw);
+      if ( length > 0.0f )
+      {
+         F32 invLength = 1.0f / length;
+         dx *= invLength; dy *= invLength; dz *= invLength; dw *= invLength;
+      }
+
+      const F32* p = xfrm.rotation;
+      F32 x = p[3] * dx + p[0] * dw + p[1] * dz - p[2] * dy;
+      F32 y = p[3] * dy - p[0] * dz + p[1] * dw + p[2] * dx;
+      F32 z = p[3] * dz + p[0] * dy - p[1] * dx + p[2] * dw;
+      F32 qw = p[3] * dw - p[0] * dx - p[1] * dy - p[2] * dz;
+      xfrm.rotation[0] = x;
+      xfrm.rotation[1] = y;
+      xfrm.rotation[2] = z;
+      xfrm.rotation[3] = qw;
+
+      // Scaling
+      for ( U32 i = 0; i < 3; ++i )
+      {
+         F32 ratio = rest.scale[i] != 0.0f ? sampled.scale[i] / rest.scale[i] : 1.0f;
+         xfrm.scale[i] *= 1.0f + (ratio - 1.0f) * w;
+      }
+   }
+}
+
+//-----------------------------------------------------------------------------
+// AnimationLayer
+//-----------------------------------------------------------------------------
+
+AnimationLayer::AnimationLayer()
+{
+   mClip = 0;
+   mMode = Blend;
+   mTime = 0.0;
+   mSpeed = 1.0f;
+   mWeight = 1.0f;
+   mTargetWeight = 1.0f;
+   mFadeRate = 0.0f;
+   mRemoveOnFadeOut = false;
+}
+
+void AnimationLayer::advance(F32 dt)
+{
+   mTime += dt * mSpeed;
+
+   if ( mWeight != mTargetWeight )
+   {
+      if ( mFadeRate <= 0.0f )
+         mWeight = mTargetWeight;
+      else if ( mWeight < mTargetWeight )
+         mWeight = getMin(mWeight + mFadeRate * dt, mTargetWeight);
+      else
+         mWeight = getMax(mWeight - mFadeRate * dt, mTargetWeight);
+   }
+}
+
+void AnimationLayer::fadeTo(F32 weight, F32 duration, bool removeWhenDone)
+{
+   mTargetWeight = weight;
+   mRemoveOnFadeOut = removeWhenDone;
+   mFadeRate = duration > 0.0f ? mFabs(weight - mWeight) / duration : 0.0f;
+   if ( duration <= 0.0f )
+      mWeight = weight;
+}
+
+//-----------------------------------------------------------------------------
+// AnimationState
+//-----------------------------------------------------------------------------
+
+AnimationState::AnimationState()
+{
+   mModelSpace = NULL;
+   mNodeCount = 0;
+}
+
+AnimationState::~AnimationState()
+{
+   freeAligned(mModelSpace);
+}
+
+void AnimationState::init(const Skeleton* skeleton)
+{
+   freeAligned(mModelSpace);
+   mModelSpace = NULL;
+   mNodeCount = 0;
+   mCursors.clear();
+   mLocalPose.clear();
+
+   if ( skeleton == NULL || skeleton->getNodeCount() == 0 )
+      return;
+
+   mNodeCount = skeleton->getNodeCount();
+   mCursors.setSize(mNodeCount * AnimationClip::ChannelCount);
+   mLocalPose.setSize(mNodeCount);
+   dMemcpy(mLocalPose.address(), skeleton->getRestPose(), mNodeCount * sizeof(BoneTransform));
+   mModelSpace = (bx::float4x4_t*)allocAligned(mNodeCount * sizeof(bx::float4x4_t));
+   resetCursors();
+}
+
+void AnimationState::resetCursors()
+{
+   if ( mCursors.size() > 0 )
+      dMemset(mCursors.address(), 0, mCursors.size() * sizeof(U32));
+}
@@ -0,0 +1,208 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _SKELETON_H_
+#define _SKELETON_H_
+
+#ifndef _PLATFORM_H_
+#include "platform/platform.h"
+#endif
+
+#ifndef _VECTOR_H_
+#include "collection/vector.h"
+#endif
+
+#ifndef _MMATRIX_H_
+#include "math/mMatrix.h"
+#endif
+
+#include <bx/float4x4_t.h>
+
+class AnimationState;
+
+// Local node transform kept decomposed, so clips can be sampled (and later
+// blended) before anything is turned into a matrix.
+struct BoneTransform
+{
+   F32 translation[4];
+   F32 rotation[4];     // x, y, z, w
+   F32 scale[4];
+
+   void set(const MatrixF& mat);
+};
+
+//-----------------------------------------------------------------------------
+
+// Flat, parent indexed node hierarchy. Parents always come before their
+// children so the local to model pass is a single forward loop.
+class Skeleton
+{
+protected:
+   Vector<S32>             mParents;
+   Vector<S32>             mBoneIndices;     // -1 if the node doesn't drive a bone.
+   Vector<BoneTransform>   mRestPose;
+   U32                     mBoneCount;
+
+   // Bone offsets followed by the global inverse transform, 16 byte aligned
+   // and stored row major like MatrixF.
+   bx::float4x4_t*         mMatrices;
+
+public:
+   Skeleton();
+   ~Skeleton();
+
+   void clear();
+   void init(U32 nodeCount, U32 boneCount);
+   void setNode(U32 index, S32 parent, S32 boneIndex, const MatrixF& restTransform);
+   void setBoneOffset(U32 boneIndex, const MatrixF& offset);
+   void setGlobalInverseTransform(const MatrixF& transform);
+
+   U32                  getNodeCount() const { return mParents.size(); }
+   U32                  getBoneCount() const { return mBoneCount; }
+   S32                  getParent(U32 index) const { return mParents[index]; }
+   S32                  getBoneIndex(U32 index) const { return mBoneIndices[index]; }
+   const BoneTransform* getRestPose() const { return mRestPose.address(); }
+
+   // Composes the local pose held in state into model space and writes one
+   // column major skinning matrix per bone. Returns the number of bones written.
+   U32 buildSkinTransforms(AnimationState* state, F32* transformsOut) const;
+
+private:
+   Skeleton(const Skeleton&);
+   Skeleton& operator=(const Skeleton&);
+};
+
+//-----------------------------------------------------------------------------
+
+// Keyframes for every node of a skeleton, stored SoA: key times and key values
+// live in their own contiguous arrays, each track is a range into them.
+class AnimationClip
+{
+public:
+   enum Channel
+   {
+      Position = 0,
+      Rotation,
+      Scaling,
+      ChannelCount
+   };
+
+   struct Track
+   {
+      U32 mFirstKey;
+      U32 mKeyCount;    // 0 means the node holds its rest pose on this channel.
+   };
+
+   StringTableEntry  mName;
+   F32               mDuration;        // In ticks.
+   F32               mTicksPerSecond;
+   U32               mNodeCount;
+   Vector<Track>     mTracks;          // mNodeCount * ChannelCount
+   Vector<F32>       mTimes;           // One per key.
+   Vector<F32>       mValues;          // Four per key: xyz_ or quaternion xyzw.
+
+   AnimationClip();
+
+   void init(U32 nodeCount);
+
+   // Reserves keyCount keys for a track and returns the first key index. The
+   // caller fills mTimes[first + i] and mValues[(first + i) * 4 ...].
+   U32 addTrack(U32 node, Channel channel, U32 keyCount);
+
+   F32 getTicks(F64 timeInSeconds) const;
+
+   // Samples every node at time (in ticks). Each track remembers the key it
+   // found last in cursors, so playing forward is amortized O(1) per track.
+   void sample(F32 time, U32* cursors, const BoneTransform* restPose, BoneTransform* poseOut) const;
+
+   // Weighted blending straight into a pose: beginBlend clears it, accumulate
+   // samples and adds each node scaled by weight (times mask[node] if a mask
+   // is given), endBlend fills any missing weight from the rest pose and
+   // normalizes. No intermediate pose is built per clip.
+   static void beginBlend(BoneTransform* pose, U32 nodeCount);
+   void accumulate(F32 time, U32* cursors, const BoneTransform* restPose, F32 weight, const F32* mask, BoneTransform* pose) const;
+   static void endBlend(BoneTransform* pose, const BoneTransform* restPose, U32 nodeCount);
+
+   // Applies the clip's difference from the rest pose on top of pose.
+   void applyAdditive(F32 time, U32* cursors, const BoneTransform* restPose, F32 weight, const F32* mask, BoneTransform* pose) const;
+
+protected:
+   void _sampleNode(U32 node, F32 time, U32* cursors, const BoneTransform& rest, BoneTransform& out) const;
+};
+
+//-----------------------------------------------------------------------------
+
+// One clip playing on a character. Blend layers are mixed by weight,
+// additive layers are applied afterwards on top of the blended result. An
+// empty mask affects every node, otherwise it holds one weight per node.
+class AnimationLayer
+{
+public:
+   enum Mode
+   {
+      Blend = 0,
+      Additive
+   };
+
+   S32            mClip;
+   Mode           mMode;
+   F64            mTime;            // In seconds.
+   F32            mSpeed;
+   F32            mWeight;
+   F32            mTargetWeight;
+   F32            mFadeRate;        // Weight per second towards mTargetWeight.
+   bool           mRemoveOnFadeOut;
+   Vector<F32>    mMask;
+   Vector<U32>    mCursors;
+
+   AnimationLayer();
+
+   void advance(F32 dt);
+   void fadeTo(F32 weight, F32 duration, bool removeWhenDone = false);
+   bool isFinished() const { return mRemoveOnFadeOut && mWeight <= 0.0f && mTargetWeight <= 0.0f; }
+};
+
+//-----------------------------------------------------------------------------
+
+// Per instance playback data: key cursors, the local pose and model space
+// scratch. Owned by whoever animates, so instances never share state.
+class AnimationState
+{
+public:
+   Vector<U32>             mCursors;
+   Vector<BoneTransform>   mLocalPose;
+   bx::float4x4_t*         mModelSpace;
+   U32                     mNodeCount;
+
+   AnimationState();
+   ~AnimationState();
+
+   void init(const Skeleton* skeleton);
+   bool isValid(const Skeleton* skeleton) const { return skeleton != NULL && mNodeCount == skeleton->getNodeCount() && mModelSpace != NULL; }
+   void resetCursors();
+
+private:
+   AnimationState(const AnimationState&);
+   AnimationState& operator=(const AnimationState&);
+};
+
+#endif // _SKELETON_H_
@@ -105,10 +105,14 @@ MaterialAsset::MaterialAsset()
    mVertexShaderPath          = StringTable->insert("");
    mPixelShaderPath           = StringTable->insert("");
    mSkinnedVertexShaderPath   = StringTable->insert("");
+   mInstancedVertexShaderPath = StringTable->insert("");
+   mSkinnedInstancedVertexShaderPath = StringTable->insert("");
 
    mTemplate         = NULL;
    mMatShader        = NULL;
    mMatSkinnedShader = NULL;
+   mMatInstancedShader = NULL;
+   mMatSkinnedInstancedShader = NULL;
 }
 
 //------------------------------------------------------------------------------
@@ -194,10 +198,21 @@ void MaterialAsset::initializeAsset( void )
     mPixelShaderPath = Platform::getCachedFilePath(expandAssetFilePath(fs_name));
 
     // Vertex (Skinned)
+    // Named after the bone palette so shaders cached from the old transform table path get regenerated.
     char skinned_vs_name[200];
-    dSprintf(skinned_vs_name, 200, "%s_skinned_vs.sc", getAssetName());
+    dSprintf(skinned_vs_name, 200, "%s_skinned_palette_vs.sc", getAssetName());
     mSkinnedVertexShaderPath = Platform::getCachedFilePath(expandAssetFilePath(skinned_vs_name));
 
+    // Vertex (Instanced)
+    char instanced_vs_name[200];
+    dSprintf(instanced_vs_name, 200, "%s_instanced_vs.sc", getAssetName());
+    mInstancedVertexShaderPath = Platform::getCachedFilePath(expandAssetFilePath(instanced_vs_name));
+
+    // Vertex (Skinned + Instanced)
+    char skinned_instanced_vs_name[200];
+    dSprintf(skinned_instanced_vs_name, 200, "%s_skinned_instanced_vs.sc", getAssetName());
+    mSkinnedInstancedVertexShaderPath = Platform::getCachedFilePath(expandAssetFilePath(skinned_instanced_vs_name));
+
     compileMaterial();
     loadTextures();
 }
@@ -230,6 +245,13 @@ void MaterialAsset::loadTextures()
 void MaterialAsset::applyMaterial(Rendering::RenderData* renderData, bool skinned, Scene::BaseComponent* component)
 {
    renderData->shader = skinned ? mMatSkinnedShader->mProgram : mMatShader->mProgram;
+
+   // Skinned meshes read their bones from the bone palette so they can be instanced too.
+   Graphics::Shader* instancedShader = skinned ? mMatSkinnedInstancedShader : mMatInstancedShader;
+   if ( instancedShader != NULL )
+      renderData->instancedShader = instancedShader->mProgram;
+   else
+      renderData->instancedShader.idx = bgfx::invalidHandle;
    renderData->view = mTemplate->getRenderView();
 
    if ( renderData->textures != NULL )
@@ -293,7 +315,22 @@ void MaterialAsset::compileMaterial()
       shaderFile->close();
    }
 
+   // Clear template for instanced
+   mTemplate->isInstanced = true;
+   mTemplate->clearVertex();
+
+   // Vertex (Instanced)
+   if (!Platform::isFile(mInstancedVertexShaderPath))
+   {
+      Con::printf("Generating material instanced vertex shader..");
+      Platform::createPath(mInstancedVertexShaderPath);
+      shaderFile->openForWrite(mInstancedVertexShaderPath);
+      shaderFile->writeLine((const U8*)mTemplate->getVertexShaderOutput());
+      shaderFile->close();
+   }
+
    // Clear template for skinned
+   mTemplate->isInstanced = false;
    mTemplate->isSkinned = true;
    mTemplate->clearVertex();
     
@@ -307,6 +344,21 @@ void MaterialAsset::compileMaterial()
       shaderFile->close();
    }
 
+   // Clear template for skinned + instanced
+   mTemplate->isInstanced = true;
+   mTemplate->clearVertex();
+
+   // Vertex (Skinned + Instanced)
+   if (!Platform::isFile(mSkinnedInstancedVertexShaderPath))
+   {
+      Con::printf("Generating material skinned instanced vertex shader..");
+      Platform::createPath(mSkinnedInstancedVertexShaderPath);
+      shaderFile->openForWrite(mSkinnedInstancedVertexShaderPath);
+      shaderFile->writeLine((const U8*)mTemplate->getVertexShaderOutput());
+      shaderFile->close();
+   }
+   mTemplate->isInstanced = false;
+
    // Mat Shader = Pixel + Vertex
    Graphics::destroyShader(mMatShader);
    mMatShader = Graphics::getShader(mVertexShaderPath, mPixelShaderPath, false);
@@ -315,5 +367,13 @@ void MaterialAsset::compileMaterial()
    Graphics::destroyShader(mMatSkinnedShader);
    mMatSkinnedShader = Graphics::getShader(mSkinnedVertexShaderPath, mPixelShaderPath, false);
 
+   // Mat Instanced Shader = Pixel + Vertex (Instanced)
+   Graphics::destroyShader(mMatInstancedShader);
+   mMatInstancedShader = Graphics::getShader(mInstancedVertexShaderPath, mPixelShaderPath, false);
+
+   // Mat Skinned Instanced Shader = Pixel + Vertex (Skinned + Instanced)
+   Graphics::destroyShader(mMatSkinnedInstancedShader);
+   mMatSkinnedInstancedShader = Graphics::getShader(mSkinnedInstancedVertexShaderPath, mPixelShaderPath, false);
+
    SAFE_DELETE(shaderFile);
 }
\ No newline at end of file
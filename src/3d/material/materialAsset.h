@@ -71,6 +71,8 @@ protected:
    StringTableEntry                 mVertexShaderPath;
    StringTableEntry                 mPixelShaderPath;
    StringTableEntry                 mSkinnedVertexShaderPath;
+   StringTableEntry                 mInstancedVertexShaderPath;
+   StringTableEntry                 mSkinnedInstancedVertexShaderPath;
 
    Scene::MaterialTemplate*         mTemplate;
    StringTableEntry                 mTemplateFile;
@@ -78,6 +80,8 @@ protected:
 
    Graphics::Shader*                mMatShader;
    Graphics::Shader*                mMatSkinnedShader;
+   Graphics::Shader*                mMatInstancedShader;
+   Graphics::Shader*                mMatSkinnedInstancedShader;
 
 public:
    MaterialAsset();
@@ -100,6 +100,7 @@ namespace Scene
    MaterialTemplate::MaterialTemplate()
    {
       isSkinned = false;
+      isInstanced = false;
       clearVertex();
       clearPixel();
    }
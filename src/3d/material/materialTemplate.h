@@ -125,6 +125,7 @@ namespace Scene
          ~MaterialTemplate();
 
          bool isSkinned;
+         bool isInstanced;
          Rendering::UniformSet uniforms;
 
          void addObject(SimObject* obj);
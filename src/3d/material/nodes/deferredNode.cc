@@ -70,20 +70,47 @@ namespace Scene
 
       matTemplate->addVertexBody("    // Vertex Position");
       matTemplate->addVertexBody("    vec4 vertPosition = vec4(a_position, 1.0);");
-      matTemplate->addVertexBody("    mat4 modelTransform = u_model[0];");
+      if ( matTemplate->isInstanced )
+      {
+         // Automatic instancing packs each item's transform into i_data0-3.
+         matTemplate->addVertexInput("i_data0");
+         matTemplate->addVertexInput("i_data1");
+         matTemplate->addVertexInput("i_data2");
+         matTemplate->addVertexInput("i_data3");
+
+         matTemplate->addVertexBody("    mat4 modelTransform;");
+         matTemplate->addVertexBody("    modelTransform[0] = i_data0;");
+         matTemplate->addVertexBody("    modelTransform[1] = i_data1;");
+         matTemplate->addVertexBody("    modelTransform[2] = i_data2;");
+         matTemplate->addVertexBody("    modelTransform[3] = i_data3;");
+      } else {
+         matTemplate->addVertexBody("    mat4 modelTransform = u_model[0];");
+      }
 
       if ( matTemplate->isSkinned )
       {
          matTemplate->addVertexInput("a_indices");
          matTemplate->addVertexInput("a_weight");
+         matTemplate->addVertexHeader("#include <skinning.sh>");
+
+         // Bones come from the bone palette, instanced items carry their first bone in i_data4.
+         if ( matTemplate->isInstanced )
+            matTemplate->addVertexInput("i_data4");
 
          matTemplate->addVertexBody("");
          matTemplate->addVertexBody("    // Skinning");
-         matTemplate->addVertexBody("    modelTransform =    mul(u_model[int(a_indices[0])], a_weight[0]);");
-         matTemplate->addVertexBody("    modelTransform +=   mul(u_model[int(a_indices[1])], a_weight[1]);");
-         matTemplate->addVertexBody("    modelTransform +=   mul(u_model[int(a_indices[2])], a_weight[2]);");
-         matTemplate->addVertexBody("    modelTransform +=   mul(u_model[int(a_indices[3])], a_weight[3]); ");   
-         matTemplate->addVertexBody("    vertPosition =      mul(modelTransform, vertPosition);");
+         if ( matTemplate->isInstanced )
+            matTemplate->addVertexBody("    mat4 skinTransform = getSkinTransform(i_data4.x, a_indices, a_weight);");
+         else
+            matTemplate->addVertexBody("    mat4 skinTransform = getSkinTransform(u_bonePalette.x, a_indices, a_weight);");
+         matTemplate->addVertexBody("    vertPosition =      mul(skinTransform, vertPosition);");
+         matTemplate->addVertexBody("    vec4 vertNormal =     mul(skinTransform, vec4(a_normal.xyz, 0.0));");
+         matTemplate->addVertexBody("    vec4 vertTangent =    mul(skinTransform, vec4(a_tangent.xyz, 0.0));");
+         matTemplate->addVertexBody("    vec4 vertBitangent =  mul(skinTransform, vec4(a_bitangent.xyz, 0.0));");
+      } else {
+         matTemplate->addVertexBody("    vec4 vertNormal =     vec4(a_normal.xyz, 0.0);");
+         matTemplate->addVertexBody("    vec4 vertTangent =    vec4(a_tangent.xyz, 0.0);");
+         matTemplate->addVertexBody("    vec4 vertBitangent =  vec4(a_bitangent.xyz, 0.0);");
       }
 
       // World Position Offset Source
@@ -107,13 +134,26 @@ namespace Scene
 
       matTemplate->addVertexBody("");
       matTemplate->addVertexBody("    // Normal, Tangent, Bitangent");
-      matTemplate->addVertexBody("    v_normal = mul(modelTransform, vec4(a_normal.xyz, 0.0) ).xyz;");
-      matTemplate->addVertexBody("    v_tangent = mul(modelTransform, vec4(a_tangent.xyz, 0.0) ).xyz;");
-      matTemplate->addVertexBody("    v_bitangent = mul(modelTransform, vec4(a_bitangent.xyz, 0.0) ).xyz;");
+      if ( matTemplate->isInstanced )
+      {
+         matTemplate->addVertexBody("    v_normal = instMul(modelTransform, vertNormal).xyz;");
+         matTemplate->addVertexBody("    v_tangent = instMul(modelTransform, vertTangent).xyz;");
+         matTemplate->addVertexBody("    v_bitangent = instMul(modelTransform, vertBitangent).xyz;");
+      } else {
+         matTemplate->addVertexBody("    v_normal = mul(modelTransform, vertNormal).xyz;");
+         matTemplate->addVertexBody("    v_tangent = mul(modelTransform, vertTangent).xyz;");
+         matTemplate->addVertexBody("    v_bitangent = mul(modelTransform, vertBitangent).xyz;");
+      }
 
       matTemplate->addVertexBody("");
       matTemplate->addVertexBody("    // Output Final Vertex Position");
-      matTemplate->addVertexBody("    gl_Position = mul(u_modelViewProj, vertPosition);");
+      if ( matTemplate->isInstanced )
+      {
+         matTemplate->addVertexBody("    vertPosition = instMul(modelTransform, vertPosition);");
+         matTemplate->addVertexBody("    gl_Position = mul(u_viewProj, vertPosition);");
+      } else {
+         matTemplate->addVertexBody("    gl_Position = mul(u_modelViewProj, vertPosition);");
+      }
       matTemplate->addVertexBody("    v_position = gl_Position;");
    }
 
@@ -0,0 +1,201 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "bonePalette.h"
+#include "console/consoleInternal.h"
+#include "graphics/shaders.h"
+
+// Script bindings.
+#include "bonePalette_Binding.h"
+
+#include <bgfx.h>
+#include <bx/fpumath.h>
+
+namespace Rendering
+{
+   BonePaletteStats bonePaletteStats;
+
+   struct BoneRange
+   {
+      U32 first;
+      U32 count;
+   };
+
+   // Free ranges, sorted by first bone.
+   static Vector<BoneRange>   gFreeBoneRanges;
+
+   static F32                 gPaletteData[MaxPaletteBones * 16];
+   static bgfx::TextureHandle gPaletteTexture = BGFX_INVALID_HANDLE;
+   static bgfx::UniformHandle gPaletteSampler = BGFX_INVALID_HANDLE;
+   static bgfx::UniformHandle gPaletteParams  = BGFX_INVALID_HANDLE;
+   static U32                 gDirtyFirstRow  = 0xffffffff;
+   static U32                 gDirtyLastRow   = 0;
+
+   static void _markDirty(U32 firstBone, U32 boneCount)
+   {
+      if ( boneCount < 1 ) return;
+
+      U32 firstRow = (firstBone * BonePaletteTexelsPerBone) / BonePaletteTexWidth;
+      U32 lastRow  = ((firstBone + boneCount) * BonePaletteTexelsPerBone - 1) / BonePaletteTexWidth;
+      gDirtyFirstRow = getMin(gDirtyFirstRow, firstRow);
+      gDirtyLastRow  = getMax(gDirtyLastRow, lastRow);
+   }
+
+   void bonePaletteInit()
+   {
+      if ( bgfx::isValid(gPaletteTexture) ) return;
+
+      const U32 samplerFlags = 0
+            | BGFX_TEXTURE_MIN_POINT
+            | BGFX_TEXTURE_MAG_POINT
+            | BGFX_TEXTURE_MIP_POINT
+            | BGFX_TEXTURE_U_CLAMP
+            | BGFX_TEXTURE_V_CLAMP;
+
+      gPaletteTexture = bgfx::createTexture2D(BonePaletteTexWidth, BonePaletteTexHeight, 1, bgfx::TextureFormat::RGBA32F, samplerFlags);
+      gPaletteSampler = Graphics::Shader::getUniform("s_bonePalette", bgfx::UniformType::Int1);
+      gPaletteParams  = Graphics::Shader::getUniformVec4("u_bonePalette");
+
+      // Identity bones for meshes without a range of their own.
+      dMemset(gPaletteData, 0, sizeof(gPaletteData));
+      for ( U32 n = 0; n < MaxPaletteBonesPerMesh; ++n )
+         bx::mtxIdentity(&gPaletteData[n * 16]);
+      _markDirty(0, MaxPaletteBonesPerMesh);
+
+      gFreeBoneRanges.clear();
+      BoneRange all;
+      all.first = MaxPaletteBonesPerMesh;
+      all.count = MaxPaletteBones - MaxPaletteBonesPerMesh;
+      gFreeBoneRanges.push_back(all);
+
+      dMemset(&bonePaletteStats, 0, sizeof(bonePaletteStats));
+   }
+
+   void bonePaletteDestroy()
+   {
+      if ( bgfx::isValid(gPaletteTexture) )
+         bgfx::destroyTexture(gPaletteTexture);
+      gPaletteTexture.idx = bgfx::invalidHandle;
+
+      gFreeBoneRanges.clear();
+   }
+
+   U32 allocBoneRange(U32 boneCount)
+   {
+      if ( boneCount < 1 || boneCount > MaxPaletteBonesPerMesh )
+         return InvalidBoneRange;
+
+      // First fit.
+      for ( S32 n = 0; n < gFreeBoneRanges.size(); ++n )
+      {
+         BoneRange* range = &gFreeBoneRanges[n];
+         if ( range->count < boneCount )
+            continue;
+
+         U32 first = range->first;
+         range->first += boneCount;
+         range->count -= boneCount;
+         if ( range->count == 0 )
+            gFreeBoneRanges.erase(n);
+
+         bonePaletteStats.allocatedBones += boneCount;
+         return first;
+      }
+
+      bonePaletteStats.failedAllocations++;
+      return InvalidBoneRange;
+   }
+
+   void freeBoneRange(U32 firstBone, U32 boneCount)
+   {
+      if ( firstBone == InvalidBoneRange || boneCount < 1 )
+         return;
+
+      // Find where it goes and merge it with its neighbours.
+      S32 idx = 0;
+      while ( idx < gFreeBoneRanges.size() && gFreeBoneRanges[idx].first < firstBone )
+         idx++;
+
+      BoneRange range;
+      range.first = firstBone;
+      range.count = boneCount;
+      gFreeBoneRanges.insert(idx);
+      gFreeBoneRanges[idx] = range;
+
+      if ( idx + 1 < gFreeBoneRanges.size() && gFreeBoneRanges[idx].first + gFreeBoneRanges[idx].count == gFreeBoneRanges[idx + 1].first )
+      {
+         gFreeBoneRanges[idx].count += gFreeBoneRanges[idx + 1].count;
+         gFreeBoneRanges.erase(idx + 1);
+      }
+
+      if ( idx > 0 && gFreeBoneRanges[idx - 1].first + gFreeBoneRanges[idx - 1].count == gFreeBoneRanges[idx].first )
+      {
+         gFreeBoneRanges[idx - 1].count += gFreeBoneRanges[idx].count;
+         gFreeBoneRanges.erase(idx);
+      }
+
+      bonePaletteStats.allocatedBones -= boneCount;
+   }
+
+   F32* beginBoneUpdate(U32 firstBone)
+   {
+      AssertFatal(firstBone < MaxPaletteBones, "beginBoneUpdate - Bone out of range.");
+      return &gPaletteData[firstBone * 16];
+   }
+
+   const F32* getBones(U32 firstBone)
+   {
+      AssertFatal(firstBone < MaxPaletteBones, "getBones - Bone out of range.");
+      return &gPaletteData[firstBone * 16];
+   }
+
+   void endBoneUpdate(U32 firstBone, U32 boneCount)
+   {
+      _markDirty(firstBone, boneCount);
+   }
+
+   void flushBonePalette()
+   {
+      bonePaletteStats.uploadedRows = 0;
+      if ( !bgfx::isValid(gPaletteTexture) || gDirtyFirstRow > gDirtyLastRow )
+         return;
+
+      const U32 rowFloats = BonePaletteTexWidth * 4;
+      U32 rows = gDirtyLastRow - gDirtyFirstRow + 1;
+      bgfx::updateTexture2D(gPaletteTexture, 0, 0, gDirtyFirstRow, BonePaletteTexWidth, rows, 
+         bgfx::copy(&gPaletteData[gDirtyFirstRow * rowFloats], rows * rowFloats * sizeof(F32)));
+
+      bonePaletteStats.uploadedRows = rows;
+      gDirtyFirstRow = 0xffffffff;
+      gDirtyLastRow = 0;
+   }
+
+   void setBonePalette(U32 firstBone)
+   {
+      if ( firstBone == InvalidBoneRange )
+         firstBone = 0;
+
+      // Bone indices in the vertex data start at 1.
+      bgfx::setTexture(BonePaletteStage, gPaletteSampler, gPaletteTexture);
+      bgfx::setUniform(gPaletteParams, Point4F((F32)firstBone - 1.0f, (F32)BonePaletteTexWidth, (F32)BonePaletteTexHeight, 0.0f));
+   }
+}
@@ -0,0 +1,87 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _RENDERING_BONE_PALETTE_H_
+#define _RENDERING_BONE_PALETTE_H_
+
+#ifndef _RENDERINGCOMMON_H_
+#include "common.h"
+#endif
+
+#ifndef BGFX_H_HEADER_GUARD
+#include <bgfx.h>
+#endif
+
+namespace Rendering 
+{
+   // Bone Palette
+   // The skinning matrices of every skinned mesh live in one RGBA32F texture,
+   // four texels (one per matrix column) per bone. Meshes own a range of the 
+   // palette for as long as they're alive, write their bones into the CPU copy
+   // whenever they're posed and the rows that changed are uploaded once per 
+   // frame. Draws only pass their first bone, so skinned items can be batched 
+   // like anything else and shadow cascades reuse the same matrices.
+   //
+   // The first MaxPaletteBonesPerMesh bones are identity. Meshes that don't 
+   // get a range of their own point there and render in their bind pose.
+
+   const U32 BonePaletteTexWidth       = 1024;
+   const U32 BonePaletteTexHeight      = 64;
+   const U32 BonePaletteTexelsPerBone  = 4;
+   const U32 MaxPaletteBones           = (BonePaletteTexWidth * BonePaletteTexHeight) / BonePaletteTexelsPerBone;
+   const U32 MaxPaletteBonesPerMesh    = 256;
+   const U32 BonePaletteStage          = 15;
+   const U32 InvalidBoneRange          = 0xffffffff;
+
+   struct BonePaletteStats
+   {
+      U32 allocatedBones;
+      U32 uploadedRows;
+      U32 failedAllocations;
+   };
+
+   extern BonePaletteStats bonePaletteStats;
+
+   void  bonePaletteInit();
+   void  bonePaletteDestroy();
+
+   // Returns the first bone of a new range, or InvalidBoneRange if the palette is full.
+   U32   allocBoneRange(U32 boneCount);
+   void  freeBoneRange(U32 firstBone, U32 boneCount);
+
+   // Bones are written straight into the palette between begin/end. Writing
+   // is safe from worker threads as long as ranges aren't allocated or freed
+   // meanwhile, endBoneUpdate must be called from the main thread.
+   F32*  beginBoneUpdate(U32 firstBone);
+   void  endBoneUpdate(U32 firstBone, U32 boneCount);
+
+   const F32* getBones(U32 firstBone);
+
+   // Uploads any rows written since the last flush.
+   void  flushBonePalette();
+
+   // Binds the palette for the next submit. Skinned vertex shaders add their
+   // bone indices (which start at 1) to firstBone - 1.
+   void  setBonePalette(U32 firstBone);
+}
+
+#endif
@@ -0,0 +1,487 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "clusteredLighting.h"
+#include "console/consoleInternal.h"
+#include "graphics/shaders.h"
+#include "graphics/dgl.h"
+#include "platform/threads/workerPool.h"
+#include "3d/scene/core.h"
+
+// Script bindings.
+#include "clusteredLighting_Binding.h"
+
+#include <bgfx.h>
+#include <bx/fpumath.h>
+#include <bx/float4_t.h>
+
+namespace Rendering
+{
+   ClusteredLightingStats clusteredLightingStats;
+
+   static ClusteredLighting* gClusteredLightingInst = NULL;
+
+   // View space cluster bounds, four neighbouring clusters along x per entry.
+   // Clusters are indexed x + (y * ClusterTilesX) + (slice * ClusterTilesX * ClusterTilesY).
+   struct ClusterBoundsSIMD
+   {
+      bx::float4_t minX;
+      bx::float4_t minY;
+      bx::float4_t minZ;
+      bx::float4_t maxX;
+      bx::float4_t maxY;
+      bx::float4_t maxZ;
+   };
+   static ClusterBoundsSIMD gClusterBounds[ClusterCount / 4];
+
+   // View space sphere and the range of clusters it can touch.
+   struct ClusterLightInfo
+   {
+      F32   viewPos[3];
+      F32   radius;
+      U8    minX, maxX;
+      U8    minY, maxY;
+      U8    minZ, maxZ;
+      bool  visible;
+   };
+   static ClusterLightInfo gLightInfo[MaxClusterLights];
+
+   // Fixed size light list per cluster. Each slice is only written by the 
+   // job binning it so no locking is needed.
+   static U16 gClusterLights[ClusterCount][MaxLightsPerCluster];
+   static U16 gClusterLightCount[ClusterCount];
+   static U32 gSliceOverflow[ClusterSlices];
+
+   // Texture upload data.
+   static F32 gGridData[ClusterCount * 4];
+   static F32 gIndexData[MaxClusterIndices];
+   static F32 gLightData[MaxClusterLights * 8];
+
+   struct ClusterJobData
+   {
+      U32 lightCount;
+      F32 proj[16];
+      F32 nearPlane;
+      F32 farPlane;
+      F32 sliceScale;
+   };
+
+   static inline S32 _getSlice(F32 viewZ, F32 clusterNear, F32 sliceScale)
+   {
+      if ( viewZ <= clusterNear )
+         return 0;
+      return (S32)mFloor(mLog(viewZ / clusterNear) * sliceScale);
+   }
+
+   static inline S32 _getTile(F32 ndc, U32 tileCount)
+   {
+      return (S32)mFloor((ndc * 0.5f + 0.5f) * (F32)tileCount);
+   }
+
+   // Job: transform lights into view space, find the clusters they can touch
+   // and fill in the light data texture.
+   static void _prepareLights(void* data, U32 start, U32 end)
+   {
+      ClusterJobData* job = (ClusterJobData*)data;
+      const F32* proj = job->proj;
+
+      for (U32 n = start; n < end; ++n)
+      {
+         LightData* light = &lightList[n];
+         ClusterLightInfo* info = &gLightInfo[n];
+         info->visible = false;
+
+         // [PosX, PosY, PosZ, Radius] [ColorR, ColorG, ColorB, Attenuation]
+         F32* texel = &gLightData[n * 8];
+         texel[0] = light->position.x;
+         texel[1] = light->position.y;
+         texel[2] = light->position.z;
+         texel[3] = light->radius;
+         texel[4] = light->color[0];
+         texel[5] = light->color[1];
+         texel[6] = light->color[2];
+         texel[7] = light->attenuation;
+
+         if ( light->radius <= 0.0f )
+            continue;
+
+         bx::vec3MulMtx(info->viewPos, &light->position.x, viewMatrix);
+         info->radius = light->radius;
+
+         F32 z0 = info->viewPos[2] - info->radius;
+         F32 z1 = info->viewPos[2] + info->radius;
+         if ( z1 <= job->nearPlane || z0 >= job->farPlane )
+            continue;
+         z0 = getMax(z0, job->nearPlane);
+         z1 = getMin(z1, job->farPlane);
+
+         // Conservative screen extents of the sphere's view space box. x/z is
+         // monotonic in z so the extremes are at the nearest or farthest depth.
+         F32 x0 = info->viewPos[0] - info->radius;
+         F32 x1 = info->viewPos[0] + info->radius;
+         F32 y0 = info->viewPos[1] - info->radius;
+         F32 y1 = info->viewPos[1] + info->radius;
+
+         F32 ndcMinX = getMin(x0 / z0, x0 / z1) * proj[0] + proj[8];
+         F32 ndcMaxX = getMax(x1 / z0, x1 / z1) * proj[0] + proj[8];
+         F32 ndcMinY = getMin(y0 / z0, y0 / z1) * proj[5] + proj[9];
+         F32 ndcMaxY = getMax(y1 / z0, y1 / z1) * proj[5] + proj[9];
+         if ( ndcMaxX < -1.0f || ndcMinX > 1.0f || ndcMaxY < -1.0f || ndcMinY > 1.0f )
+            continue;
+
+         info->minX = (U8)mClamp(_getTile(ndcMinX, ClusterTilesX), 0, ClusterTilesX - 1);
+         info->maxX = (U8)mClamp(_getTile(ndcMaxX, ClusterTilesX), 0, ClusterTilesX - 1);
+         info->minY = (U8)mClamp(_getTile(ndcMinY, ClusterTilesY), 0, ClusterTilesY - 1);
+         info->maxY = (U8)mClamp(_getTile(ndcMaxY, ClusterTilesY), 0, ClusterTilesY - 1);
+         info->minZ = (U8)mClamp(_getSlice(z0, job->nearPlane, job->sliceScale), 0, ClusterSlices - 1);
+         info->maxZ = (U8)mClamp(_getSlice(z1, job->nearPlane, job->sliceScale), 0, ClusterSlices - 1);
+         info->visible = true;
+      }
+   }
+
+   // Job: bin every light into the clusters of a range of depth slices.
+   static void _binSlices(void* data, U32 start, U32 end)
+   {
+      ClusterJobData* job = (ClusterJobData*)data;
+      const bx::float4_t zero = bx::float4_zero();
+
+      for (U32 slice = start; slice < end; ++slice)
+      {
+         U32 sliceBase = slice * ClusterTilesX * ClusterTilesY;
+         dMemset(&gClusterLightCount[sliceBase], 0, sizeof(U16) * ClusterTilesX * ClusterTilesY);
+         gSliceOverflow[slice] = 0;
+
+         for (U32 n = 0; n < job->lightCount; ++n)
+         {
+            ClusterLightInfo* info = &gLightInfo[n];
+            if ( !info->visible || slice < info->minZ || slice > info->maxZ )
+               continue;
+
+            const bx::float4_t cx = bx::float4_splat(info->viewPos[0]);
+            const bx::float4_t cy = bx::float4_splat(info->viewPos[1]);
+            const bx::float4_t cz = bx::float4_splat(info->viewPos[2]);
+            const bx::float4_t r2 = bx::float4_splat(info->radius * info->radius);
+
+            for (U32 y = info->minY; y <= info->maxY; ++y)
+            {
+               U32 rowBase = sliceBase + (y * ClusterTilesX);
+
+               for (U32 g = info->minX / 4; g <= info->maxX / 4U; ++g)
+               {
+                  const ClusterBoundsSIMD& bounds = gClusterBounds[(rowBase / 4) + g];
+
+                  // Squared distance from the sphere center to four cluster boxes.
+                  const bx::float4_t dx = bx::float4_max(bx::float4_max(bx::float4_sub(bounds.minX, cx), bx::float4_sub(cx, bounds.maxX)), zero);
+                  const bx::float4_t dy = bx::float4_max(bx::float4_max(bx::float4_sub(bounds.minY, cy), bx::float4_sub(cy, bounds.maxY)), zero);
+                  const bx::float4_t dz = bx::float4_max(bx::float4_max(bx::float4_sub(bounds.minZ, cz), bx::float4_sub(cz, bounds.maxZ)), zero);
+                  const bx::float4_t d2 = bx::float4_madd(dx, dx, bx::float4_madd(dy, dy, bx::float4_mul(dz, dz)));
+
+                  union { bx::float4_t v; U32 u[4]; } hit;
+                  hit.v = bx::float4_cmple(d2, r2);
+                  if ( !bx::float4_test_any_xyzw(hit.v) )
+                     continue;
+
+                  for (U32 lane = 0; lane < 4; ++lane)
+                  {
+                     U32 x = (g * 4) + lane;
+                     if ( hit.u[lane] == 0 || x < info->minX || x > info->maxX )
+                        continue;
+
+                     U32 cluster = rowBase + x;
+                     if ( gClusterLightCount[cluster] < MaxLightsPerCluster )
+                     {
+                        gClusterLights[cluster][gClusterLightCount[cluster]] = (U16)n;
+                        gClusterLightCount[cluster]++;
+                     } else {
+                        gSliceOverflow[slice]++;
+                     }
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   ClusteredLighting* getClusteredLighting()
+   {
+      return gClusteredLightingInst;
+   }
+
+   void clusteredLightingInit()
+   {
+      if (gClusteredLightingInst != NULL ) return;
+      gClusteredLightingInst = new ClusteredLighting();
+   }
+
+   void clusteredLightingDestroy()
+   {
+      SAFE_DELETE(gClusteredLightingInst);
+   }
+
+   ClusteredLighting::ClusteredLighting()
+   {
+      mGridTexture.idx  = bgfx::invalidHandle;
+      mIndexTexture.idx = bgfx::invalidHandle;
+      mLightTexture.idx = bgfx::invalidHandle;
+
+      dMemset(mClusterProjection, 0, sizeof(mClusterProjection));
+      mClusterNear   = 0.0f;
+      mClusterFar    = 0.0f;
+      mSliceScale    = 0.0f;
+
+      mShader = Graphics::getShader("rendering/clusteredlight_vs.sc", "rendering/clusteredlight_fs.sc");
+      mDeferredLightView = Graphics::getView("DeferredLight", 1500);
+
+      dMemset(&clusteredLightingStats, 0, sizeof(clusteredLightingStats));
+
+      initTextures();
+
+      setRendering(true);
+   }
+
+   ClusteredLighting::~ClusteredLighting()
+   {
+      destroyTextures();
+   }
+
+   void ClusteredLighting::initTextures()
+   {
+      destroyTextures();
+
+      const U32 samplerFlags = 0
+            | BGFX_TEXTURE_MIN_POINT
+            | BGFX_TEXTURE_MAG_POINT
+            | BGFX_TEXTURE_MIP_POINT
+            | BGFX_TEXTURE_U_CLAMP
+            | BGFX_TEXTURE_V_CLAMP;
+
+      // Grid: [Offset, Count] per cluster, slices are laid out side by side.
+      mGridTexture   = bgfx::createTexture2D(ClusterTilesX * ClusterSlices, ClusterTilesY, 1, bgfx::TextureFormat::RGBA32F, samplerFlags);
+      mIndexTexture  = bgfx::createTexture2D(ClusterIndexTexWidth, ClusterIndexTexHeight, 1, bgfx::TextureFormat::R32F, samplerFlags);
+      mLightTexture  = bgfx::createTexture2D(ClusterLightTexWidth, ClusterLightTexHeight, 1, bgfx::TextureFormat::RGBA32F, samplerFlags);
+   }
+
+   void ClusteredLighting::destroyTextures()
+   {
+      if ( bgfx::isValid(mGridTexture) )
+         bgfx::destroyTexture(mGridTexture);
+      if ( bgfx::isValid(mIndexTexture) )
+         bgfx::destroyTexture(mIndexTexture);
+      if ( bgfx::isValid(mLightTexture) )
+         bgfx::destroyTexture(mLightTexture);
+
+      mGridTexture.idx  = bgfx::invalidHandle;
+      mIndexTexture.idx = bgfx::invalidHandle;
+      mLightTexture.idx = bgfx::invalidHandle;
+   }
+
+   void ClusteredLighting::buildClusterBounds()
+   {
+      static F32 minX[ClusterCount];
+      static F32 minY[ClusterCount];
+      static F32 minZ[ClusterCount];
+      static F32 maxX[ClusterCount];
+      static F32 maxY[ClusterCount];
+      static F32 maxZ[ClusterCount];
+
+      dMemcpy(mClusterProjection, projectionMatrix, sizeof(mClusterProjection));
+      mClusterNear   = nearPlane;
+      mClusterFar    = farPlane;
+      mSliceScale    = (F32)ClusterSlices / mLog(farPlane / nearPlane);
+
+      const F32* proj = mClusterProjection;
+      for (U32 slice = 0; slice < ClusterSlices; ++slice)
+      {
+         // Exponential slices keep clusters roughly cube shaped with depth.
+         F32 zNear = nearPlane * mPow(farPlane / nearPlane, (F32)slice / (F32)ClusterSlices);
+         F32 zFar  = nearPlane * mPow(farPlane / nearPlane, (F32)(slice + 1) / (F32)ClusterSlices);
+
+         for (U32 y = 0; y < ClusterTilesY; ++y)
+         {
+            // View space y over depth for the tile edges.
+            F32 slopeY0 = ((-1.0f + 2.0f * (F32)y / (F32)ClusterTilesY) - proj[9]) / proj[5];
+            F32 slopeY1 = ((-1.0f + 2.0f * (F32)(y + 1) / (F32)ClusterTilesY) - proj[9]) / proj[5];
+
+            for (U32 x = 0; x < ClusterTilesX; ++x)
+            {
+               F32 slopeX0 = ((-1.0f + 2.0f * (F32)x / (F32)ClusterTilesX) - proj[8]) / proj[0];
+               F32 slopeX1 = ((-1.0f + 2.0f * (F32)(x + 1) / (F32)ClusterTilesX) - proj[8]) / proj[0];
+
+               U32 cluster = x + (y * ClusterTilesX) + (slice * ClusterTilesX * ClusterTilesY);
+               minX[cluster] = getMin(slopeX0 * zNear, slopeX0 * zFar);
+               maxX[cluster] = getMax(slopeX1 * zNear, slopeX1 * zFar);
+               minY[cluster] = getMin(slopeY0 * zNear, slopeY0 * zFar);
+               maxY[cluster] = getMax(slopeY1 * zNear, slopeY1 * zFar);
+               minZ[cluster] = zNear;
+               maxZ[cluster] = zFar;
+            }
+         }
+      }
+
+      for (U32 g = 0; g < ClusterCount / 4; ++g)
+      {
+         U32 n = g * 4;
+         gClusterBounds[g].minX = bx::float4_ld(minX[n], minX[n + 1], minX[n + 2], minX[n + 3]);
+         gClusterBounds[g].minY = bx::float4_ld(minY[n], minY[n + 1], minY[n + 2], minY[n + 3]);
+         gClusterBounds[g].minZ = bx::float4_ld(minZ[n], minZ[n + 1], minZ[n + 2], minZ[n + 3]);
+         gClusterBounds[g].maxX = bx::float4_ld(maxX[n], maxX[n + 1], maxX[n + 2], maxX[n + 3]);
+         gClusterBounds[g].maxY = bx::float4_ld(maxY[n], maxY[n + 1], maxY[n + 2], maxY[n + 3]);
+         gClusterBounds[g].maxZ = bx::float4_ld(maxZ[n], maxZ[n + 1], maxZ[n + 2], maxZ[n + 3]);
+      }
+   }
+
+   void ClusteredLighting::binLights()
+   {
+      U32 lightCount = getMin((U32)lightList.size(), MaxClusterLights);
+
+      dMemset(&clusteredLightingStats, 0, sizeof(clusteredLightingStats));
+      clusteredLightingStats.lightCount = lightCount;
+      if ( (U32)lightList.size() > MaxClusterLights )
+      {
+         clusteredLightingStats.overflowCount += lightList.size() - MaxClusterLights;
+
+         // Once is enough, the stats keep count every frame.
+         static bool warned = false;
+         if ( !warned )
+         {
+            Con::warnf("[ClusteredLighting] %d lights in the scene, only the first %d are lit.", lightList.size(), MaxClusterLights);
+            warned = true;
+         }
+      }
+
+      if ( mClusterNear != nearPlane || mClusterFar != farPlane 
+         || dMemcmp(mClusterProjection, projectionMatrix, sizeof(mClusterProjection)) != 0 )
+         buildClusterBounds();
+
+      ClusterJobData job;
+      job.lightCount = lightCount;
+      job.nearPlane  = mClusterNear;
+      job.farPlane   = mClusterFar;
+      job.sliceScale = mSliceScale;
+      dMemcpy(job.proj, mClusterProjection, sizeof(job.proj));
+
+      WorkerPool::run(_prepareLights, &job, lightCount, 256);
+      WorkerPool::run(_binSlices, &job, ClusterSlices, 1);
+
+      // Pack the per cluster lists into one index list.
+      U32 indexCount = 0;
+      for (U32 slice = 0; slice < ClusterSlices; ++slice)
+      {
+         clusteredLightingStats.overflowCount += gSliceOverflow[slice];
+
+         for (U32 y = 0; y < ClusterTilesY; ++y)
+         {
+            for (U32 x = 0; x < ClusterTilesX; ++x)
+            {
+               U32 cluster = x + (y * ClusterTilesX) + (slice * ClusterTilesX * ClusterTilesY);
+               U32 count = gClusterLightCount[cluster];
+               if ( indexCount + count > MaxClusterIndices )
+               {
+                  clusteredLightingStats.overflowCount += (indexCount + count) - MaxClusterIndices;
+                  count = MaxClusterIndices - indexCount;
+               }
+
+               F32* texel = &gGridData[((y * ClusterTilesX * ClusterSlices) + (slice * ClusterTilesX) + x) * 4];
+               texel[0] = (F32)indexCount;
+               texel[1] = (F32)count;
+               texel[2] = 0.0f;
+               texel[3] = 0.0f;
+
+               for (U32 i = 0; i < count; ++i)
+               {
+                  gIndexData[indexCount] = (F32)gClusterLights[cluster][i];
+                  indexCount++;
+               }
+            }
+         }
+      }
+
+      for (U32 n = 0; n < lightCount; ++n)
+      {
+         if ( gLightInfo[n].visible )
+            clusteredLightingStats.visibleLights++;
+      }
+      clusteredLightingStats.indexCount = indexCount;
+
+      // Upload
+      bgfx::updateTexture2D(mGridTexture, 0, 0, 0, ClusterTilesX * ClusterSlices, ClusterTilesY, bgfx::copy(gGridData, sizeof(gGridData)));
+
+      if ( indexCount > 0 )
+      {
+         U32 rows = (indexCount + ClusterIndexTexWidth - 1) / ClusterIndexTexWidth;
+         bgfx::updateTexture2D(mIndexTexture, 0, 0, 0, ClusterIndexTexWidth, rows, bgfx::copy(gIndexData, rows * ClusterIndexTexWidth * sizeof(F32)));
+      }
+
+      if ( lightCount > 0 )
+      {
+         U32 rows = ((lightCount * 2) + ClusterLightTexWidth - 1) / ClusterLightTexWidth;
+         bgfx::updateTexture2D(mLightTexture, 0, 0, 0, ClusterLightTexWidth, rows, bgfx::copy(gLightData, rows * ClusterLightTexWidth * sizeof(F32) * 4));
+      }
+   }
+
+   void ClusteredLighting::preRender()
+   {
+      //
+   }
+
+   void ClusteredLighting::render()
+   {
+      if ( lightList.size() < 1 )
+      {
+         dMemset(&clusteredLightingStats, 0, sizeof(clusteredLightingStats));
+         return;
+      }
+
+      binLights();
+      if ( clusteredLightingStats.indexCount < 1 )
+         return;
+
+      // This projection matrix is used because its a full screen quad.
+      F32 proj[16];
+      bx::mtxOrtho(proj, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 100.0f);
+
+      // [TilesX, TilesY, Slices, Near Plane]
+      bgfx::setUniform(Graphics::Shader::getUniformVec4("u_clusterGrid"), Point4F((F32)ClusterTilesX, (F32)ClusterTilesY, (F32)ClusterSlices, mClusterNear));
+      // [Slice Scale, 0, 0, 0]
+      bgfx::setUniform(Graphics::Shader::getUniformVec4("u_clusterParams"), Point4F(mSliceScale, 0.0f, 0.0f, 0.0f));
+      // [Light Texture Width, Height, Index Texture Width, Height]
+      bgfx::setUniform(Graphics::Shader::getUniformVec4("u_clusterTexSize"), Point4F((F32)ClusterLightTexWidth, (F32)ClusterLightTexHeight, (F32)ClusterIndexTexWidth, (F32)ClusterIndexTexHeight));
+
+      // Depth, Normals, Grid, Indices, Lights
+      bgfx::setTexture(0, Graphics::Shader::getTextureUniform(0), Rendering::getDepthTexture());
+      bgfx::setTexture(1, Graphics::Shader::getTextureUniform(1), Rendering::getNormalTexture());
+      bgfx::setTexture(2, Graphics::Shader::getTextureUniform(2), mGridTexture);
+      bgfx::setTexture(3, Graphics::Shader::getTextureUniform(3), mIndexTexture);
+      bgfx::setTexture(4, Graphics::Shader::getTextureUniform(4), mLightTexture);
+
+      // Draw all point lights at once.
+      bgfx::setTransform(proj);
+      bgfx::setState(0 | BGFX_STATE_RGB_WRITE | BGFX_STATE_ALPHA_WRITE | BGFX_STATE_BLEND_ADD);
+      fullScreenQuad((F32)canvasWidth, (F32)canvasHeight);
+      bgfx::submit(mDeferredLightView->id, mShader->mProgram);
+   }
+
+   void ClusteredLighting::postRender()
+   {
+      //
+   }
+}
@@ -0,0 +1,113 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _CLUSTERED_LIGHTING_H_
+#define _CLUSTERED_LIGHTING_H_
+
+#ifndef _CONSOLEINTERNAL_H_
+#include "console/consoleInternal.h"
+#endif
+
+#ifndef _RENDERINGCOMMON_H_
+#include "common.h"
+#endif
+
+#ifndef BGFX_H_HEADER_GUARD
+#include <bgfx.h>
+#endif
+
+#ifndef _RENDERABLE_H_
+#include <3d/rendering/renderable.h>
+#endif
+
+namespace Rendering 
+{
+   // Clustered Lighting
+   // Point lights are binned on the CPU into a froxel grid: the screen is
+   // split into tiles and each tile into exponentially spaced depth slices.
+   // Binning runs on the worker pool, one depth slice per job, using SIMD 
+   // sphere/box tests against four clusters at a time.
+   //
+   // The grid (offset, count per cluster), the light index list and the light
+   // data are uploaded as textures and all point lights are shaded in a single
+   // full screen pass into the light buffer.
+
+   const U32 ClusterTilesX          = 16;
+   const U32 ClusterTilesY          = 8;
+   const U32 ClusterSlices          = 24;
+   const U32 ClusterCount           = ClusterTilesX * ClusterTilesY * ClusterSlices;
+   const U32 MaxClusterLights       = 4096;
+   const U32 MaxLightsPerCluster    = 128;
+
+   // Texture layouts
+   const U32 ClusterLightTexWidth   = 256;
+   const U32 ClusterLightTexHeight  = (MaxClusterLights * 2) / ClusterLightTexWidth;
+   const U32 ClusterIndexTexWidth   = 1024;
+   const U32 ClusterIndexTexHeight  = 64;
+   const U32 MaxClusterIndices      = ClusterIndexTexWidth * ClusterIndexTexHeight;
+
+   struct ClusteredLightingStats
+   {
+      U32 lightCount;
+      U32 visibleLights;
+      U32 indexCount;
+      U32 overflowCount;
+   };
+
+   extern ClusteredLightingStats clusteredLightingStats;
+
+   class ClusteredLighting : public virtual Renderable
+   {
+      protected:
+         Graphics::ViewTableEntry*  mDeferredLightView;
+         Graphics::Shader*          mShader;
+
+         bgfx::TextureHandle        mGridTexture;
+         bgfx::TextureHandle        mIndexTexture;
+         bgfx::TextureHandle        mLightTexture;
+
+         // Cluster bounds are only rebuilt when the projection changes.
+         F32                        mClusterProjection[16];
+         F32                        mClusterNear;
+         F32                        mClusterFar;
+         F32                        mSliceScale;
+
+         void initTextures();
+         void destroyTextures();
+         void buildClusterBounds();
+         void binLights();
+
+      public:
+         ClusteredLighting();
+         virtual ~ClusteredLighting();
+
+         virtual void preRender();
+         virtual void render();
+         virtual void postRender();
+   };
+
+   ClusteredLighting* getClusteredLighting();
+   void clusteredLightingInit();
+   void clusteredLightingDestroy();
+}
+
+#endif
@@ -0,0 +1,54 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _CONSOLE_H_
+#include "console/console.h"
+#endif
+
+#ifndef _CLUSTERED_LIGHTING_H_
+#include "clusteredLighting.h"
+#endif
+
+#include "c-interface/c-interface.h"
+
+ConsoleNamespaceFunction( Rendering, getClusteredLightingStats, ConsoleString, 1, 1, ("Returns \"lights visibleLights indices overflow\" for the last frame."))
+{
+   char* buffer = Con::getReturnBuffer(64);
+   dSprintf(buffer, 64, "%d %d %d %d", 
+      Rendering::clusteredLightingStats.lightCount,
+      Rendering::clusteredLightingStats.visibleLights,
+      Rendering::clusteredLightingStats.indexCount,
+      Rendering::clusteredLightingStats.overflowCount);
+   return buffer;
+}
+
+namespace Rendering{
+   extern "C" {
+      DLL_PUBLIC void Rendering_GetClusteredLightingStats(U32* lightCount, U32* visibleLights, U32* indexCount, U32* overflowCount)
+      {
+         *lightCount    = Rendering::clusteredLightingStats.lightCount;
+         *visibleLights = Rendering::clusteredLightingStats.visibleLights;
+         *indexCount    = Rendering::clusteredLightingStats.indexCount;
+         *overflowCount = Rendering::clusteredLightingStats.overflowCount;
+      }
+   }
+}
@@ -30,7 +30,13 @@
 #include "postRendering.h"
 #include "3d/scene/core.h"
 #include "3d/scene/camera.h"
+#include "3d/entity/meshLoader.h"
+#include "3d/entity/components/animationComponent.h"
 #include "3d/rendering/transparency.h"
+#include "3d/rendering/culling.h"
+#include "3d/rendering/renderQueue.h"
+#include "3d/rendering/clusteredLighting.h"
+#include "3d/rendering/bonePalette.h"
 
 #include <bgfx.h>
 #include <bx/fpumath.h>
@@ -48,8 +54,21 @@ namespace Rendering
    U32         canvasWidth = 0;
    U32         canvasHeight = 0;
    U32         canvasClearColor = 0;
-   RenderData  renderList[65535];
+   RenderData  renderList[MaxRenderData];
    U32         renderCount = 0;
+   RenderData* liveRenderList[MaxRenderData];
+   U32         liveRenderCount = 0;
+   bool        parallelFrameBuild = true;
+   FrameTimings frameTimings;
+
+   // Slot bookkeeping for createRenderData/destroyRenderData. Destroyed 
+   // slots wait in the pending list until compactRenderList() removes them
+   // from the live list, then they're handed back to the free list.
+   static U16  gRenderGeneration[MaxRenderData];
+   static U16  gRenderFreeList[MaxRenderData];
+   static U32  gRenderFreeCount = 0;
+   static U16  gRenderPendingList[MaxRenderData];
+   static U32  gRenderPendingCount = 0;
 
    struct BackBuffer
    {
@@ -150,14 +169,18 @@ namespace Rendering
       gRenderLayerViews.layer4 = Graphics::getView("RenderLayer4");
 
       deferredInit();
+      clusteredLightingInit();
       transparencyInit();
       postInit();
+      bonePaletteInit();
    }
 
    void destroy()
    {
+      bonePaletteDestroy();
       postDestroy();
       transparencyDestroy();
+      clusteredLightingDestroy();
       deferredDestroy();
 
       // Destroy backbuffers.
@@ -271,31 +294,286 @@ namespace Rendering
       Renderable::preRenderAll();
    }
 
+   static U32 gFrameNumber = 0;
+
+   // Instance buffers are freed once bgfx can no longer reference them.
+   struct InstanceBufferGarbage
+   {
+      InstanceBuffer*   buffer;
+      U32               frame;
+   };
+   static Vector<InstanceBufferGarbage> gInstanceBufferGarbage;
+   static bgfx::VertexDecl              gInstanceDecl;
+   static bool                          gInstanceDeclReady = false;
+
+   static void _initInstanceDecl()
+   {
+      if ( gInstanceDeclReady )
+         return;
+      gInstanceDeclReady = true;
+
+      // Attribute names don't matter, the stride is what bgfx uses for 
+      // instance data.
+      gInstanceDecl.begin()
+         .add(bgfx::Attrib::TexCoord3, 4, bgfx::AttribType::Float)
+         .add(bgfx::Attrib::TexCoord4, 4, bgfx::AttribType::Float)
+         .add(bgfx::Attrib::TexCoord5, 4, bgfx::AttribType::Float)
+         .add(bgfx::Attrib::TexCoord6, 4, bgfx::AttribType::Float)
+         .add(bgfx::Attrib::TexCoord7, 4, bgfx::AttribType::Float)
+         .end();
+   }
+
+   InstanceBuffer* createStaticInstanceBuffer(const InstanceData* data, U32 count)
+   {
+      _initInstanceDecl();
+
+      InstanceBuffer* buffer = new InstanceBuffer();
+      dMemset(buffer, 0, sizeof(InstanceBuffer));
+      buffer->isDynamic          = false;
+      buffer->count              = count;
+      buffer->capacity           = count;
+      buffer->dynamicBuffer.idx  = bgfx::invalidHandle;
+      buffer->staticBuffer       = bgfx::createVertexBuffer(bgfx::copy(data, count * sizeof(InstanceData)), gInstanceDecl);
+      return buffer;
+   }
+
+   InstanceBuffer* createDynamicInstanceBuffer(U32 capacity)
+   {
+      _initInstanceDecl();
+
+      InstanceBuffer* buffer = new InstanceBuffer();
+      dMemset(buffer, 0, sizeof(InstanceBuffer));
+      buffer->isDynamic          = true;
+      buffer->capacity           = capacity;
+      buffer->data[0]            = new InstanceData[capacity];
+      buffer->data[1]            = new InstanceData[capacity];
+      buffer->staticBuffer.idx   = bgfx::invalidHandle;
+      buffer->dynamicBuffer      = bgfx::createDynamicVertexBuffer(capacity, gInstanceDecl);
+      return buffer;
+   }
+
+   void destroyInstanceBuffer(InstanceBuffer* buffer)
+   {
+      if ( buffer == NULL )
+         return;
+
+      if ( bgfx::isValid(buffer->staticBuffer) )
+         bgfx::destroyVertexBuffer(buffer->staticBuffer);
+      if ( bgfx::isValid(buffer->dynamicBuffer) )
+         bgfx::destroyDynamicVertexBuffer(buffer->dynamicBuffer);
+      buffer->staticBuffer.idx  = bgfx::invalidHandle;
+      buffer->dynamicBuffer.idx = bgfx::invalidHandle;
+
+      // The renderer thread may still read the last frame by reference.
+      InstanceBufferGarbage garbage;
+      garbage.buffer = buffer;
+      garbage.frame  = gFrameNumber;
+      gInstanceBufferGarbage.push_back(garbage);
+   }
+
+   static void _freeInstanceBuffers()
+   {
+      for ( S32 n = 0; n < gInstanceBufferGarbage.size(); ++n )
+      {
+         InstanceBufferGarbage& garbage = gInstanceBufferGarbage[n];
+         if ( gFrameNumber - garbage.frame < 2 )
+            continue;
+
+         SAFE_DELETE_ARRAY(garbage.buffer->data[0]);
+         SAFE_DELETE_ARRAY(garbage.buffer->data[1]);
+         SAFE_DELETE(garbage.buffer);
+         gInstanceBufferGarbage.erase_fast(n);
+         n--;
+      }
+   }
+
+   InstanceData* beginInstanceUpdate(InstanceBuffer* buffer)
+   {
+      AssertFatal(buffer->isDynamic, "Rendering::beginInstanceUpdate - static instance buffers can't be updated.");
+      return buffer->data[buffer->writeIndex];
+   }
+
+   void endInstanceUpdate(InstanceBuffer* buffer, U32 count)
+   {
+      buffer->count = getMin(count, buffer->capacity);
+      buffer->dirty = true;
+   }
+
+   // Hands the latest write to bgfx and flips to the other half. Half 
+   // written this frame won't be touched again until bgfx is done with it.
+   static void _flushInstanceBuffer(InstanceBuffer* buffer)
+   {
+      if ( !buffer->isDynamic || !buffer->dirty )
+         return;
+
+      if ( buffer->count > 0 )
+         bgfx::updateDynamicVertexBuffer(buffer->dynamicBuffer, 0, bgfx::makeRef(buffer->data[buffer->writeIndex], buffer->count * sizeof(InstanceData)));
+
+      buffer->writeIndex = 1 - buffer->writeIndex;
+      buffer->dirty = false;
+   }
+
+   static void _setInstanceBuffer(InstanceBuffer* buffer)
+   {
+      if ( buffer->isDynamic )
+         bgfx::setInstanceDataBuffer(buffer->dynamicBuffer, 0, buffer->count);
+      else
+         bgfx::setInstanceDataBuffer(buffer->staticBuffer, 0, buffer->count);
+   }
+
+   void runFrameJob(WorkerPool::JobFunction func, void* data, U32 count, U32 grainSize)
+   {
+      if ( parallelFrameBuild )
+         WorkerPool::run(func, data, count, grainSize);
+      else
+         func(data, 0, count);
+   }
+
+   static inline F32 _elapsedMS(U64 start, U64 end)
+   {
+      return (F32)((F64)(end - start) * 1000.0 / (F64)bx::getHPFrequency());
+   }
+
+   // Instance data buffers for the render queue. They're allocated on the 
+   // main thread then filled by _packInstanceData on the worker pool.
+   static const bgfx::InstanceDataBuffer* gBatchBuffers[65535];
+   static const bgfx::InstanceDataBuffer* gInstanceBuffers[65535];
+
+   // Batched items get their transform in i_data0-3, skinned items also get
+   // their first palette bone in i_data4.
+   static inline U16 _getBatchStride(RenderData* item)
+   {
+      return item->isSkinned ? sizeof(F32) * 20 : sizeof(F32) * 16;
+   }
+
+   static void _packInstanceData(void* data, U32 start, U32 end)
+   {
+      const U16 transformSize = sizeof(F32) * 16;
+      const U16 instanceStride = sizeof(Rendering::InstanceData);
+
+      for (U32 n = start; n < end; ++n)
+      {
+         // Automatic Instancing: one transform per item in the batch.
+         const bgfx::InstanceDataBuffer* idb = gBatchBuffers[n];
+         if ( idb != NULL )
+         {
+            const U16 batchStride = _getBatchStride(renderQueue[n]);
+            for(U32 i = 0; i < renderQueueBatch[n]; ++i)
+            {
+               RenderData* batchItem = renderQueue[n + i];
+               dMemcpy(&idb->data[i * batchStride], batchItem->transformTable, transformSize);
+               if ( batchItem->isSkinned )
+               {
+                  // Same mapping as setBonePalette(), items without a range
+                  // fall back to the start of the palette.
+                  U32 firstBone = batchItem->boneOffset == InvalidBoneRange ? 0 : batchItem->boneOffset;
+                  F32 boneOffset[4] = { (F32)firstBone - 1.0f, 0.0f, 0.0f, 0.0f };
+                  dMemcpy(&idb->data[i * batchStride + transformSize], boneOffset, sizeof(boneOffset));
+               }
+            }
+         }
+
+         // Instancing Data
+         idb = gInstanceBuffers[n];
+         if ( idb != NULL )
+         {
+            Vector<InstanceData>* instances = renderQueue[n]->instances;
+            dMemcpy(idb->data, instances->address(), instances->size() * instanceStride);
+         }
+      }
+   }
+
    // Process Frame
    void render()
    {
+      U64 frameStart = bx::getHPCounter();
+
+      gFrameNumber++;
+      _freeInstanceBuffers();
+      MeshLoader::update();
+      Scene::updateAnimations();
+      flushBonePalette();
+      compactRenderList();
       preRender();
+      U64 stageEnd = bx::getHPCounter();
+      frameTimings.preRender = _elapsedMS(frameStart, stageEnd);
+
+      // Build the list of items visible to the camera and sort it.
+      U64 stageStart = stageEnd;
+      cullRenderList();
+      stageEnd = bx::getHPCounter();
+      frameTimings.cull = _elapsedMS(stageStart, stageEnd);
+
+      stageStart = stageEnd;
+      buildRenderQueue(visibleList, visibleCount);
+      stageEnd = bx::getHPCounter();
+      frameTimings.queue = _elapsedMS(stageStart, stageEnd);
+
+      // Allocate instance data for the frame. Batches that don't fit in this 
+      // frame's instance buffer fall back to drawing each item on its own.
+      stageStart = stageEnd;
+      for (U32 n = 0; n < renderQueueCount; ++n)
+      {
+         RenderData* item = renderQueue[n];
+         gBatchBuffers[n] = NULL;
+         gInstanceBuffers[n] = NULL;
 
-      // Render everything in the render list.
-      for (U32 n = 0; n < renderCount; ++n)
+         if ( renderQueueBatch[n] > 1 )
+         {
+            const U16 batchStride = _getBatchStride(item);
+            if ( bgfx::checkAvailInstanceDataBuffer(renderQueueBatch[n], batchStride) )
+               gBatchBuffers[n] = bgfx::allocInstanceDataBuffer(renderQueueBatch[n], batchStride);
+            else
+               renderQueueBatch[n] = 1;
+         }
+
+         if ( item->instanceBuffer != NULL )
+            _flushInstanceBuffer(item->instanceBuffer);
+         else if ( item->instances && item->instances->size() > 0 )
+            gInstanceBuffers[n] = bgfx::allocInstanceDataBuffer(item->instances->size(), sizeof(Rendering::InstanceData));
+      }
+      runFrameJob(_packInstanceData, NULL, renderQueueCount, 256);
+      stageEnd = bx::getHPCounter();
+      frameTimings.prepare = _elapsedMS(stageStart, stageEnd);
+
+      // Render everything in the queue.
+      stageStart = stageEnd;
+      U32 batchSize = 1;
+      Graphics::ViewTableEntry* seqView = NULL;
+      for (U32 n = 0; n < renderQueueCount; n += batchSize)
       {
-         RenderData* item = &renderList[n];
-         if ( item->deleted ) continue;
+         RenderData* item = renderQueue[n];
+         bgfx::ProgramHandle shader = item->shader;
 
-         // Transform Table.
-         bgfx::setTransform(item->transformTable, item->transformCount);
+         // bgfx takes the sequence number at submit, so switching back once
+         // the queue moves on leaves other submits to the view alone.
+         if ( item->view != seqView )
+         {
+            if ( seqView != NULL )
+               bgfx::setViewSeq(seqView->id, false);
+            seqView = item->view;
+            bgfx::setViewSeq(seqView->id, true);
+         }
 
-         // Instancing Data
-         if ( item->instances && item->instances->size() > 0 )
+         batchSize = renderQueueBatch[n];
+         if ( batchSize > 1 )
          {
-            U16 stride = sizeof(Rendering::InstanceData);
-            const bgfx::InstanceDataBuffer* idb = bgfx::allocInstanceDataBuffer(item->instances->size(), stride);
+            bgfx::setInstanceDataBuffer(gBatchBuffers[n]);
+            shader = item->instancedShader;
+         } else {
+            // Transform Table.
+            bgfx::setTransform(item->transformTable, item->transformCount);
+         }
 
-            for(S32 i = 0; i < item->instances->size(); ++i)
-               dMemcpy(&idb->data[i * stride], &item->instances->at(i), stride);
+         // Bone Palette
+         if ( item->isSkinned )
+            setBonePalette(item->boneOffset);
 
-            bgfx::setInstanceDataBuffer(idb);
-         }
+         // Instancing Data
+         if ( item->instanceBuffer != NULL )
+            _setInstanceBuffer(item->instanceBuffer);
+         else if ( gInstanceBuffers[n] != NULL )
+            bgfx::setInstanceDataBuffer(gInstanceBuffers[n]);
 
          // Vertex/Index Buffers (Optionally Dynamic)
          if ( item->isDynamic )
@@ -334,14 +612,22 @@ namespace Rendering
          // Set render states.
          bgfx::setState(item->state, item->stateRGBA);
 
-         // Submit primitive
-         bgfx::submit(item->view->id, item->shader);
+         // Submit primitive. The view draws in queue order, see buildRenderQueue().
+         bgfx::submit(item->view->id, shader);
       }
+      if ( seqView != NULL )
+         bgfx::setViewSeq(seqView->id, false);
+      stageEnd = bx::getHPCounter();
+      frameTimings.submit = _elapsedMS(stageStart, stageEnd);
 
       // Give Renderable classes a chance to render.
+      stageStart = stageEnd;
       Renderable::renderAll();
 
       postRender();
+      stageEnd = bx::getHPCounter();
+      frameTimings.renderables = _elapsedMS(stageStart, stageEnd);
+      frameTimings.total = _elapsedMS(frameStart, stageEnd);
    }
 
    void postRender()
@@ -358,35 +644,51 @@ namespace Rendering
 
    RenderData* createRenderData()
    {
-      RenderData* item = NULL;
-      for ( U32 n = 0; n < renderCount; ++n )
+      U32 index = 0;
+      if ( gRenderFreeCount > 0 )
       {
-         if ( renderList[n].deleted )
-         {
-            item = &renderList[n];
-            break;
-         }
-      }
-
-      if ( item == NULL )
+         index = gRenderFreeList[--gRenderFreeCount];
+      } 
+      else if ( renderCount < MaxRenderData )
       {
-         item = &renderList[renderCount];
+         index = renderCount;
          renderCount++;
+      } 
+      else 
+      {
+         AssertFatal(false, "Rendering::createRenderData - Out of render data slots.");
+         Con::errorf("Rendering::createRenderData - Out of render data slots.");
+         return NULL;
       }
 
+      RenderData* item = &renderList[index];
+      liveRenderList[liveRenderCount] = item;
+      liveRenderCount++;
+
       // Reset Values
       item->deleted                 = false;
       item->castShadow              = false;
       item->isDynamic               = false;
+      item->hasBounds               = false;
       item->instances               = NULL;
+      item->instanceBuffer          = NULL;
       item->dynamicIndexBuffer.idx  = bgfx::invalidHandle;
       item->dynamicVertexBuffer.idx = bgfx::invalidHandle;
       item->indexBuffer.idx         = bgfx::invalidHandle;
       item->vertexBuffer.idx        = bgfx::invalidHandle;
+      item->triangleCount           = 0;
+      item->lods                    = NULL;
+      item->lodCount                = 0;
+      item->lodLevel                = 0;
       item->shader.idx              = bgfx::invalidHandle;
+      item->instancedShader.idx     = bgfx::invalidHandle;
       item->transformCount          = 0;
       item->transformTable          = NULL;
+      item->isSkinned               = false;
+      item->boneOffset              = InvalidBoneRange;
+      item->boneCount               = 0;
       item->textures                = NULL;
+      item->uniforms.uniforms       = NULL;
       item->view                    = 0;
       item->stateRGBA               = 0;
 
@@ -399,67 +701,74 @@ namespace Rendering
       return item;
    }
 
-   Vector<LightData> lightList;
-   Vector<LightData*> getNearestLights(Point3F position)
+   void destroyRenderData(RenderData* item)
    {
-      //U64 hpFreq = bx::getHPFrequency() / 1000000.0; // micro-seconds.
-      //U64 startTime = bx::getHPCounter();
+      if ( item == NULL || item->deleted )
+         return;
 
-      Vector<LightData*> results;
-      F32 lightDistance[4];
+      U32 index = (U32)(item - renderList);
+      AssertFatal(index < renderCount, "Rendering::destroyRenderData - Item is not in the render list.");
 
-      U32 n;
-      S32 i;
-      U32 lightCount = lightList.size();
-      for ( n = 0; n < lightCount; ++n )
-      {
-         // Get distance.
-         Point3F lightVector = position - lightList[n].position;
-         F32 distToLight = lightVector.len();
+      item->deleted = true;
+      gRenderGeneration[index]++;
+      gRenderPendingList[gRenderPendingCount] = (U16)index;
+      gRenderPendingCount++;
+   }
 
-         // We need a max of 4 lights
-         if ( results.size() < 4 )
-         {
-            results.push_back(&lightList[n]);
-            lightDistance[results.size() - 1] = distToLight;
-            continue;
-         }
+   void destroyRenderData(RenderHandle handle)
+   {
+      destroyRenderData(getRenderData(handle));
+   }
 
-         // Check for shortest distance.
-         for( i = 0; i < 4; ++i )
-         {
-            if ( lightDistance[i] < distToLight )
-               continue;
+   RenderHandle getRenderHandle(RenderData* item)
+   {
+      RenderHandle handle;
+      if ( item == NULL || item->deleted )
+         return handle;
 
-            lightDistance[i] = distToLight;
-            results[i] = &lightList[n];
-            break;
-         }
-      }
+      handle.index = (U16)(item - renderList);
+      handle.generation = gRenderGeneration[handle.index];
+      return handle;
+   }
+
+   RenderData* getRenderData(RenderHandle handle)
+   {
+      if ( handle.index >= renderCount )
+         return NULL;
 
-      //U64 endTime = bx::getHPCounter();
-      //Con::printf("getNearestLights took: %d microseconds. (1 microsecond = 0.001 milliseconds)", (U32)((endTime - startTime) / hpFreq));
+      RenderData* item = &renderList[handle.index];
+      if ( item->deleted || gRenderGeneration[handle.index] != handle.generation )
+         return NULL;
 
-      return results;
+      return item;
    }
 
-   // Debug Function
-   void testGetNearestLights()
+   void compactRenderList()
    {
-      for( U32 n = 0; n < 10000; ++n )
+      if ( gRenderPendingCount < 1 )
+         return;
+
+      // Drop destroyed items from the live list, keeping the order of the rest.
+      U32 liveCount = 0;
+      for ( U32 n = 0; n < liveRenderCount; ++n )
       {
-         Rendering::LightData lData;
-         lData.position = Point3F(mRandF(-10000, 10000), mRandF(-10000, 10000), mRandF(-10000, 10000));
-         lightList.push_back(lData);
+         RenderData* item = liveRenderList[n];
+         if ( item->deleted ) continue;
+
+         liveRenderList[liveCount] = item;
+         liveCount++;
       }
-      Vector<LightData*> nearestLights = getNearestLights(Point3F(0, 0, 0));
-      for( S32 n = 0; n < nearestLights.size(); ++n )
+      liveRenderCount = liveCount;
+
+      // The slots are no longer referenced by the live list so they can be reused.
+      for ( U32 n = 0; n < gRenderPendingCount; ++n )
       {
-         Con::printf("Nearest Light: %f %f %f", nearestLights[n]->position.x, nearestLights[n]->position.y, nearestLights[n]->position.z);
+         gRenderFreeList[gRenderFreeCount] = gRenderPendingList[n];
+         gRenderFreeCount++;
       }
-      lightList.clear();
+      gRenderPendingCount = 0;
    }
-   
+
    Point2I worldToScreen(Point3F worldPos)
    {
       F32 viewProjMatrix[16];
@@ -44,6 +44,14 @@
 #include "graphics/core.h"
 #endif
 
+#ifndef _MBOX_H_
+#include "math/mBox.h"
+#endif
+
+#ifndef _PLATFORM_THREADS_WORKER_POOL_H_
+#include "platform/threads/workerPool.h"
+#endif
+
 #include "memory/safeDelete.h"
 
 namespace Rendering 
@@ -168,8 +176,8 @@ namespace Rendering
       F32      attenuation;
    };
 
+   // Lights are allocated and indexed through lightGrid.h
    extern Vector<LightData> lightList;
-   Vector<LightData*> getNearestLights(Point3F position);
 
    struct DLL_PUBLIC InstanceData
    {
@@ -180,6 +188,39 @@ namespace Rendering
       Point4F i_data4;
    };
 
+   // Persistent Instance Buffers
+   // Static buffers are uploaded once and stay on the GPU. Dynamic buffers 
+   // are double buffered: producers write straight into the back buffer 
+   // between beginInstanceUpdate/endInstanceUpdate and the render loop hands
+   // it to bgfx by reference, so instance data is never copied on our side.
+   struct DLL_PUBLIC InstanceBuffer
+   {
+      bool                             isDynamic;
+      bool                             dirty;
+      U32                              count;
+      U32                              capacity;
+      U32                              writeIndex;
+      InstanceData*                    data[2];
+      bgfx::VertexBufferHandle         staticBuffer;
+      bgfx::DynamicVertexBufferHandle  dynamicBuffer;
+   };
+
+   InstanceBuffer*   createStaticInstanceBuffer(const InstanceData* data, U32 count);
+   InstanceBuffer*   createDynamicInstanceBuffer(U32 capacity);
+   void              destroyInstanceBuffer(InstanceBuffer* buffer);
+   InstanceData*     beginInstanceUpdate(InstanceBuffer* buffer);
+   void              endInstanceUpdate(InstanceBuffer* buffer, U32 count);
+
+   // One level of a LOD chain. Levels share their vertex buffer and only
+   // swap the index buffer. error is how far the level strays from the full
+   // mesh, relative to the diagonal of the item's bounds.
+   struct DLL_PUBLIC RenderLOD
+   {
+      bgfx::IndexBufferHandle          indexBuffer;
+      U32                              triangleCount;
+      F32                              error;
+   };
+
    // 
    struct DLL_PUBLIC RenderData
    {
@@ -187,19 +228,47 @@ namespace Rendering
       bool                             castShadow;
       bool                             isDynamic;
 
+      // World space bounds used for culling. Items without bounds are
+      // always rendered.
+      bool                             hasBounds;
+      Box3F                            bounds;
+
       bgfx::DynamicVertexBufferHandle  dynamicVertexBuffer;
       bgfx::DynamicIndexBufferHandle   dynamicIndexBuffer;
       bgfx::VertexBufferHandle         vertexBuffer;
       bgfx::IndexBufferHandle          indexBuffer;
 
+      // Triangles per draw (or per instance), only used for stats.
+      U32                              triangleCount;
+
+      // Optional LOD chain, finest first. Culling picks lodLevel for every
+      // visible item and copies that level's index buffer and triangle 
+      // count over the ones above, see culling.h.
+      RenderLOD*                       lods;
+      U8                               lodCount;
+      U8                               lodLevel;
+
       bgfx::ProgramHandle              shader;
 
+      // Optional instanced variant of shader. Items that share geometry,
+      // shader, textures, uniforms and state are drawn in a single submit
+      // with their transforms packed into an instance data buffer.
+      bgfx::ProgramHandle              instancedShader;
+
       Vector<InstanceData>*            instances;
+      InstanceBuffer*                  instanceBuffer;
       Vector<TextureData>*             textures;
       UniformSet                       uniforms;
 
       F32*                             transformTable;
       U8                               transformCount;
+
+      // Skinned items read boneCount bones from the bone palette starting
+      // at boneOffset, see bonePalette.h.
+      bool                             isSkinned;
+      U32                              boneOffset;
+      U32                              boneCount;
+
       Graphics::ViewTableEntry*        view;
       U64                              state;
       U32                              stateRGBA;
@@ -210,9 +279,39 @@ namespace Rendering
          return &textures->front();
       }
    };
-   extern RenderData renderList[65535];
-   extern U32 renderCount;
-   RenderData* createRenderData();
+
+   // Render data lives in fixed slots so pointers stay put while an item is
+   // alive. Free slots are recycled through a free list and live items are
+   // tracked in a packed list which is compacted once per frame, so the cull 
+   // and submit loops only walk live entries.
+   //
+   // Slots are reused, so anything that holds on to an item across frames 
+   // should keep a RenderHandle. Each destroy bumps the slot generation and 
+   // stale handles resolve to NULL instead of someone else's item.
+   struct DLL_PUBLIC RenderHandle
+   {
+      U16 index;
+      U16 generation;
+
+      RenderHandle()
+      {
+         index = 0xffff;
+         generation = 0;
+      }
+   };
+
+   const U32 MaxRenderData = 65535;
+   extern RenderData    renderList[MaxRenderData];
+   extern U32           renderCount;
+   extern RenderData*   liveRenderList[MaxRenderData];
+   extern U32           liveRenderCount;
+
+   RenderData*    createRenderData();
+   void           destroyRenderData(RenderData* item);
+   void           destroyRenderData(RenderHandle handle);
+   RenderHandle   getRenderHandle(RenderData* item);
+   RenderData*    getRenderData(RenderHandle handle);
+   void           compactRenderList();
 
    bgfx::FrameBufferHandle getBackBuffer();
    bgfx::TextureHandle     getColorTexture();
@@ -251,6 +350,28 @@ namespace Rendering
    void render();
    void postRender();
 
+   // Frame Build
+   // Culling, sort key generation and instance data packing can be split 
+   // across the worker pool. bgfx calls are always made from the main thread.
+   // Timings are in milliseconds for the last frame.
+   struct FrameTimings
+   {
+      F32 preRender;
+      F32 cull;
+      F32 queue;
+      F32 prepare;
+      F32 submit;
+      F32 renderables;
+      F32 total;
+   };
+
+   extern bool          parallelFrameBuild;
+   extern FrameTimings  frameTimings;
+
+   // Runs a frame build job on the worker pool, or on the calling thread when
+   // parallelFrameBuild is off. Jobs must not call bgfx.
+   void runFrameJob(WorkerPool::JobFunction func, void* data, U32 count, U32 grainSize);
+
    // Debug Functions
    void testGetNearestLights();
 }
@@ -0,0 +1,261 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "culling.h"
+#include "console/consoleInternal.h"
+#include "graphics/core.h"
+
+// Script bindings.
+#include "culling_Binding.h"
+
+#include <bgfx.h>
+#include <bx/fpumath.h>
+#include <bx/float4_t.h>
+
+namespace Rendering
+{
+   Frustum     cameraFrustum;
+   RenderData* visibleList[65535];
+   U32         visibleCount = 0;
+   U32         culledCount = 0;
+   F32         lodPixelError = 1.0f;
+
+   // Frustum planes transposed so four planes are tested per instruction.
+   struct FrustumSIMD
+   {
+      bx::float4_t x[2];
+      bx::float4_t y[2];
+      bx::float4_t z[2];
+      bx::float4_t w[2];
+      bx::float4_t absX[2];
+      bx::float4_t absY[2];
+      bx::float4_t absZ[2];
+   };
+
+   static void _loadFrustumSIMD(FrustumSIMD* out, const Frustum& frustum)
+   {
+      // Planes 4 and 5 are repeated to fill out the second group of four.
+      static const U32 order[8] = { 0, 1, 2, 3, 4, 5, 4, 5 };
+
+      for ( U32 g = 0; g < 2; ++g )
+      {
+         const F32* p0 = frustum.planes[order[g * 4 + 0]];
+         const F32* p1 = frustum.planes[order[g * 4 + 1]];
+         const F32* p2 = frustum.planes[order[g * 4 + 2]];
+         const F32* p3 = frustum.planes[order[g * 4 + 3]];
+
+         out->x[g]    = bx::float4_ld(p0[0], p1[0], p2[0], p3[0]);
+         out->y[g]    = bx::float4_ld(p0[1], p1[1], p2[1], p3[1]);
+         out->z[g]    = bx::float4_ld(p0[2], p1[2], p2[2], p3[2]);
+         out->w[g]    = bx::float4_ld(p0[3], p1[3], p2[3], p3[3]);
+         out->absX[g] = bx::float4_abs(out->x[g]);
+         out->absY[g] = bx::float4_abs(out->y[g]);
+         out->absZ[g] = bx::float4_abs(out->z[g]);
+      }
+   }
+
+   // A box is outside if it's entirely behind any one plane. The projected
+   // radius of the box onto a plane normal is dot(abs(n), extents).
+   static inline bool _isBoxOutside(const FrustumSIMD& frustum, const Box3F& box)
+   {
+      const bx::float4_t cx = bx::float4_splat((box.minExtents.x + box.maxExtents.x) * 0.5f);
+      const bx::float4_t cy = bx::float4_splat((box.minExtents.y + box.maxExtents.y) * 0.5f);
+      const bx::float4_t cz = bx::float4_splat((box.minExtents.z + box.maxExtents.z) * 0.5f);
+      const bx::float4_t ex = bx::float4_splat((box.maxExtents.x - box.minExtents.x) * 0.5f);
+      const bx::float4_t ey = bx::float4_splat((box.maxExtents.y - box.minExtents.y) * 0.5f);
+      const bx::float4_t ez = bx::float4_splat((box.maxExtents.z - box.minExtents.z) * 0.5f);
+      const bx::float4_t zero = bx::float4_zero();
+
+      for ( U32 g = 0; g < 2; ++g )
+      {
+         const bx::float4_t dist = bx::float4_madd(frustum.x[g], cx, 
+                                   bx::float4_madd(frustum.y[g], cy, 
+                                   bx::float4_madd(frustum.z[g], cz, frustum.w[g])));
+         const bx::float4_t radius = bx::float4_madd(frustum.absX[g], ex, 
+                                     bx::float4_madd(frustum.absY[g], ey, 
+                                     bx::float4_mul(frustum.absZ[g], ez)));
+
+         if ( bx::float4_test_any_xyzw(bx::float4_cmplt(bx::float4_add(dist, radius), zero)) )
+            return true;
+      }
+
+      return false;
+   }
+
+   void Frustum::set(const F32* viewProjMtx)
+   {
+      // Gribb/Hartmann plane extraction. bx matrices transform row vectors 
+      // so clip space x, y, z and w are the columns of the matrix.
+      const F32* m = viewProjMtx;
+      for ( U32 i = 0; i < 4; ++i )
+      {
+         const F32 col0 = m[i * 4 + 0];
+         const F32 col1 = m[i * 4 + 1];
+         const F32 col2 = m[i * 4 + 2];
+         const F32 col3 = m[i * 4 + 3];
+
+         planes[0][i] = col3 + col0; // Left
+         planes[1][i] = col3 - col0; // Right
+         planes[2][i] = col3 + col1; // Bottom
+         planes[3][i] = col3 - col1; // Top
+         planes[4][i] = col3 + col2; // Near
+         planes[5][i] = col3 - col2; // Far
+      }
+   }
+
+   bool Frustum::intersects(const Box3F& box) const
+   {
+      FrustumSIMD frustum;
+      _loadFrustumSIMD(&frustum, *this);
+      return !_isBoxOutside(frustum, box);
+   }
+
+   Box3F transformBox(const F32* mtx, const Box3F& box)
+   {
+      Point3F center = box.getCenter();
+      Point3F extents = (box.maxExtents - box.minExtents) * 0.5f;
+
+      Point3F newCenter(center.x * mtx[0] + center.y * mtx[4] + center.z * mtx[8]  + mtx[12],
+                        center.x * mtx[1] + center.y * mtx[5] + center.z * mtx[9]  + mtx[13],
+                        center.x * mtx[2] + center.y * mtx[6] + center.z * mtx[10] + mtx[14]);
+
+      Point3F newExtents(mFabs(mtx[0]) * extents.x + mFabs(mtx[4]) * extents.y + mFabs(mtx[8])  * extents.z,
+                         mFabs(mtx[1]) * extents.x + mFabs(mtx[5]) * extents.y + mFabs(mtx[9])  * extents.z,
+                         mFabs(mtx[2]) * extents.x + mFabs(mtx[6]) * extents.y + mFabs(mtx[10]) * extents.z);
+
+      return Box3F(newCenter - newExtents, newCenter + newExtents);
+   }
+
+   U32 cullRenderData(const Frustum& frustum, RenderData** items, U32 count, RenderData** itemsOut)
+   {
+      FrustumSIMD frustumSIMD;
+      _loadFrustumSIMD(&frustumSIMD, frustum);
+
+      U32 outCount = 0;
+      for ( U32 n = 0; n < count; ++n )
+      {
+         RenderData* item = items[n];
+         if ( item->hasBounds && _isBoxOutside(frustumSIMD, item->bounds) )
+            continue;
+
+         itemsOut[outCount] = item;
+         outCount++;
+      }
+
+      return outCount;
+   }
+
+   // Culling is split into fixed size chunks so the visible items of each 
+   // chunk can be written in place and compacted afterwards in order.
+   const U32 CullChunkSize = 1024;
+
+   static FrustumSIMD   gCullFrustum;
+   static U32           gChunkVisible[(MaxRenderData + CullChunkSize - 1) / CullChunkSize];
+   static U32           gChunkCulled[(MaxRenderData + CullChunkSize - 1) / CullChunkSize];
+   static Point3F       gCameraPosition;
+   static F32           gPixelsPerUnit;
+
+   // Errors are relative to the bounds diagonal, which covers 
+   // diagonal * gPixelsPerUnit / distance pixels on screen.
+   static void _selectLOD(RenderData* item)
+   {
+      U32 level = getMin((U32)item->lodLevel, (U32)item->lodCount - 1);
+
+      F32 size = (item->bounds.maxExtents - item->bounds.minExtents).len();
+      F32 distance = (item->bounds.getCenter() - gCameraPosition).len();
+      if ( lodPixelError <= 0.0f || !item->hasBounds || distance <= size * 0.5f )
+      {
+         level = 0;
+      } else {
+         F32 pixels = size * gPixelsPerUnit / distance;
+         while ( level + 1 < item->lodCount && item->lods[level + 1].error * pixels < lodPixelError * (1.0f - LODHysteresis) )
+            level++;
+         while ( level > 0 && item->lods[level].error * pixels > lodPixelError * (1.0f + LODHysteresis) )
+            level--;
+      }
+
+      item->lodLevel       = level;
+      item->indexBuffer    = item->lods[level].indexBuffer;
+      item->triangleCount  = item->lods[level].triangleCount;
+   }
+
+   static void _cullChunks(void* data, U32 start, U32 end)
+   {
+      for ( U32 chunkStart = start; chunkStart < end; chunkStart += CullChunkSize )
+      {
+         U32 chunkEnd = getMin(chunkStart + CullChunkSize, end);
+         U32 visible = chunkStart;
+         U32 culled = 0;
+
+         for ( U32 n = chunkStart; n < chunkEnd; ++n )
+         {
+            RenderData* item = liveRenderList[n];
+            if ( item->deleted ) continue;
+
+            if ( item->hasBounds && _isBoxOutside(gCullFrustum, item->bounds) )
+            {
+               culled++;
+               continue;
+            }
+
+            if ( item->lodCount > 0 )
+               _selectLOD(item);
+
+            visibleList[visible] = item;
+            visible++;
+         }
+
+         U32 chunk = chunkStart / CullChunkSize;
+         gChunkVisible[chunk] = visible - chunkStart;
+         gChunkCulled[chunk] = culled;
+      }
+   }
+
+   void cullRenderList()
+   {
+      F32 viewProjMtx[16];
+      bx::mtxMul(viewProjMtx, viewMatrix, projectionMatrix);
+      cameraFrustum.set(viewProjMtx);
+      _loadFrustumSIMD(&gCullFrustum, cameraFrustum);
+
+      F32 invViewMtx[16];
+      bx::mtxInverse(invViewMtx, viewMatrix);
+      gCameraPosition.set(invViewMtx[12], invViewMtx[13], invViewMtx[14]);
+      gPixelsPerUnit = projectionHeight * 0.5f * canvasHeight;
+
+      runFrameJob(_cullChunks, NULL, liveRenderCount, CullChunkSize);
+
+      // Pack the chunks together. Chunks only ever move down the list.
+      visibleCount = 0;
+      culledCount = 0;
+      for ( U32 chunkStart = 0; chunkStart < liveRenderCount; chunkStart += CullChunkSize )
+      {
+         U32 chunk = chunkStart / CullChunkSize;
+         if ( visibleCount != chunkStart && gChunkVisible[chunk] > 0 )
+            dMemmove(&visibleList[visibleCount], &visibleList[chunkStart], gChunkVisible[chunk] * sizeof(RenderData*));
+
+         visibleCount += gChunkVisible[chunk];
+         culledCount += gChunkCulled[chunk];
+      }
+   }
+}
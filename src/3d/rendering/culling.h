@@ -0,0 +1,73 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _RENDERING_CULLING_H_
+#define _RENDERING_CULLING_H_
+
+#ifndef _RENDERINGCOMMON_H_
+#include "common.h"
+#endif
+
+#ifndef _MBOX_H_
+#include "math/mBox.h"
+#endif
+
+namespace Rendering 
+{
+   // View frustum. Planes are stored as (nx, ny, nz, d) and face inward so
+   // a point is inside when dot(n, p) + d >= 0 for every plane.
+   struct DLL_PUBLIC Frustum
+   {
+      F32 planes[6][4];
+
+      void set(const F32* viewProjMtx);
+      bool intersects(const Box3F& box) const;
+   };
+
+   // Transforms an axis aligned box by a bx style (row vector) matrix and 
+   // returns the axis aligned box that encloses the result.
+   Box3F transformBox(const F32* mtx, const Box3F& box);
+
+   // Tests each item against the frustum and writes the ones that survive
+   // to itemsOut. Items without bounds are never culled. Returns the number
+   // of items written. items and itemsOut may point to the same list.
+   U32 cullRenderData(const Frustum& frustum, RenderData** items, U32 count, RenderData** itemsOut);
+
+   // Camera visibility for the current frame, rebuilt by cullRenderList()
+   extern Frustum             cameraFrustum;
+   extern RenderData*         visibleList[65535];
+   extern U32                 visibleCount;
+   extern U32                 culledCount;
+   void cullRenderList();
+
+   // LOD Selection
+   // cullRenderList() also picks the LOD of every visible item that has a 
+   // chain: the coarsest level whose error, projected to the screen, stays
+   // under lodPixelError pixels. A level has to clear that by LODHysteresis
+   // either way before it's swapped, so items sitting near a switch 
+   // distance don't flicker between levels. 0 always draws full detail.
+   const F32                  LODHysteresis = 0.25f;
+   extern F32                 lodPixelError;
+}
+
+#endif
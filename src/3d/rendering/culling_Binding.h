@@ -0,0 +1,76 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _CONSOLE_H_
+#include "console/console.h"
+#endif
+
+#ifndef _RENDERING_CULLING_H_
+#include "culling.h"
+#endif
+
+#include "c-interface/c-interface.h"
+
+ConsoleNamespaceFunction( Rendering, getVisibleCount, ConsoleInt, 1, 1, (""))
+{
+   return Rendering::visibleCount;
+}
+
+ConsoleNamespaceFunction( Rendering, getCulledCount, ConsoleInt, 1, 1, (""))
+{
+   return Rendering::culledCount;
+}
+
+ConsoleNamespaceFunction( Rendering, setLODPixelError, ConsoleVoid, 2, 2, ("(pixels) Sets how far, in pixels, a mesh LOD may stray from the full mesh on screen. 0 always draws full detail."))
+{
+   Rendering::lodPixelError = getMax(dAtof(argv[1]), 0.0f);
+}
+
+ConsoleNamespaceFunction( Rendering, getLODPixelError, ConsoleFloat, 1, 1, (""))
+{
+   return Rendering::lodPixelError;
+}
+
+namespace Rendering{
+   extern "C" {
+      DLL_PUBLIC U32 Rendering_GetVisibleCount()
+      {
+         return Rendering::visibleCount;
+      }
+
+      DLL_PUBLIC U32 Rendering_GetCulledCount()
+      {
+         return Rendering::culledCount;
+      }
+
+      DLL_PUBLIC void Rendering_SetLODPixelError(F32 pixels)
+      {
+         Rendering::lodPixelError = getMax(pixels, 0.0f);
+      }
+
+      DLL_PUBLIC F32 Rendering_GetLODPixelError()
+      {
+         return Rendering::lodPixelError;
+      }
+   }
+}
@@ -0,0 +1,434 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "lightGrid.h"
+#include "console/consoleInternal.h"
+#include "math/mMathFn.h"
+
+// Script bindings.
+#include "lightGrid_Binding.h"
+
+#include <bx/timer.h>
+
+namespace Rendering
+{
+   struct LightGridEntry
+   {
+      S32   cell[3];
+      S32   next;
+      S32   prev;
+      bool  alive;
+      bool  inGrid;
+   };
+
+   // lightList itself is declared in common.h, the entries run parallel to it.
+   Vector<LightData> lightList;
+
+   static Vector<LightGridEntry> gLightEntries;
+   static Vector<U32>            gFreeLights;
+   static Vector<S32>            gBucketHead;
+   static U32                    gGridLightCount   = 0;
+   static F32                    gCellSize         = 50.0f;
+   static F32                    gInvCellSize      = 1.0f / 50.0f;
+
+   static inline S32 _toCell(F32 value)
+   {
+      return (S32)mFloor(value * gInvCellSize);
+   }
+
+   static inline U32 _hashCell(const S32* cell)
+   {
+      U32 hash = ((U32)cell[0] * 73856093U) ^ ((U32)cell[1] * 19349663U) ^ ((U32)cell[2] * 83492791U);
+      return hash & (gBucketHead.size() - 1);
+   }
+
+   static void _link(U32 index)
+   {
+      LightGridEntry* entry = &gLightEntries[index];
+      U32 bucket = _hashCell(entry->cell);
+
+      entry->prev = -1;
+      entry->next = gBucketHead[bucket];
+      if ( entry->next >= 0 )
+         gLightEntries[entry->next].prev = index;
+      gBucketHead[bucket] = index;
+      entry->inGrid = true;
+   }
+
+   static void _unlink(U32 index)
+   {
+      LightGridEntry* entry = &gLightEntries[index];
+      if ( entry->prev >= 0 )
+         gLightEntries[entry->prev].next = entry->next;
+      else
+         gBucketHead[_hashCell(entry->cell)] = entry->next;
+
+      if ( entry->next >= 0 )
+         gLightEntries[entry->next].prev = entry->prev;
+
+      entry->next = -1;
+      entry->prev = -1;
+      entry->inGrid = false;
+   }
+
+   // Rebuilds the bucket table. Used when the cell size changes or the table
+   // needs to grow to keep bucket chains short.
+   static void _rebuildGrid(U32 bucketCount)
+   {
+      gBucketHead.setSize(bucketCount);
+      for ( U32 n = 0; n < bucketCount; ++n )
+         gBucketHead[n] = -1;
+
+      for ( U32 n = 0; n < (U32)gLightEntries.size(); ++n )
+      {
+         LightGridEntry* entry = &gLightEntries[n];
+         if ( !entry->inGrid )
+            continue;
+
+         entry->cell[0] = _toCell(lightList[n].position.x);
+         entry->cell[1] = _toCell(lightList[n].position.y);
+         entry->cell[2] = _toCell(lightList[n].position.z);
+         _link(n);
+      }
+   }
+
+   U32 createLight()
+   {
+      if ( gBucketHead.size() == 0 )
+         _rebuildGrid(LightGridBuckets);
+
+      // Reuse a free slot. The free list can hold stale indices from slots
+      // that were trimmed off the end of the list and reused since.
+      while ( gFreeLights.size() > 0 )
+      {
+         U32 index = gFreeLights.back();
+         gFreeLights.pop_back();
+
+         if ( index >= (U32)lightList.size() || gLightEntries[index].alive )
+            continue;
+
+         dMemset(&lightList[index], 0, sizeof(LightData));
+         gLightEntries[index].alive = true;
+         return index;
+      }
+
+      LightData light;
+      dMemset(&light, 0, sizeof(LightData));
+      lightList.push_back(light);
+
+      LightGridEntry entry;
+      entry.cell[0]  = 0;
+      entry.cell[1]  = 0;
+      entry.cell[2]  = 0;
+      entry.next     = -1;
+      entry.prev     = -1;
+      entry.alive    = true;
+      entry.inGrid   = false;
+      gLightEntries.push_back(entry);
+
+      return lightList.size() - 1;
+   }
+
+   void destroyLight(U32 index)
+   {
+      AssertFatal(index < (U32)lightList.size() && gLightEntries[index].alive, "Rendering::destroyLight - invalid light index.");
+
+      if ( gLightEntries[index].inGrid )
+      {
+         _unlink(index);
+         gGridLightCount--;
+      }
+
+      // Zero radius lights are skipped by light binning.
+      lightList[index].radius = 0.0f;
+      gLightEntries[index].alive = false;
+      gFreeLights.push_back(index);
+
+      // Keep the list tight so binning doesn't walk dead lights at the end.
+      while ( lightList.size() > 0 && !gLightEntries.back().alive )
+      {
+         lightList.pop_back();
+         gLightEntries.pop_back();
+      }
+      if ( lightList.size() == 0 )
+         gFreeLights.clear();
+   }
+
+   void updateLight(U32 index)
+   {
+      AssertFatal(index < (U32)lightList.size() && gLightEntries[index].alive, "Rendering::updateLight - invalid light index.");
+
+      LightGridEntry* entry = &gLightEntries[index];
+      const Point3F& position = lightList[index].position;
+      S32 cell[3] = { _toCell(position.x), _toCell(position.y), _toCell(position.z) };
+
+      if ( entry->inGrid )
+      {
+         // Moving within a cell doesn't change the grid.
+         if ( entry->cell[0] == cell[0] && entry->cell[1] == cell[1] && entry->cell[2] == cell[2] )
+            return;
+
+         _unlink(index);
+      } else {
+         gGridLightCount++;
+      }
+
+      entry->cell[0] = cell[0];
+      entry->cell[1] = cell[1];
+      entry->cell[2] = cell[2];
+
+      if ( gGridLightCount > (U32)gBucketHead.size() )
+      {
+         // Relinks every light including this one.
+         entry->inGrid = true;
+         _rebuildGrid(gBucketHead.size() * 2);
+         return;
+      }
+
+      _link(index);
+   }
+
+   F32 getLightGridCellSize()
+   {
+      return gCellSize;
+   }
+
+   void setLightGridCellSize(F32 cellSize)
+   {
+      if ( cellSize <= 0.0f )
+         return;
+
+      gCellSize      = cellSize;
+      gInvCellSize   = 1.0f / cellSize;
+
+      if ( gBucketHead.size() > 0 )
+         _rebuildGrid(gBucketHead.size());
+   }
+
+   // Sorted set of the closest lights found so far.
+   struct NearestLightSet
+   {
+      LightData** results;
+      F32         dist[MaxNearestLights];
+      U32         count;
+      U32         max;
+   };
+
+   static inline void _considerLight(NearestLightSet& set, U32 index, F32 dist)
+   {
+      if ( set.count == set.max && dist >= set.dist[set.count - 1] )
+         return;
+
+      // When the set is full the farthest light is dropped.
+      S32 i = set.count < set.max ? set.count : set.max - 1;
+      if ( set.count < set.max )
+         set.count++;
+
+      while ( i > 0 && set.dist[i - 1] > dist )
+      {
+         set.dist[i]    = set.dist[i - 1];
+         set.results[i] = set.results[i - 1];
+         i--;
+      }
+
+      set.dist[i]    = dist;
+      set.results[i] = &lightList[index];
+   }
+
+   static void _visitCell(NearestLightSet& set, const Point3F& position, S32 x, S32 y, S32 z)
+   {
+      S32 cell[3] = { x, y, z };
+      for ( S32 index = gBucketHead[_hashCell(cell)]; index >= 0; index = gLightEntries[index].next )
+      {
+         // Buckets can be shared by several cells.
+         const LightGridEntry& entry = gLightEntries[index];
+         if ( entry.cell[0] != x || entry.cell[1] != y || entry.cell[2] != z )
+            continue;
+
+         _considerLight(set, index, (lightList[index].position - position).lenSquared());
+      }
+   }
+
+   static void _scanAllLights(NearestLightSet& set, const Point3F& position)
+   {
+      set.count = 0;
+      for ( U32 n = 0; n < (U32)lightList.size(); ++n )
+      {
+         if ( !gLightEntries[n].inGrid )
+            continue;
+
+         _considerLight(set, n, (lightList[n].position - position).lenSquared());
+      }
+   }
+
+   U32 getNearestLights(const Point3F& position, LightData** results, U32 maxResults)
+   {
+      maxResults = getMin(maxResults, MaxNearestLights);
+      if ( maxResults == 0 || gGridLightCount == 0 )
+         return 0;
+
+      NearestLightSet set;
+      set.results = results;
+      set.count   = 0;
+      set.max     = maxResults;
+
+      S32 qx = _toCell(position.x);
+      S32 qy = _toCell(position.y);
+      S32 qz = _toCell(position.z);
+
+      // Visit shells of cells around the query cell until nothing outside the
+      // visited box can be closer than the farthest light found.
+      U32 visitedCells = 0;
+      for ( S32 r = 0; ; ++r )
+      {
+         U32 side = (2 * r) + 1;
+         U32 shellCells = (r == 0) ? 1 : (side * side * side) - ((side - 2) * (side - 2) * (side - 2));
+
+         // Sparse lights: once there are more cells to visit than lights it's
+         // cheaper to test every light.
+         if ( visitedCells + shellCells > gGridLightCount )
+         {
+            _scanAllLights(set, position);
+            return set.count;
+         }
+         visitedCells += shellCells;
+
+         for ( S32 dz = -r; dz <= r; ++dz )
+         {
+            for ( S32 dy = -r; dy <= r; ++dy )
+            {
+               // Inner rows only touch the shell at both ends.
+               bool faceRow = (dz == -r || dz == r || dy == -r || dy == r);
+               S32 step = faceRow ? 1 : (2 * r);
+
+               for ( S32 dx = -r; dx <= r; dx += step )
+                  _visitCell(set, position, qx + dx, qy + dy, qz + dz);
+            }
+         }
+
+         if ( set.count < set.max )
+            continue;
+
+         F32 boxDist = F32_MAX;
+         boxDist = getMin(boxDist, position.x - (F32)(qx - r) * gCellSize);
+         boxDist = getMin(boxDist, (F32)(qx + r + 1) * gCellSize - position.x);
+         boxDist = getMin(boxDist, position.y - (F32)(qy - r) * gCellSize);
+         boxDist = getMin(boxDist, (F32)(qy + r + 1) * gCellSize - position.y);
+         boxDist = getMin(boxDist, position.z - (F32)(qz - r) * gCellSize);
+         boxDist = getMin(boxDist, (F32)(qz + r + 1) * gCellSize - position.z);
+
+         if ( set.dist[set.count - 1] <= boxDist * boxDist )
+            break;
+      }
+
+      return set.count;
+   }
+
+   // Debug Function
+   // Benchmarks grid queries against a scan of every light.
+   void testGetNearestLights()
+   {
+      const U32 lightCount = 100000;
+      const U32 queryCount = 1000;
+      const F32 extent     = 10000.0f;
+
+      F64 hpFreq = (F64)bx::getHPFrequency() / 1000.0; // milli-seconds.
+      F32 oldCellSize = gCellSize;
+
+      // Roughly one light per cell.
+      setLightGridCellSize(mPow((extent * 2.0f) * (extent * 2.0f) * (extent * 2.0f) / (F32)lightCount, 1.0f / 3.0f));
+
+      // Build
+      Vector<U32> lights;
+      lights.setSize(lightCount);
+
+      U64 startTime = bx::getHPCounter();
+      for ( U32 n = 0; n < lightCount; ++n )
+      {
+         lights[n] = createLight();
+         LightData* light = &lightList[lights[n]];
+         light->position = Point3F(mRandF(-extent, extent), mRandF(-extent, extent), mRandF(-extent, extent));
+         light->radius = 1.0f;
+         updateLight(lights[n]);
+      }
+      U64 buildTime = bx::getHPCounter() - startTime;
+
+      // Update
+      startTime = bx::getHPCounter();
+      for ( U32 n = 0; n < lightCount; ++n )
+      {
+         lightList[lights[n]].position += Point3F(mRandF(-10.0f, 10.0f), mRandF(-10.0f, 10.0f), mRandF(-10.0f, 10.0f));
+         updateLight(lights[n]);
+      }
+      U64 updateTime = bx::getHPCounter() - startTime;
+
+      // Query
+      LightData* gridResults[4];
+      LightData* scanResults[4];
+      F32 scanDist[MaxNearestLights];
+      U64 gridTime = 0;
+      U64 scanTime = 0;
+      U32 mismatches = 0;
+
+      for ( U32 q = 0; q < queryCount; ++q )
+      {
+         Point3F position(mRandF(-extent, extent), mRandF(-extent, extent), mRandF(-extent, extent));
+
+         startTime = bx::getHPCounter();
+         U32 gridCount = getNearestLights(position, gridResults, 4);
+         gridTime += bx::getHPCounter() - startTime;
+
+         NearestLightSet set;
+         set.results = scanResults;
+         set.max     = 4;
+         startTime = bx::getHPCounter();
+         _scanAllLights(set, position);
+         scanTime += bx::getHPCounter() - startTime;
+         dMemcpy(scanDist, set.dist, sizeof(scanDist));
+
+         if ( gridCount != set.count )
+         {
+            mismatches++;
+            continue;
+         }
+
+         for ( U32 n = 0; n < gridCount; ++n )
+         {
+            if ( (gridResults[n]->position - position).lenSquared() != scanDist[n] )
+            {
+               mismatches++;
+               break;
+            }
+         }
+      }
+
+      Con::printf("testGetNearestLights: %d lights, %d queries, cell size %f", lightCount, queryCount, gCellSize);
+      Con::printf("   Build: %f ms, Update: %f ms", (F64)buildTime / hpFreq, (F64)updateTime / hpFreq);
+      Con::printf("   Grid: %f ms, Scan: %f ms, Mismatches: %d", (F64)gridTime / hpFreq, (F64)scanTime / hpFreq, mismatches);
+
+      for ( U32 n = 0; n < lightCount; ++n )
+         destroyLight(lights[n]);
+
+      setLightGridCellSize(oldCellSize);
+   }
+}
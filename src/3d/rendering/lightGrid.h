@@ -0,0 +1,60 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _RENDERING_LIGHT_GRID_H_
+#define _RENDERING_LIGHT_GRID_H_
+
+#ifndef _RENDERINGCOMMON_H_
+#include "common.h"
+#endif
+
+namespace Rendering 
+{
+   // Light Grid
+   // Lights in lightList are indexed by a hashed uniform grid so nearest light
+   // queries only visit the cells around the query point. Lights are owned by
+   // index: lightList may reallocate, so LightData pointers are only valid 
+   // until the next createLight() call.
+
+   const U32 LightGridBuckets    = 4096;
+   const U32 MaxNearestLights    = 16;
+
+   // Allocates a slot in lightList and returns its index. The slot is not
+   // added to the grid until updateLight() is called.
+   U32  createLight();
+   void destroyLight(U32 index);
+
+   // Call after changing the position of a light.
+   void updateLight(U32 index);
+
+   // Writes up to maxResults (at most MaxNearestLights) of the lights closest 
+   // to position into results, nearest first, and returns how many were 
+   // written. Does not allocate.
+   U32 getNearestLights(const Point3F& position, LightData** results, U32 maxResults);
+
+   // Cell size in world units. Changing it rebuilds the grid.
+   F32  getLightGridCellSize();
+   void setLightGridCellSize(F32 cellSize);
+}
+
+#endif
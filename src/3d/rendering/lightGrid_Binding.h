@@ -0,0 +1,61 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _CONSOLE_H_
+#include "console/console.h"
+#endif
+
+#ifndef _RENDERING_LIGHT_GRID_H_
+#include "lightGrid.h"
+#endif
+
+#include "c-interface/c-interface.h"
+
+ConsoleNamespaceFunction( Rendering, getLightGridCellSize, ConsoleFloat, 1, 1, ("Returns the cell size of the light grid in world units."))
+{
+   return Rendering::getLightGridCellSize();
+}
+
+ConsoleNamespaceFunction( Rendering, setLightGridCellSize, ConsoleVoid, 2, 2, ("Sets the cell size of the light grid in world units and rebuilds it."))
+{
+   Rendering::setLightGridCellSize(dAtof(argv[1]));
+}
+
+ConsoleNamespaceFunction( Rendering, testGetNearestLights, ConsoleVoid, 1, 1, ("Benchmarks nearest light queries with 100k lights."))
+{
+   Rendering::testGetNearestLights();
+}
+
+namespace Rendering{
+   extern "C" {
+      DLL_PUBLIC F32 Rendering_GetLightGridCellSize()
+      {
+         return Rendering::getLightGridCellSize();
+      }
+
+      DLL_PUBLIC void Rendering_SetLightGridCellSize(F32 cellSize)
+      {
+         Rendering::setLightGridCellSize(cellSize);
+      }
+   }
+}
@@ -0,0 +1,319 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "renderQueue.h"
+#include "console/consoleInternal.h"
+#include "graphics/core.h"
+
+// Script bindings.
+#include "renderQueue_Binding.h"
+
+#include <bgfx.h>
+#include <bx/fpumath.h>
+#include <bx/hash.h>
+#include <bx/radixsort.h>
+
+namespace Rendering
+{
+   RenderQueueStats  renderQueueStats;
+   bool              autoInstancing = true;
+   RenderData*       renderQueue[65535];
+   U16               renderQueueBatch[65535];
+   U32               renderQueueCount = 0;
+
+   // Per item sort data, indexed by position in the incoming item list.
+   static uint64_t gSortKeys[65535];
+   static uint64_t gSortKeysTemp[65535];
+   static U16 gSortIndices[65535];
+   static U16 gSortIndicesTemp[65535];
+   static U16 gItemTextures[65535];
+   static U16 gItemState[65535];
+   static U8 gItemGeometry[65535];
+
+   static U16 _hashTextures(RenderData* item)
+   {
+      if ( !item->textures || item->textures->size() < 1 )
+         return 0;
+
+      bx::HashMurmur2A hash;
+      hash.begin();
+      for (S32 i = 0; i < item->textures->size(); ++i)
+      {
+         TextureData* texture = &item->textures->at(i);
+         hash.add(texture->handle.idx);
+         hash.add(texture->isDepthTexture);
+         hash.add(texture->isNormalTexture);
+      }
+      return (U16)(hash.end() & 0xfff);
+   }
+
+   static U16 _hashState(RenderData* item)
+   {
+      bx::HashMurmur2A hash;
+      hash.begin();
+      hash.add(item->state);
+      hash.add(item->stateRGBA);
+      return (U16)(hash.end() & 0x3ff);
+   }
+
+   static U8 _hashGeometry(RenderData* item)
+   {
+      bx::HashMurmur2A hash;
+      hash.begin();
+      if ( item->isDynamic )
+      {
+         hash.add(item->dynamicVertexBuffer.idx);
+         hash.add(item->dynamicIndexBuffer.idx);
+      } else {
+         hash.add(item->vertexBuffer.idx);
+         hash.add(item->indexBuffer.idx);
+      }
+      return (U8)(hash.end() & 0xff);
+   }
+
+   // Distance from the camera plane mapped to 24 bits.
+   static U32 _calcDepth(RenderData* item)
+   {
+      Point3F worldPos(0.0f, 0.0f, 0.0f);
+      if ( item->hasBounds )
+         worldPos = item->bounds.getCenter();
+      else if ( item->transformTable != NULL )
+         worldPos.set(item->transformTable[12], item->transformTable[13], item->transformTable[14]);
+
+      F32 viewPos[3];
+      bx::vec3MulMtx(viewPos, worldPos, viewMatrix);
+
+      F32 depth = mClampF(viewPos[2] / farPlane, 0.0f, 1.0f);
+      return (U32)(depth * F32(0xffffff));
+   }
+
+   // Job: builds the sort key of every item in the range.
+   static void _buildSortKeys(void* data, U32 start, U32 end)
+   {
+      RenderData** items = (RenderData**)data;
+
+      for (U32 n = start; n < end; ++n)
+      {
+         RenderData* item = items[n];
+
+         U64 view          = item->view->id;
+         U64 translucent   = (item->state & BGFX_STATE_BLEND_MASK) ? 1 : 0;
+         U64 program       = item->shader.idx & 0x1ff;
+         U64 depth         = _calcDepth(item);
+
+         gItemTextures[n]  = _hashTextures(item);
+         gItemState[n]     = _hashState(item);
+         gItemGeometry[n]  = _hashGeometry(item);
+
+         if ( translucent )
+         {
+            depth = 0xffffff - depth;
+            gSortKeys[n] = (view << 56)
+                         | (translucent << 55)
+                         | (depth << 31)
+                         | (program << 22)
+                         | (U64(gItemTextures[n]) << 10)
+                         | U64(gItemState[n]);
+         } else {
+            gSortKeys[n] = (view << 56)
+                         | (translucent << 55)
+                         | (program << 46)
+                         | (U64(gItemTextures[n]) << 34)
+                         | (U64(gItemState[n]) << 24)
+                         | (U64(gItemGeometry[n]) << 16)
+                         | (depth >> 8);
+         }
+
+         gSortIndices[n] = (U16)n;
+      }
+   }
+
+   static U32 _getInstanceCount(RenderData* item)
+   {
+      if ( item->instanceBuffer != NULL )
+         return item->instanceBuffer->count;
+      if ( item->instances && item->instances->size() > 0 )
+         return item->instances->size();
+      return 1;
+   }
+
+   void buildRenderQueue(RenderData** items, U32 count)
+   {
+      dMemset(&renderQueueStats, 0, sizeof(renderQueueStats));
+      renderQueueCount = 0;
+
+      if ( count < 1 )
+         return;
+
+      // Build sort keys.
+      runFrameJob(_buildSortKeys, items, count, 512);
+
+      bx::radixSort64(gSortKeys, gSortKeysTemp, gSortIndices, gSortIndicesTemp, count);
+
+      // Write out the sorted queue and count state changes between items.
+      RenderData* prev = NULL;
+      U16 prevTextures = 0;
+      U16 prevState = 0;
+      for (U32 n = 0; n < count; ++n)
+      {
+         U16 index = gSortIndices[n];
+         RenderData* item = items[index];
+
+         if ( prev == NULL || prev->shader.idx != item->shader.idx )
+            renderQueueStats.programChanges++;
+         if ( prev == NULL || prevTextures != gItemTextures[index] )
+            renderQueueStats.textureChanges++;
+         if ( prev == NULL || prevState != gItemState[index] )
+            renderQueueStats.stateChanges++;
+
+         prev           = item;
+         prevTextures   = gItemTextures[index];
+         prevState      = gItemState[index];
+
+         U32 instanceCount = _getInstanceCount(item);
+         renderQueueStats.triangleCount      += item->triangleCount * instanceCount;
+         renderQueueStats.fullTriangleCount  += (item->lodCount > 0 ? item->lods[0].triangleCount : item->triangleCount) * instanceCount;
+
+         renderQueue[renderQueueCount]       = item;
+         renderQueueBatch[renderQueueCount]  = 1;
+         renderQueueCount++;
+      }
+
+      renderQueueStats.itemCount = renderQueueCount;
+
+      buildInstanceBatches();
+   }
+
+   // Only single transform, non-dynamic, opaque items that aren't already
+   // instanced by hand can be merged into a batch.
+   static bool _canInstance(RenderData* item)
+   {
+      if ( !bgfx::isValid(item->instancedShader) ) return false;
+      if ( item->isDynamic ) return false;
+      if ( item->state & BGFX_STATE_BLEND_MASK ) return false;
+      if ( item->instances && item->instances->size() > 0 ) return false;
+      if ( item->instanceBuffer != NULL ) return false;
+      if ( item->transformTable == NULL || item->transformCount != 1 ) return false;
+      return true;
+   }
+
+   static bool _sameTextures(RenderData* a, RenderData* b)
+   {
+      S32 countA = a->textures ? a->textures->size() : 0;
+      S32 countB = b->textures ? b->textures->size() : 0;
+      if ( countA != countB ) return false;
+
+      for (S32 i = 0; i < countA; ++i)
+      {
+         TextureData* texA = &a->textures->at(i);
+         TextureData* texB = &b->textures->at(i);
+         if ( texA->handle.idx != texB->handle.idx 
+            || texA->uniform.idx != texB->uniform.idx
+            || texA->isDepthTexture != texB->isDepthTexture
+            || texA->isNormalTexture != texB->isNormalTexture )
+            return false;
+      }
+
+      return true;
+   }
+
+   static bool _sameUniforms(RenderData* a, RenderData* b)
+   {
+      S32 countA = a->uniforms.isEmpty() ? 0 : a->uniforms.uniforms->size();
+      S32 countB = b->uniforms.isEmpty() ? 0 : b->uniforms.uniforms->size();
+      if ( countA != countB ) return false;
+
+      for (S32 i = 0; i < countA; ++i)
+      {
+         UniformData* uniA = &a->uniforms.uniforms->at(i);
+         UniformData* uniB = &b->uniforms.uniforms->at(i);
+         if ( uniA->uniform.idx != uniB->uniform.idx || uniA->count != uniB->count )
+            return false;
+
+         if ( uniA->_dataPtr == uniB->_dataPtr )
+            continue;
+
+         // Values set through setValue() live in the uniform itself, so two
+         // of them can match even though they don't share a pointer.
+         bool localA = uniA->_dataPtr == &uniA->_floatValues.x;
+         bool localB = uniB->_dataPtr == &uniB->_floatValues.x;
+         if ( !localA || !localB || dMemcmp(&uniA->_floatValues, &uniB->_floatValues, sizeof(Point4F)) != 0 )
+            return false;
+      }
+
+      return true;
+   }
+
+   static bool _canBatch(RenderData* a, RenderData* b)
+   {
+      return a->view == b->view
+         && a->vertexBuffer.idx == b->vertexBuffer.idx
+         && a->indexBuffer.idx == b->indexBuffer.idx
+         && a->shader.idx == b->shader.idx
+         && a->instancedShader.idx == b->instancedShader.idx
+         && a->state == b->state
+         && a->stateRGBA == b->stateRGBA
+         && _sameTextures(a, b)
+         && _sameUniforms(a, b);
+   }
+
+   void buildInstanceBatches()
+   {
+      renderQueueStats.drawCount = renderQueueCount;
+
+      if ( !autoInstancing )
+         return;
+
+      const bgfx::Caps* caps = bgfx::getCaps();
+      if ( (caps->supported & BGFX_CAPS_INSTANCING) == 0 )
+         return;
+
+      U32 n = 0;
+      while ( n < renderQueueCount )
+      {
+         RenderData* first = renderQueue[n];
+         U32 batchSize = 1;
+
+         if ( _canInstance(first) )
+         {
+            while ( n + batchSize < renderQueueCount && batchSize < MaxInstanceBatch )
+            {
+               RenderData* next = renderQueue[n + batchSize];
+               if ( !_canInstance(next) || !_canBatch(first, next) )
+                  break;
+               batchSize++;
+            }
+         }
+
+         if ( batchSize > 1 )
+         {
+            renderQueueBatch[n] = (U16)batchSize;
+            renderQueueStats.batchCount++;
+            renderQueueStats.batchedItems += batchSize;
+            renderQueueStats.drawCount -= batchSize - 1;
+         }
+
+         n += batchSize;
+      }
+   }
+}
@@ -0,0 +1,85 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _RENDER_QUEUE_H_
+#define _RENDER_QUEUE_H_
+
+#ifndef _RENDERINGCOMMON_H_
+#include "common.h"
+#endif
+
+namespace Rendering 
+{
+   // Render Queue
+   // Every item is given a 64 bit sort key and the queue is radix sorted 
+   // each frame. Keys are laid out (high bits first) as:
+   //
+   //   Opaque:       view(8) | 0 | program(9) | textures(12) | state(10) | geometry(8) | depth(16)
+   //   Translucent:  view(8) | 1 | inverse depth(24) | program(9) | textures(12) | state(10)
+   //
+   // Opaque items are grouped by program, textures, state and geometry and 
+   // drawn front to back within each group. Translucent items are drawn back 
+   // to front.
+   //
+   // After sorting, runs of opaque items that share geometry, program, 
+   // textures, uniforms and state and have an instanced shader variant are 
+   // merged into instanced batches. The first item of a batch stores the
+   // batch size in renderQueueBatch, every other item stores 1.
+   //
+   // bgfx re-sorts every view by its own key, program ahead of depth. Views
+   // are put in sequential mode only while the queue submits to them, so
+   // its items draw in queue order and anything else drawn to the same view
+   // keeps bgfx's sorting.
+
+   struct RenderQueueStats
+   {
+      U32 itemCount;
+      U32 programChanges;
+      U32 textureChanges;
+      U32 stateChanges;
+      U32 drawCount;
+      U32 batchCount;
+      U32 batchedItems;
+
+      // Triangles queued this frame, and what the same items would cost at
+      // full detail. Only items that report a triangle count are included.
+      U32 triangleCount;
+      U32 fullTriangleCount;
+   };
+
+   extern RenderQueueStats renderQueueStats;
+   extern bool             autoInstancing;
+
+   // Sorted queue for the current frame, built by buildRenderQueue()
+   extern RenderData*   renderQueue[65535];
+   extern U16           renderQueueBatch[65535];
+   extern U32           renderQueueCount;
+
+   // Largest number of items merged into a single instanced draw.
+   const U32 MaxInstanceBatch = 1024;
+
+   void buildRenderQueue(RenderData** items, U32 count);
+   void buildInstanceBatches();
+}
+
+#endif
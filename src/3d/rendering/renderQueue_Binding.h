@@ -0,0 +1,126 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _CONSOLE_H_
+#include "console/console.h"
+#endif
+
+#ifndef _RENDER_QUEUE_H_
+#include "renderQueue.h"
+#endif
+
+#include "c-interface/c-interface.h"
+
+ConsoleNamespaceFunction( Rendering, getQueueStats, ConsoleString, 1, 1, ("Returns \"items programChanges textureChanges stateChanges\" for the last frame."))
+{
+   char* buffer = Con::getReturnBuffer(64);
+   dSprintf(buffer, 64, "%d %d %d %d", 
+      Rendering::renderQueueStats.itemCount,
+      Rendering::renderQueueStats.programChanges,
+      Rendering::renderQueueStats.textureChanges,
+      Rendering::renderQueueStats.stateChanges);
+   return buffer;
+}
+
+ConsoleNamespaceFunction( Rendering, getInstancingStats, ConsoleString, 1, 1, ("Returns \"draws batches batchedItems\" for the last frame."))
+{
+   char* buffer = Con::getReturnBuffer(64);
+   dSprintf(buffer, 64, "%d %d %d", 
+      Rendering::renderQueueStats.drawCount,
+      Rendering::renderQueueStats.batchCount,
+      Rendering::renderQueueStats.batchedItems);
+   return buffer;
+}
+
+ConsoleNamespaceFunction( Rendering, getTriangleStats, ConsoleString, 1, 1, ("Returns \"triangles fullDetailTriangles\" queued for the last frame. The difference is what mesh LODs saved."))
+{
+   char* buffer = Con::getReturnBuffer(64);
+   dSprintf(buffer, 64, "%d %d", 
+      Rendering::renderQueueStats.triangleCount,
+      Rendering::renderQueueStats.fullTriangleCount);
+   return buffer;
+}
+
+ConsoleNamespaceFunction( Rendering, setAutoInstancing, ConsoleVoid, 2, 2, ("Enables or disables automatic instancing of identical render items."))
+{
+   Rendering::autoInstancing = dAtob(argv[1]);
+}
+
+ConsoleNamespaceFunction( Rendering, setParallelFrameBuild, ConsoleVoid, 2, 2, ("Enables or disables building the frame on the worker pool."))
+{
+   Rendering::parallelFrameBuild = dAtob(argv[1]);
+}
+
+ConsoleNamespaceFunction( Rendering, getFrameTimings, ConsoleString, 1, 1, ("Returns \"preRender cull queue prepare submit renderables total\" in milliseconds for the last frame."))
+{
+   char* buffer = Con::getReturnBuffer(128);
+   dSprintf(buffer, 128, "%.3f %.3f %.3f %.3f %.3f %.3f %.3f", 
+      Rendering::frameTimings.preRender,
+      Rendering::frameTimings.cull,
+      Rendering::frameTimings.queue,
+      Rendering::frameTimings.prepare,
+      Rendering::frameTimings.submit,
+      Rendering::frameTimings.renderables,
+      Rendering::frameTimings.total);
+   return buffer;
+}
+
+namespace Rendering{
+   extern "C" {
+      DLL_PUBLIC void Rendering_GetQueueStats(U32* itemCount, U32* programChanges, U32* textureChanges, U32* stateChanges)
+      {
+         *itemCount        = Rendering::renderQueueStats.itemCount;
+         *programChanges   = Rendering::renderQueueStats.programChanges;
+         *textureChanges   = Rendering::renderQueueStats.textureChanges;
+         *stateChanges     = Rendering::renderQueueStats.stateChanges;
+      }
+
+      DLL_PUBLIC void Rendering_GetInstancingStats(U32* drawCount, U32* batchCount, U32* batchedItems)
+      {
+         *drawCount     = Rendering::renderQueueStats.drawCount;
+         *batchCount    = Rendering::renderQueueStats.batchCount;
+         *batchedItems  = Rendering::renderQueueStats.batchedItems;
+      }
+
+      DLL_PUBLIC void Rendering_GetTriangleStats(U32* triangleCount, U32* fullTriangleCount)
+      {
+         *triangleCount       = Rendering::renderQueueStats.triangleCount;
+         *fullTriangleCount   = Rendering::renderQueueStats.fullTriangleCount;
+      }
+
+      DLL_PUBLIC void Rendering_SetAutoInstancing(bool enabled)
+      {
+         Rendering::autoInstancing = enabled;
+      }
+
+      DLL_PUBLIC void Rendering_SetParallelFrameBuild(bool enabled)
+      {
+         Rendering::parallelFrameBuild = enabled;
+      }
+
+      DLL_PUBLIC void Rendering_GetFrameTimings(Rendering::FrameTimings* outTimings)
+      {
+         *outTimings = Rendering::frameTimings;
+      }
+   }
+}
@@ -0,0 +1,511 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "bvh.h"
+#include "console/console.h"
+
+namespace Scene
+{
+   static inline F32 _surfaceArea(const Box3F& box)
+   {
+      F32 x = box.len_x();
+      F32 y = box.len_y();
+      F32 z = box.len_z();
+      return 2.0f * ((x * y) + (y * z) + (z * x));
+   }
+
+   static inline Box3F _combine(const Box3F& a, const Box3F& b)
+   {
+      Box3F result = a;
+      result.intersect(b);
+      return result;
+   }
+
+   // Slab test against the segment start + t * delta for t in [0, maxFraction].
+   static inline bool _rayOverlaps(const Box3F& box, const Point3F& start, const Point3F& invDelta, F32 maxFraction)
+   {
+      F32 tMin = 0.0f;
+      F32 tMax = maxFraction;
+
+      for ( U32 axis = 0; axis < 3; ++axis )
+      {
+         F32 t0 = (box.minExtents[axis] - start[axis]) * invDelta[axis];
+         F32 t1 = (box.maxExtents[axis] - start[axis]) * invDelta[axis];
+         if ( t0 > t1 )
+         {
+            F32 temp = t0;
+            t0 = t1;
+            t1 = temp;
+         }
+
+         // Parallel to the slab and outside of it.
+         if ( t0 != t0 || t1 != t1 )
+         {
+            if ( start[axis] < box.minExtents[axis] || start[axis] > box.maxExtents[axis] )
+               return false;
+            continue;
+         }
+
+         tMin = getMax(tMin, t0);
+         tMax = getMin(tMax, t1);
+         if ( tMin > tMax )
+            return false;
+      }
+
+      return true;
+   }
+
+   DynamicBVH::DynamicBVH(F32 margin)
+   {
+      mRoot       = NullNode;
+      mFreeList   = NullNode;
+      mProxyCount = 0;
+      mMargin     = margin;
+   }
+
+   DynamicBVH::~DynamicBVH()
+   {
+      //
+   }
+
+   void DynamicBVH::clear()
+   {
+      mNodes.clear();
+      mRoot       = NullNode;
+      mFreeList   = NullNode;
+      mProxyCount = 0;
+   }
+
+   S32 DynamicBVH::allocateNode()
+   {
+      if ( mFreeList == NullNode )
+      {
+         Node node;
+         node.parent = NullNode;
+         mNodes.push_back(node);
+         mFreeList = mNodes.size() - 1;
+      }
+
+      S32 nodeId = mFreeList;
+      Node& node = mNodes[nodeId];
+      mFreeList      = node.parent;
+      node.userData  = NULL;
+      node.parent    = NullNode;
+      node.child1    = NullNode;
+      node.child2    = NullNode;
+      node.height    = 0;
+      return nodeId;
+   }
+
+   void DynamicBVH::freeNode(S32 nodeId)
+   {
+      mNodes[nodeId].parent = mFreeList;
+      mNodes[nodeId].height = -1;
+      mFreeList = nodeId;
+   }
+
+   S32 DynamicBVH::createProxy(const Box3F& box, void* userData)
+   {
+      S32 proxyId = allocateNode();
+      Node& node = mNodes[proxyId];
+      node.box = box;
+      node.box.minExtents -= Point3F(mMargin, mMargin, mMargin);
+      node.box.maxExtents += Point3F(mMargin, mMargin, mMargin);
+      node.userData = userData;
+
+      insertLeaf(proxyId);
+      mProxyCount++;
+      return proxyId;
+   }
+
+   void DynamicBVH::destroyProxy(S32 proxyId)
+   {
+      AssertFatal(proxyId >= 0 && proxyId < mNodes.size() && mNodes[proxyId].isLeaf(), "DynamicBVH::destroyProxy - invalid proxy.");
+
+      removeLeaf(proxyId);
+      freeNode(proxyId);
+      mProxyCount--;
+   }
+
+   bool DynamicBVH::moveProxy(S32 proxyId, const Box3F& box)
+   {
+      AssertFatal(proxyId >= 0 && proxyId < mNodes.size() && mNodes[proxyId].isLeaf(), "DynamicBVH::moveProxy - invalid proxy.");
+
+      if ( mNodes[proxyId].box.isContained(box) )
+         return false;
+
+      removeLeaf(proxyId);
+
+      Node& node = mNodes[proxyId];
+      node.box = box;
+      node.box.minExtents -= Point3F(mMargin, mMargin, mMargin);
+      node.box.maxExtents += Point3F(mMargin, mMargin, mMargin);
+
+      insertLeaf(proxyId);
+      return true;
+   }
+
+   void DynamicBVH::insertLeaf(S32 leaf)
+   {
+      if ( mRoot == NullNode )
+      {
+         mRoot = leaf;
+         mNodes[mRoot].parent = NullNode;
+         return;
+      }
+
+      // Find the best sibling by descending towards the lowest cost child.
+      Box3F leafBox = mNodes[leaf].box;
+      S32 index = mRoot;
+      while ( !mNodes[index].isLeaf() )
+      {
+         S32 child1 = mNodes[index].child1;
+         S32 child2 = mNodes[index].child2;
+
+         F32 area = _surfaceArea(mNodes[index].box);
+         F32 combinedArea = _surfaceArea(_combine(mNodes[index].box, leafBox));
+
+         // Cost of creating a new parent for this node and the new leaf.
+         F32 cost = 2.0f * combinedArea;
+
+         // Minimum cost of pushing the leaf further down the tree.
+         F32 inheritanceCost = 2.0f * (combinedArea - area);
+
+         F32 cost1 = _surfaceArea(_combine(leafBox, mNodes[child1].box));
+         if ( !mNodes[child1].isLeaf() )
+            cost1 -= _surfaceArea(mNodes[child1].box);
+         cost1 += inheritanceCost;
+
+         F32 cost2 = _surfaceArea(_combine(leafBox, mNodes[child2].box));
+         if ( !mNodes[child2].isLeaf() )
+            cost2 -= _surfaceArea(mNodes[child2].box);
+         cost2 += inheritanceCost;
+
+         if ( cost < cost1 && cost < cost2 )
+            break;
+
+         index = (cost1 < cost2) ? child1 : child2;
+      }
+
+      S32 sibling = index;
+
+      // Create a new parent.
+      S32 oldParent = mNodes[sibling].parent;
+      S32 newParent = allocateNode();
+      mNodes[newParent].parent   = oldParent;
+      mNodes[newParent].box      = _combine(leafBox, mNodes[sibling].box);
+      mNodes[newParent].height   = mNodes[sibling].height + 1;
+      mNodes[newParent].child1   = sibling;
+      mNodes[newParent].child2   = leaf;
+      mNodes[sibling].parent     = newParent;
+      mNodes[leaf].parent        = newParent;
+
+      if ( oldParent != NullNode )
+      {
+         if ( mNodes[oldParent].child1 == sibling )
+            mNodes[oldParent].child1 = newParent;
+         else
+            mNodes[oldParent].child2 = newParent;
+      } else {
+         mRoot = newParent;
+      }
+
+      // Walk back up the tree fixing heights and boxes.
+      index = mNodes[leaf].parent;
+      while ( index != NullNode )
+      {
+         index = balance(index);
+
+         S32 child1 = mNodes[index].child1;
+         S32 child2 = mNodes[index].child2;
+         mNodes[index].height = 1 + getMax(mNodes[child1].height, mNodes[child2].height);
+         mNodes[index].box    = _combine(mNodes[child1].box, mNodes[child2].box);
+
+         index = mNodes[index].parent;
+      }
+   }
+
+   void DynamicBVH::removeLeaf(S32 leaf)
+   {
+      if ( leaf == mRoot )
+      {
+         mRoot = NullNode;
+         return;
+      }
+
+      S32 parent        = mNodes[leaf].parent;
+      S32 grandParent   = mNodes[parent].parent;
+      S32 sibling       = (mNodes[parent].child1 == leaf) ? mNodes[parent].child2 : mNodes[parent].child1;
+
+      if ( grandParent != NullNode )
+      {
+         // Replace the parent with the sibling.
+         if ( mNodes[grandParent].child1 == parent )
+            mNodes[grandParent].child1 = sibling;
+         else
+            mNodes[grandParent].child2 = sibling;
+         mNodes[sibling].parent = grandParent;
+         freeNode(parent);
+
+         S32 index = grandParent;
+         while ( index != NullNode )
+         {
+            index = balance(index);
+
+            S32 child1 = mNodes[index].child1;
+            S32 child2 = mNodes[index].child2;
+            mNodes[index].box    = _combine(mNodes[child1].box, mNodes[child2].box);
+            mNodes[index].height = 1 + getMax(mNodes[child1].height, mNodes[child2].height);
+
+            index = mNodes[index].parent;
+         }
+      } else {
+         mRoot = sibling;
+         mNodes[sibling].parent = NullNode;
+         freeNode(parent);
+      }
+   }
+
+   // Rotates the subtree at nodeId if it is out of balance. Returns the new
+   // root of the subtree.
+   S32 DynamicBVH::balance(S32 iA)
+   {
+      Node* A = &mNodes[iA];
+      if ( A->isLeaf() || A->height < 2 )
+         return iA;
+
+      S32 iB = A->child1;
+      S32 iC = A->child2;
+      Node* B = &mNodes[iB];
+      Node* C = &mNodes[iC];
+
+      S32 heightDiff = C->height - B->height;
+
+      // Rotate C up.
+      if ( heightDiff > 1 )
+      {
+         S32 iF = C->child1;
+         S32 iG = C->child2;
+         Node* F = &mNodes[iF];
+         Node* G = &mNodes[iG];
+
+         C->child1 = iA;
+         C->parent = A->parent;
+         A->parent = iC;
+
+         if ( C->parent != NullNode )
+         {
+            if ( mNodes[C->parent].child1 == iA )
+               mNodes[C->parent].child1 = iC;
+            else
+               mNodes[C->parent].child2 = iC;
+         } else {
+            mRoot = iC;
+         }
+
+         if ( F->height > G->height )
+         {
+            C->child2 = iF;
+            A->child2 = iG;
+            G->parent = iA;
+            A->box = _combine(B->box, G->box);
+            C->box = _combine(A->box, F->box);
+            A->height = 1 + getMax(B->height, G->height);
+            C->height = 1 + getMax(A->height, F->height);
+         } else {
+            C->child2 = iG;
+            A->child2 = iF;
+            F->parent = iA;
+            A->box = _combine(B->box, F->box);
+            C->box = _combine(A->box, G->box);
+            A->height = 1 + getMax(B->height, F->height);
+            C->height = 1 + getMax(A->height, G->height);
+         }
+
+         return iC;
+      }
+
+      // Rotate B up.
+      if ( heightDiff < -1 )
+      {
+         S32 iD = B->child1;
+         S32 iE = B->child2;
+         Node* D = &mNodes[iD];
+         Node* E = &mNodes[iE];
+
+         B->child1 = iA;
+         B->parent = A->parent;
+         A->parent = iB;
+
+         if ( B->parent != NullNode )
+         {
+            if ( mNodes[B->parent].child1 == iA )
+               mNodes[B->parent].child1 = iB;
+            else
+               mNodes[B->parent].child2 = iB;
+         } else {
+            mRoot = iB;
+         }
+
+         if ( D->height > E->height )
+         {
+            B->child2 = iD;
+            A->child1 = iE;
+            E->parent = iA;
+            A->box = _combine(C->box, E->box);
+            B->box = _combine(A->box, D->box);
+            A->height = 1 + getMax(C->height, E->height);
+            B->height = 1 + getMax(A->height, D->height);
+         } else {
+            B->child2 = iE;
+            A->child1 = iD;
+            D->parent = iA;
+            A->box = _combine(C->box, D->box);
+            B->box = _combine(A->box, E->box);
+            A->height = 1 + getMax(C->height, D->height);
+            B->height = 1 + getMax(A->height, E->height);
+         }
+
+         return iB;
+      }
+
+      return iA;
+   }
+
+   void DynamicBVH::queryBox(const Box3F& box, QueryCallback callback, void* context) const
+   {
+      if ( mRoot == NullNode )
+         return;
+
+      S32 stack[StackSize];
+      U32 stackCount = 0;
+      stack[stackCount++] = mRoot;
+
+      while ( stackCount > 0 )
+      {
+         const Node& node = mNodes[stack[--stackCount]];
+         if ( !node.box.isOverlapped(box) )
+            continue;
+
+         if ( node.isLeaf() )
+         {
+            if ( !callback(node.userData, context) )
+               return;
+            continue;
+         }
+
+         AssertFatal(stackCount + 2 <= StackSize, "DynamicBVH::queryBox - stack overflow.");
+         stack[stackCount++] = node.child1;
+         stack[stackCount++] = node.child2;
+      }
+   }
+
+   void DynamicBVH::querySphere(const SphereF& sphere, QueryCallback callback, void* context) const
+   {
+      if ( mRoot == NullNode )
+         return;
+
+      S32 stack[StackSize];
+      U32 stackCount = 0;
+      stack[stackCount++] = mRoot;
+
+      while ( stackCount > 0 )
+      {
+         const Node& node = mNodes[stack[--stackCount]];
+         if ( !node.box.isOverlapped(sphere) )
+            continue;
+
+         if ( node.isLeaf() )
+         {
+            if ( !callback(node.userData, context) )
+               return;
+            continue;
+         }
+
+         AssertFatal(stackCount + 2 <= StackSize, "DynamicBVH::querySphere - stack overflow.");
+         stack[stackCount++] = node.child1;
+         stack[stackCount++] = node.child2;
+      }
+   }
+
+   void DynamicBVH::queryFrustum(const Rendering::Frustum& frustum, QueryCallback callback, void* context) const
+   {
+      if ( mRoot == NullNode )
+         return;
+
+      S32 stack[StackSize];
+      U32 stackCount = 0;
+      stack[stackCount++] = mRoot;
+
+      while ( stackCount > 0 )
+      {
+         const Node& node = mNodes[stack[--stackCount]];
+         if ( !frustum.intersects(node.box) )
+            continue;
+
+         if ( node.isLeaf() )
+         {
+            if ( !callback(node.userData, context) )
+               return;
+            continue;
+         }
+
+         AssertFatal(stackCount + 2 <= StackSize, "DynamicBVH::queryFrustum - stack overflow.");
+         stack[stackCount++] = node.child1;
+         stack[stackCount++] = node.child2;
+      }
+   }
+
+   void DynamicBVH::queryRay(const Point3F& start, const Point3F& end, RayCallback callback, void* context) const
+   {
+      if ( mRoot == NullNode )
+         return;
+
+      Point3F delta = end - start;
+      Point3F invDelta(1.0f / delta.x, 1.0f / delta.y, 1.0f / delta.z);
+      F32 maxFraction = 1.0f;
+
+      S32 stack[StackSize];
+      U32 stackCount = 0;
+      stack[stackCount++] = mRoot;
+
+      while ( stackCount > 0 )
+      {
+         const Node& node = mNodes[stack[--stackCount]];
+         if ( !_rayOverlaps(node.box, start, invDelta, maxFraction) )
+            continue;
+
+         if ( node.isLeaf() )
+         {
+            maxFraction = callback(node.userData, start, end, maxFraction, context);
+            if ( maxFraction <= 0.0f )
+               return;
+            continue;
+         }
+
+         AssertFatal(stackCount + 2 <= StackSize, "DynamicBVH::queryRay - stack overflow.");
+         stack[stackCount++] = node.child1;
+         stack[stackCount++] = node.child2;
+      }
+   }
+}
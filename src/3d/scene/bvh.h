@@ -0,0 +1,108 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef _SCENE_BVH_H_
+#define _SCENE_BVH_H_
+
+#ifndef _MBOX_H_
+#include "math/mBox.h"
+#endif
+
+#ifndef _MSPHERE_H_
+#include "math/mSphere.h"
+#endif
+
+#ifndef _RENDERING_CULLING_H_
+#include "3d/rendering/culling.h"
+#endif
+
+namespace Scene 
+{
+   // Dynamic bounding volume hierarchy.
+   // Leaves store a box enlarged by a margin so small movements don't touch
+   // the tree. Inserts pick the sibling with the lowest surface area cost and
+   // the tree is kept balanced with rotations. Queries walk the tree with a
+   // fixed size stack and report leaves through a callback.
+   class DynamicBVH
+   {
+      public:
+         // Return false to stop the query.
+         typedef bool (*QueryCallback)(void* userData, void* context);
+
+         // Return the new maximum fraction along the ray. Returning 0 stops
+         // the query, returning maxFraction leaves the ray unchanged.
+         typedef F32 (*RayCallback)(void* userData, const Point3F& start, const Point3F& end, F32 maxFraction, void* context);
+
+         static const S32 NullNode  = -1;
+         static const U32 StackSize = 256;
+
+         DynamicBVH(F32 margin = 0.5f);
+         ~DynamicBVH();
+
+         void  clear();
+
+         // Proxies are node ids, valid until destroyProxy.
+         S32   createProxy(const Box3F& box, void* userData);
+         void  destroyProxy(S32 proxyId);
+
+         // Returns true if the proxy was moved in the tree.
+         bool  moveProxy(S32 proxyId, const Box3F& box);
+
+         void*          getUserData(S32 proxyId) const { return mNodes[proxyId].userData; }
+         const Box3F&   getFatBox(S32 proxyId) const { return mNodes[proxyId].box; }
+         U32            getProxyCount() const { return mProxyCount; }
+         S32            getHeight() const { return mRoot == NullNode ? 0 : mNodes[mRoot].height; }
+
+         void queryBox(const Box3F& box, QueryCallback callback, void* context) const;
+         void querySphere(const SphereF& sphere, QueryCallback callback, void* context) const;
+         void queryFrustum(const Rendering::Frustum& frustum, QueryCallback callback, void* context) const;
+         void queryRay(const Point3F& start, const Point3F& end, RayCallback callback, void* context) const;
+
+      protected:
+         struct Node
+         {
+            Box3F    box;
+            void*    userData;
+            S32      parent;     // Next free node when on the free list.
+            S32      child1;
+            S32      child2;
+            S32      height;     // Leaf = 0, free node = -1
+
+            bool isLeaf() const { return child1 == NullNode; }
+         };
+
+         Vector<Node>   mNodes;
+         S32            mRoot;
+         S32            mFreeList;
+         U32            mProxyCount;
+         F32            mMargin;
+
+         S32   allocateNode();
+         void  freeNode(S32 nodeId);
+         void  insertLeaf(S32 leaf);
+         void  removeLeaf(S32 leaf);
+         S32   balance(S32 nodeId);
+   };
+}
+
+#endif
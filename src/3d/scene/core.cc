@@ -43,6 +43,7 @@ namespace Scene
    static SimGroup               gSceneFeatureGroup;
    static Vector<SceneCamera*>   gActiveCameraList;
    static SceneCameraMap         gCameraMap;
+   static DynamicBVH             gSceneTree;
 
    Point3F directionalLightDir;
    ColorF  directionalLightColor;
@@ -65,6 +66,7 @@ namespace Scene
    {
       gSceneEntityGroup.clear();
       gSceneFeatureGroup.clear();
+      gSceneTree.clear();
    }
 
    void clearGhosted()
@@ -193,41 +195,113 @@ namespace Scene
       refresh();
    }
 
-   SceneEntity* raycast(Point3F start, Point3F end)
+   void updateEntityProxy(SceneEntity* entity)
    {
-      SceneEntity* result = NULL;
-      F32 resultPoint = 1.0;
+      // Only entities in the scene are tracked.
+      if ( entity->getGroup() != &gSceneEntityGroup )
+         return;
 
-      for(S32 n = 0; n < gSceneEntityGroup.size(); ++n)
+      if ( entity->mSceneProxy == DynamicBVH::NullNode )
+         entity->mSceneProxy = gSceneTree.createProxy(entity->mBoundingBox, entity);
+      else
+         gSceneTree.moveProxy(entity->mSceneProxy, entity->mBoundingBox);
+   }
+
+   void removeEntityProxy(SceneEntity* entity)
+   {
+      if ( entity->mSceneProxy == DynamicBVH::NullNode )
+         return;
+
+      gSceneTree.destroyProxy(entity->mSceneProxy);
+      entity->mSceneProxy = DynamicBVH::NullNode;
+   }
+
+   struct EntityQuery
+   {
+      SceneEntity**  results;
+      U32            count;
+      U32            max;
+   };
+
+   static bool _collectEntity(void* userData, void* context)
+   {
+      EntityQuery* query = (EntityQuery*)context;
+      query->results[query->count++] = (SceneEntity*)userData;
+      return query->count < query->max;
+   }
+
+   U32 queryEntities(const Box3F& box, SceneEntity** results, U32 maxResults)
+   {
+      EntityQuery query = { results, 0, maxResults };
+      if ( maxResults > 0 )
+         gSceneTree.queryBox(box, _collectEntity, &query);
+      return query.count;
+   }
+
+   U32 queryEntities(const SphereF& sphere, SceneEntity** results, U32 maxResults)
+   {
+      EntityQuery query = { results, 0, maxResults };
+      if ( maxResults > 0 )
+         gSceneTree.querySphere(sphere, _collectEntity, &query);
+      return query.count;
+   }
+
+   U32 queryEntities(const Rendering::Frustum& frustum, SceneEntity** results, U32 maxResults)
+   {
+      EntityQuery query = { results, 0, maxResults };
+      if ( maxResults > 0 )
+         gSceneTree.queryFrustum(frustum, _collectEntity, &query);
+      return query.count;
+   }
+
+   struct RaycastQuery
+   {
+      SceneEntity* result;
+   };
+
+   static F32 _raycastEntity(void* userData, const Point3F& start, const Point3F& end, F32 maxFraction, void* context)
+   {
+      RaycastQuery* query = (RaycastQuery*)context;
+      SceneEntity* entity = (SceneEntity*)userData;
+
+      F32 collidePoint;
+      Point3F collideNormal; 
+      if ( entity->mBoundingBox.collideLine(start, end, &collidePoint, &collideNormal) && collidePoint < maxFraction )
       {
-         SceneEntity* entity = dynamic_cast<SceneEntity*>(gSceneEntityGroup.at(n));
-         if ( !entity )
-            continue;
-
-         F32 collidePoint;
-         Point3F collideNormal; 
-
-         if ( entity->mBoundingBox.collideLine(start, end, &collidePoint, &collideNormal) )
-         {
-            if ( collidePoint < resultPoint )
-            {
-               result = entity;
-               resultPoint = collidePoint;
-            }
-         }
+         query->result = entity;
+         return collidePoint;
       }
 
-      return result;
+      return maxFraction;
+   }
+
+   SceneEntity* raycast(Point3F start, Point3F end)
+   {
+      RaycastQuery query;
+      query.result = NULL;
+      gSceneTree.queryRay(start, end, _raycastEntity, &query);
+      return query.result;
+   }
+
+   static bool _scopeEntity(void* userData, void* context)
+   {
+      SceneEntity* entity = (SceneEntity*)userData;
+      if ( entity->isGhostable() && entity->mGhosted )
+         ((NetConnection*)context)->objectInScope(entity);
+      return true;
    }
 
    void onCameraScopeQuery(NetConnection *cr, CameraScopeQuery *camInfo)
    {
-      for(S32 n = 0; n < gSceneEntityGroup.size(); ++n)
+      // Without a camera everything ghosted is in scope.
+      if ( camInfo->camera == NULL )
       {
-         SceneEntity* entity = dynamic_cast<SceneEntity*>(gSceneEntityGroup.at(n));
-         if ( entity->isGhostable() && entity->mGhosted )
-            cr->objectInScope(entity);
+         Box3F everything(Point3F(-F32_MAX, -F32_MAX, -F32_MAX), Point3F(F32_MAX, F32_MAX, F32_MAX));
+         gSceneTree.queryBox(everything, _scopeEntity, cr);
+         return;
       }
+
+      gSceneTree.querySphere(SphereF(camInfo->pos, camInfo->visibleDistance), _scopeEntity, cr);
    }
 
    // -------------------------------------------------------------------------------
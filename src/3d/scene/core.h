@@ -39,6 +39,10 @@
 #include "feature.h"
 #endif
 
+#ifndef _SCENE_BVH_H_
+#include "bvh.h"
+#endif
+
 namespace Scene
 {
    class SceneEntity;
@@ -67,6 +71,15 @@ namespace Scene
    void           refresh();
    SceneEntity*   raycast(Point3F start, Point3F end);
 
+   // Scene Queries
+   // Entities are kept in a dynamic BVH that is refit from SceneEntity::refresh.
+   // Queries write up to maxResults entities and return how many were found.
+   void           updateEntityProxy(SceneEntity* entity);
+   void           removeEntityProxy(SceneEntity* entity);
+   U32            queryEntities(const Box3F& box, SceneEntity** results, U32 maxResults);
+   U32            queryEntities(const SphereF& sphere, SceneEntity** results, U32 maxResults);
+   U32            queryEntities(const Rendering::Frustum& frustum, SceneEntity** results, U32 maxResults);
+
    // Scene Features
    void addFeature(SceneFeature* entity);
    void removeFeature(SceneFeature* entity);
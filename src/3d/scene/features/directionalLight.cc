@@ -27,6 +27,9 @@
 #include "graphics/core.h"
 #include "3d/scene/core.h"
 #include "3d/rendering/common.h"
+#include "3d/rendering/bonePalette.h"
+
+#include <bx/hash.h>
 
 namespace Scene
 {
@@ -45,7 +48,10 @@ namespace Scene
       {
          mCascadeTextures[i].idx = bgfx::invalidHandle;
          mCascadeBuffers[i].idx  = bgfx::invalidHandle;
+         mCascadeHash[i]         = 0;
+         mCascadeDirty[i]        = true;
       }
+      mCascadesValid       = false;
       mBlurBuffer.idx      = bgfx::invalidHandle;
       mShadowTexture.idx   = bgfx::invalidHandle;
       mShadowBuffer.idx    = bgfx::invalidHandle;
@@ -152,6 +158,9 @@ namespace Scene
       mShadowBuffer = bgfx::createFrameBuffer(BX_COUNTOF(fbtextures), fbtextures);
 
       mShadowBlurBuffer = bgfx::createFrameBuffer(Rendering::canvasWidth, Rendering::canvasHeight, bgfx::TextureFormat::RGBA8);
+
+      // New cascade buffers have no contents to reuse.
+      mCascadesValid = false;
    }
 
    void DirectionalLight::destroyBuffers()
@@ -339,17 +348,76 @@ namespace Scene
          float mtxTmp[16];
          bx::mtxMul(mtxTmp, mLightProj[ii], mtxBias);
          bx::mtxMul(mCascadeMtx[ii], mLightView, mtxTmp); // lViewProjCropBias
+
+         // Light space box of the cascade, used to cull shadow casters.
+         F32 mtxLightViewProj[16];
+         bx::mtxMul(mtxLightViewProj, mLightView, mLightProj[ii]);
+         mCascadeFrustums[ii].set(mtxLightViewProj);
       }
    }
 
+   void DirectionalLight::cullCascades()
+   {
+      // Gather every shadow caster once.
+      mShadowCasters.clear();
+      for (U32 n = 0; n < Rendering::liveRenderCount; ++n)
+      {
+         Rendering::RenderData* item = Rendering::liveRenderList[n];
+         if (item->deleted || !item->castShadow) continue;
+         mShadowCasters.push_back(item);
+      }
+
+      for (U32 i = 0; i < 4; ++i)
+      {
+         // Cull the casters against the cascade.
+         mCascadeCasters[i].setSize(mShadowCasters.size());
+         U32 casterCount = Rendering::cullRenderData(mCascadeFrustums[i], mShadowCasters.address(), mShadowCasters.size(), mCascadeCasters[i].address());
+         mCascadeCasters[i].setSize(casterCount);
+
+         // Hash everything that affects the contents of the cascade. If it
+         // matches last frame the shadowmap from last frame is still valid.
+         bx::HashMurmur2A hash;
+         hash.begin();
+         hash.add(mCascadeMtx[i], sizeof(mCascadeMtx[i]));
+         for (U32 n = 0; n < casterCount; ++n)
+         {
+            Rendering::RenderData* item = mCascadeCasters[i][n];
+            hash.add(&item, sizeof(item));
+            hash.add(&item->vertexBuffer.idx, sizeof(item->vertexBuffer.idx));
+            hash.add(&item->indexBuffer.idx, sizeof(item->indexBuffer.idx));
+            if (item->transformTable != NULL)
+               hash.add(item->transformTable, sizeof(F32) * 16 * item->transformCount);
+            if (item->isSkinned && item->boneCount > 0)
+               hash.add(Rendering::getBones(item->boneOffset), sizeof(F32) * 16 * item->boneCount);
+         }
+         U32 cascadeHash = hash.end();
+
+         mCascadeDirty[i] = !mCascadesValid || cascadeHash != mCascadeHash[i];
+         mCascadeHash[i] = cascadeHash;
+      }
+
+      mCascadesValid = true;
+   }
+
    void DirectionalLight::preRender()
    {
       // TODO: This doesn't need to happen every frame.
       refresh();
+      cullCascades();
 
       // Setup Cascades
       for (U32 i = 0; i < 4; ++i)
       {
+         // ShadowMap Cascade Matrix
+         bgfx::setUniform(mCascadeMtxUniforms[i], mCascadeMtx[i]);
+
+         // Unchanged cascades keep last frame's contents.
+         if (!mCascadeDirty[i])
+         {
+            bgfx::setViewClear(mCascadeViews[i]->id, BGFX_CLEAR_NONE);
+            continue;
+         }
+
          // Set Cascade View
          bgfx::setViewRect(mCascadeViews[i]->id, 0, 0, mCascadeSize, mCascadeSize);
          bgfx::setViewFrameBuffer(mCascadeViews[i]->id, mCascadeBuffers[i]);
@@ -364,9 +432,6 @@ namespace Scene
             );
          bgfx::touch(mCascadeViews[i]->id);
 
-         // ShadowMap Cascade Matrix
-         bgfx::setUniform(mCascadeMtxUniforms[i], mCascadeMtx[i]);
-
          // Blur
          F32 screenProj[16];
          F32 screenView[16];
@@ -408,18 +473,22 @@ namespace Scene
          | BGFX_STATE_MSAA
          ;
 
-      // Render each shadow casting object.
-      for (U32 n = 0; n < Rendering::renderCount; ++n)
+      // Render the shadow casters inside each cascade.
+      for (U32 i = 0; i < 4; ++i)
       {
-         Rendering::RenderData* item = &Rendering::renderList[n];
-         if (item->deleted || !item->castShadow) continue;
+         if (!mCascadeDirty[i]) continue;
 
-         // Render to each of the 4 cascades.
-         for (U32 i = 0; i < 4; ++i)
+         for (S32 n = 0; n < mCascadeCasters[i].size(); ++n)
          {
+            Rendering::RenderData* item = mCascadeCasters[i][n];
+
             // Transform Table.
             bgfx::setTransform(item->transformTable, item->transformCount);
 
+            // Skinned casters share the bones uploaded for the main view.
+            if (item->isSkinned)
+               Rendering::setBonePalette(item->boneOffset);
+
             // Buffers
             bgfx::setVertexBuffer(item->vertexBuffer);
             bgfx::setIndexBuffer(item->indexBuffer);
@@ -429,9 +498,7 @@ namespace Scene
 
             // Submit primitive
             // We need to use a different shader if its a skinned mesh. 
-            // Note: this may break down if a normal mesh uses more transforms
-            //       for something.
-            if (item->transformCount > 1)
+            if (item->isSkinned)
                bgfx::submit(mCascadeViews[i]->id, mVSMSkinnedShader->mProgram);
             else
                bgfx::submit(mCascadeViews[i]->id, mVSMShader->mProgram);
@@ -441,6 +508,9 @@ namespace Scene
       // Blur ShadowMaps
       for (U8 i = 0; i < 4; ++i)
       {
+         // Unchanged cascades were already blurred last frame.
+         if (!mCascadeDirty[i]) continue;
+
          bgfx::setTexture(0, Graphics::Shader::getTextureUniform(0), mCascadeTextures[i]);
          bgfx::setState(BGFX_STATE_RGB_WRITE | BGFX_STATE_ALPHA_WRITE | BGFX_STATE_MSAA);
          fullScreenQuad((F32)mCascadeSize, (F32)mCascadeSize);
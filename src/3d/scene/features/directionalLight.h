@@ -44,6 +44,10 @@
 #include <3d/rendering/renderable.h>
 #endif
 
+#ifndef _RENDERING_CULLING_H_
+#include <3d/rendering/culling.h>
+#endif
+
 namespace Scene
 {
    // Directional Light + Cascaded Shadow Mapping
@@ -68,6 +72,16 @@ namespace Scene
          bgfx::UniformHandle        mCascadeMtxUniforms[4];
          F32                        mCascadeMtx[4][16];
 
+         // Cascade Culling
+         // Each cascade only renders the casters inside its light space box and
+         // is skipped entirely when nothing it renders has changed.
+         Vector<Rendering::RenderData*> mShadowCasters;
+         Vector<Rendering::RenderData*> mCascadeCasters[4];
+         Rendering::Frustum         mCascadeFrustums[4];
+         U32                        mCascadeHash[4];
+         bool                       mCascadeDirty[4];
+         bool                       mCascadesValid;
+
          // Cascade Blur
          bgfx::FrameBufferHandle    mBlurBuffer;
          Graphics::Shader*          mHBlurShader;
@@ -97,6 +111,7 @@ namespace Scene
 
          void worldSpaceFrustumCorners(F32* _corners24f, F32 _near, F32 _far, F32 _projWidth, F32 _projHeight, const F32* __restrict _invViewMtx);
          void splitFrustum(F32* _splits, U8 _numSplits, F32 _near, F32 _far, F32 _splitWeight = 0.75f);
+         void cullCascades();
 
       public:
          DirectionalLight();
@@ -503,6 +503,7 @@ void GameConnection::setControlObject(GameObject *obj)
       obj->setControllingClient(this);
    }
 
-   // Okay, set our control object.
+   // Okay, set our control object. Ghosts are scoped around it too.
    mControlObject = obj;
+   setScopeObject(obj);
 }
\ No newline at end of file
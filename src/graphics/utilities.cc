@@ -31,6 +31,7 @@ namespace Graphics
    bgfx::VertexDecl PosUVBonesVertex::ms_decl;
    bgfx::VertexDecl PosUVNormalBonesVertex::ms_decl;
    bgfx::VertexDecl PosUVTBNBonesVertex::ms_decl;
+   bgfx::VertexDecl PosUVTBNCompactVertex::ms_decl;
    bgfx::VertexDecl PosColorVertex::ms_decl;
    bgfx::VertexDecl PosUVColorVertex::ms_decl;
 
@@ -147,6 +148,7 @@ namespace Graphics
       PosUVBonesVertex::init();
       PosUVNormalBonesVertex::init();
       PosUVTBNBonesVertex::init();
+      PosUVTBNCompactVertex::init();
       PosColorVertex::init();
       PosUVColorVertex::init();
 
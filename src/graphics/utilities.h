@@ -177,6 +177,36 @@ namespace Graphics
 	   static bgfx::VertexDecl ms_decl;
    };
 
+   // Static mesh layout, 40 bytes against 76 for PosUVTBNBonesVertex. UVs
+   // are half floats and the tangent frame is signed normalized shorts, so
+   // shaders read the same values they would from the float layout. The
+   // fourth component of each vector is padding.
+   struct PosUVTBNCompactVertex
+   {
+	   F32 m_x;
+	   F32 m_y;
+	   F32 m_z;
+      U16 m_u;
+      U16 m_v;
+      S16 m_tangent[4];
+      S16 m_bitangent[4];
+      S16 m_normal[4];
+
+	   static void init()
+	   {
+		   ms_decl
+			   .begin()
+			   .add(bgfx::Attrib::Position,  3, bgfx::AttribType::Float)
+			   .add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Half)
+            .add(bgfx::Attrib::Tangent,   4, bgfx::AttribType::Int16, true, true)
+            .add(bgfx::Attrib::Bitangent, 4, bgfx::AttribType::Int16, true, true)
+            .add(bgfx::Attrib::Normal,    4, bgfx::AttribType::Int16, true, true)
+			   .end();
+	   }
+
+	   static bgfx::VertexDecl ms_decl;
+   };
+
    struct PosColorVertex
    {
 	   F32 m_x;
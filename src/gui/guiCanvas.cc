@@ -27,6 +27,7 @@
 #include "platform/event.h"
 #include "platform/platform.h"
 #include "platform/platformVideo.h"
+#include "platform/threads/workerPool.h"
 #include "gui/guiTypes.h"
 #include "gui/guiControl.h"
 #include "gui/guiCanvas.h"
@@ -38,6 +39,7 @@
 #include "3d/rendering/common.h"
 #include "3d/scene/core.h"
 #include "3d/scene/camera.h"
+#include "3d/entity/meshLoader.h"
 #include "sysgui/sysgui.h"
 
 // TODO: MOVE THIS:
@@ -108,10 +110,12 @@ GuiCanvas::GuiCanvas()
    mUseBackgroundColor = true;
 
    // Initialize
+   WorkerPool::init(Con::getIntVariable("$pref::WorkerPool::threadCount", 3));
    Graphics::init();
    Physics::init();
    Rendering::init();
    Scene::init();
+   MeshLoader::init(Con::getIntVariable("$pref::MeshLoader::threadCount", 2));
 }
 
 GuiCanvas::~GuiCanvas()
@@ -120,10 +124,12 @@ GuiCanvas::~GuiCanvas()
       Canvas = 0;
 
    // Destroy
+   MeshLoader::destroy();
    Scene::destroy();
    Rendering::destroy();
    Physics::destroy();
    Graphics::destroy();
+   WorkerPool::destroy();
 }
 
 
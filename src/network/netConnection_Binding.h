@@ -218,6 +218,32 @@ ConsoleMethodWithDocs( NetConnection, getGhostsActive, S32, 2, 2, ())
     return object->getGhostsActive();
 }
 
+/*! Use the setScopeObject method to set the object ghosts are scoped around for this connection, usually the client's camera or player.
+    @param object The object to scope around, or 0 to scope everything.
+    @return No return value.
+    @sa getScopeObject
+*/
+ConsoleMethodWithDocs( NetConnection, setScopeObject, ConsoleVoid, 3, 3, ( object ))
+{
+    NetObject* scopeObject = NULL;
+    if ( dAtoi(argv[2]) != 0 && !Sim::findObject(argv[2], scopeObject) )
+    {
+        Con::errorf("NetConnection::setScopeObject - could not find object %s", argv[2]);
+        return;
+    }
+    object->setScopeObject(scopeObject);
+}
+
+/*! Use the getScopeObject method to get the object ghosts are scoped around for this connection.
+    @return The object's ID, or 0 if everything is in scope.
+    @sa setScopeObject
+*/
+ConsoleMethodWithDocs( NetConnection, getScopeObject, ConsoleInt, 2, 2, ())
+{
+    NetObject* scopeObject = object->getScopeObject();
+    return scopeObject ? scopeObject->getId() : 0;
+}
+
 ConsoleMethodGroupEndWithDocs(NetConnection)
 
 extern "C" {
@@ -325,10 +325,12 @@ void NetConnection::ghostWritePacket(BitStream *bstream, PacketNotify *notify)
          walk->flags &= ~GhostInfo::InScope;
    }
 
-   // TODO : Reconsider the idea of scope object.
-   //if(mScopeObject)
-   //   mScopeObject->onCameraScopeQuery(this, &camInfo);
-   Scene::onCameraScopeQuery(this, &camInfo);
+   // The scope object fills in where the client is looking from, so only the
+   // entities around it are visited. Without one everything is in scope.
+   if(mScopeObject)
+      mScopeObject->onCameraScopeQuery(this, &camInfo);
+   else
+      Scene::onCameraScopeQuery(this, &camInfo);
 
    for(i = mGhostZeroUpdateIndex - 1; i >= 0; i--)
    {
@@ -575,6 +577,11 @@ void NetConnection::setScopeObject(NetObject *obj)
    mScopeObject = obj;
 }
 
+NetObject *NetConnection::getScopeObject()
+{
+   return mScopeObject;
+}
+
 void NetConnection::detachObject(GhostInfo *info)
 {
    // mark it for ghost killin'
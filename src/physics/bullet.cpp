@@ -24,14 +24,40 @@
 #include "console/console.h"
 #include "sim/simBase.h"
 #include "memory/safeDelete.h"
+#include "io/fileStream.h"
 
 #include "bullet.h"
+#include "3d/entity/meshAsset.h"
 
 #include "math/mMath.h"
 #include <bx/timer.h>
 
+#include <BulletCollision/CollisionShapes/btShapeHull.h>
+
 namespace Physics 
 {
+   // --------------------------------------
+   // Physics Shape
+   // --------------------------------------
+
+   BulletPhysicsShape::BulletPhysicsShape()
+   {
+      shape          = NULL;
+      meshInterface  = NULL;
+      buffer         = NULL;
+      offset.setValue(0.0f, 0.0f, 0.0f);
+   }
+
+   // The shape goes first, a loaded BVH lives in the buffer.
+   BulletPhysicsShape::~BulletPhysicsShape()
+   {
+      SAFE_DELETE(shape);
+      SAFE_DELETE(meshInterface);
+
+      if ( buffer != NULL )
+         dFree(buffer);
+   }
+
    // --------------------------------------
    // Physics Object
    // --------------------------------------
@@ -41,6 +67,11 @@ namespace Physics
       _shape         = NULL;
       _motionState   = NULL;
       _rigidBody     = NULL;
+      _ownsShape     = true;
+      _shapeOffset.setValue(0.0f, 0.0f, 0.0f);
+      _position.set(0.0f, 0.0f, 0.0f);
+      _rotation.set(0.0f, 0.0f, 0.0f, 1.0f);
+      _listIndex     = 0;
    }
 
    BulletPhysicsObject::~BulletPhysicsObject()
@@ -50,19 +81,64 @@ namespace Physics
 
    void BulletPhysicsObject::initialize()
    {
-      _shape = new btBoxShape(btVector3(mScale.x / 2.0f, mScale.y / 2.0f, mScale.z / 2.0f));
+      BulletPhysicsShape* sharedShape = static_cast<BulletPhysicsShape*>(mShape);
+      btVector3 scale(mScale.x, mScale.y, mScale.z);
+      btScalar mass = mStatic ? 0.0f : mMass;
+
+      _ownsShape = true;
+      _shapeOffset.setValue(0.0f, 0.0f, 0.0f);
 
-      if ( mStatic )
+      switch(mShapeType)
+      {
+         case PhysicsShape::Sphere:
+            _shape = new btSphereShape(getMax(mScale.x, getMax(mScale.y, mScale.z)) / 2.0f);
+            break;
+
+         // Upright, scale y is the full height including the caps.
+         case PhysicsShape::Capsule:
+         {
+            F32 radius = getMax(mScale.x, mScale.z) / 2.0f;
+            _shape = new btCapsuleShape(radius, getMax(mScale.y - (radius * 2.0f), 0.0f));
+            break;
+         }
+
+         case PhysicsShape::ConvexHull:
+         {
+            btConvexHullShape* hull = new btConvexHullShape(&sharedShape->points[0].x(), sharedShape->points.size(), sizeof(btVector3));
+            hull->setLocalScaling(scale);
+            _shape = hull;
+            break;
+         }
+
+         // Concave shapes can only be static.
+         case PhysicsShape::TriangleMesh:
+            _shape = new btScaledBvhTriangleMeshShape(static_cast<btBvhTriangleMeshShape*>(sharedShape->shape), scale);
+            mass = 0.0f;
+            break;
+
+         case PhysicsShape::Heightfield:
+            _shape = sharedShape->shape;
+            _shapeOffset = sharedShape->offset;
+            _ownsShape = false;
+            mass = 0.0f;
+            break;
+
+         default:
+            _shape = new btBoxShape(btVector3(mScale.x / 2.0f, mScale.y / 2.0f, mScale.z / 2.0f));
+            break;
+      }
+
+      btVector3 origin = btVector3(_position.x, _position.y, _position.z) + _shapeOffset;
+      if ( mass <= 0.0f )
       {
          btRigidBody::btRigidBodyConstructionInfo fallRigidBodyCI(0, NULL, _shape);
          _rigidBody = new btRigidBody(fallRigidBodyCI);
          _rigidBody->setUserIndex(1);
          _rigidBody->setUserPointer(this);
          _rigidBody->setAngularFactor(btVector3(0,0,0));
-         _rigidBody->setWorldTransform(btTransform(btQuaternion(0, 0, 0, 1), btVector3(mPosition.x, mPosition.y, mPosition.z)));
+         _rigidBody->setWorldTransform(btTransform(btQuaternion(0, 0, 0, 1), origin));
       } else {
-         _motionState = new btDefaultMotionState(btTransform(btQuaternion(0, 0, 0, 1), btVector3(mPosition.x, mPosition.y, mPosition.z)));
-         btScalar mass = 1.0f;
+         _motionState = new btDefaultMotionState(btTransform(btQuaternion(0, 0, 0, 1), origin));
          btVector3 fallInertia(0, 0, 0);
          _shape->calculateLocalInertia(mass, fallInertia);
 
@@ -83,7 +159,9 @@ namespace Physics
       if ( !initialized )
          return;
 
-      SAFE_DELETE(_shape);
+      if ( _ownsShape )
+         SAFE_DELETE(_shape);
+      _shape = NULL;
       SAFE_DELETE(_rigidBody);
       SAFE_DELETE(_motionState);
 
@@ -108,12 +186,14 @@ namespace Physics
 
    BulletPhysicsEngine::~BulletPhysicsEngine()
    {
-      for (U32 i = 0; i < 1024; ++i)
-      {
-         BulletPhysicsObject* obj = &mPhysicsObjects[i];
-         if ( obj->initialized )
-            mDynamicsWorld->removeRigidBody(obj->_rigidBody);
-      }
+      _stopPhysicsThread();
+
+      for (S32 i = 0; i < mActiveList.size(); ++i)
+         mDynamicsWorld->removeRigidBody(mActiveList[i]->_rigidBody);
+
+      for (S32 i = 0; i < mObjectBlocks.size(); ++i)
+         delete [] mObjectBlocks[i];
+      mObjectBlocks.clear();
 
       SAFE_DELETE(mDynamicsWorld);
       SAFE_DELETE(mSolver);
@@ -122,29 +202,85 @@ namespace Physics
       SAFE_DELETE(mBroadphase);
    }
 
+   void BulletPhysicsEngine::_allocObjectBlock()
+   {
+      BulletPhysicsObject* block = new BulletPhysicsObject[ObjectBlockSize];
+      mObjectBlocks.push_back(block);
+
+      // Reversed so objects are handed out in address order.
+      for (S32 i = ObjectBlockSize - 1; i >= 0; --i)
+         mFreeObjects.push_back(&block[i]);
+   }
+
+   // Swap with the last entry, the moved object learns its new index.
+   void BulletPhysicsEngine::_removeFromList(Vector<BulletPhysicsObject*>& list, BulletPhysicsObject* obj)
+   {
+      U32 idx = obj->_listIndex;
+      BulletPhysicsObject* last = list.last();
+      list[idx] = last;
+      last->_listIndex = idx;
+      list.pop_back();
+   }
+
    PhysicsObject* BulletPhysicsEngine::getPhysicsObject(void* _user)
    {
-      for (U32 i = 0; i < 1024; ++i)
-      {
-         if ( mPhysicsObjects[i].deleted )
-         {
-            mPhysicsObjects[i].deleted = false;
-            mPhysicsObjects[i].user = _user;
-            return &mPhysicsObjects[i];
-         }
-      }
-      return NULL;
+      if ( mFreeObjects.size() == 0 )
+         _allocObjectBlock();
+
+      BulletPhysicsObject* obj = mFreeObjects.last();
+      mFreeObjects.pop_back();
+
+      trackObject(obj, _user);
+      return obj;
    }
 
-   void BulletPhysicsEngine::deletePhysicsObject(PhysicsObject* _obj)
+   void BulletPhysicsEngine::recyclePhysicsObject(PhysicsObject* _obj)
    {
-      for (U32 i = 0; i < 1024; ++i)
+      mFreeObjects.push_back(static_cast<BulletPhysicsObject*>(_obj));
+   }
+
+   void BulletPhysicsEngine::applyAction(const PhysicsAction& _action)
+   {
+      BulletPhysicsObject* obj = static_cast<BulletPhysicsObject*>(_action.object);
+      const Point3F& value = _action.vector3Value;
+
+      switch(_action.actionType)
       {
-         if ( &mPhysicsObjects[i] == _obj )
-         {
-            mPhysicsObjects[i].shouldBeDeleted = true;
-            return;
-         }
+         case PhysicsAction::addObject:
+            obj->_position = value;
+            obj->_rotation.set(0.0f, 0.0f, 0.0f, 1.0f);
+            obj->initialize();
+            mDynamicsWorld->addRigidBody(obj->_rigidBody);
+
+            obj->_listIndex = mActiveList.size();
+            mActiveList.push_back(obj);
+            break;
+
+         case PhysicsAction::removeObject:
+            if ( obj->initialized )
+            {
+               mDynamicsWorld->removeRigidBody(obj->_rigidBody);
+               obj->destroy();
+               _removeFromList(mActiveList, obj);
+            }
+            releaseObject(obj);
+            break;
+
+         // Teleports, nothing to interpolate from.
+         case PhysicsAction::setPosition:
+            obj->_position = value;
+            obj->_rotation.set(0.0f, 0.0f, 0.0f, 1.0f);
+            obj->_rigidBody->setWorldTransform(btTransform(btQuaternion(0, 0, 0, 1),btVector3(value.x, value.y, value.z) + obj->_shapeOffset));
+            obj->_rigidBody->activate();
+            break;
+
+         case PhysicsAction::setLinearVelocity:
+            obj->_rigidBody->setLinearVelocity(btVector3(value.x * 25.0f, value.y * 25.0f, value.z * 25.0f));
+            obj->_rigidBody->activate();
+            break;
+
+         default:
+            break;
       }
    }
 
@@ -154,92 +290,316 @@ namespace Physics
 
       // Step Physics Simulation
       mDynamicsWorld->stepSimulation(dt, 10);
+   }
+
+   void BulletPhysicsEngine::getContacts(Vector<PhysicsContact>& _contacts)
+   {
+      if ( mDynamicsWorld == NULL ) return;
 
-      // Detect Collisions
-      int numManifolds = mDynamicsWorld->getDispatcher()->getNumManifolds();
+      // Manifolds exist as soon as bounds overlap, only count the ones
+      // with actual contact points.
+      btDispatcher* dispatcher = mDynamicsWorld->getDispatcher();
+      int numManifolds = dispatcher->getNumManifolds();
       for (int i = 0; i < numManifolds; i++)
       {
-         btPersistentManifold* contactManifold = mDynamicsWorld->getDispatcher()->getManifoldByIndexInternal(i);
+         btPersistentManifold* contactManifold = dispatcher->getManifoldByIndexInternal(i);
+         if ( contactManifold->getNumContacts() == 0 )
+            continue;
+
          S32 indexA = contactManifold->getBody0()->getUserIndex();
          S32 indexB = contactManifold->getBody1()->getUserIndex();
          if ( indexA == 1 && indexB == 1 )
          {
-            Physics::PhysicsObject* objA = (Physics::PhysicsObject*)contactManifold->getBody0()->getUserPointer();
-            Physics::PhysicsObject* objB = (Physics::PhysicsObject*)contactManifold->getBody1()->getUserPointer();
-            Sim::postEvent(Sim::getRootGroup(), new PhysicsEvent(*objA, *objB), -1);
+            PhysicsContact contact;
+            contact.objectA = (Physics::PhysicsObject*)contactManifold->getBody0()->getUserPointer();
+            contact.objectB = (Physics::PhysicsObject*)contactManifold->getBody1()->getUserPointer();
+            _contacts.push_back(contact);
          }
-      } 
+      }
    }
 
-   void BulletPhysicsEngine::update()
+   void BulletPhysicsEngine::getTransforms(Vector<PhysicsTransform>& _transforms)
    {
-      for (U32 i = 0; i < 1024; ++i)
+      _transforms.setSize(mActiveList.size());
+
+      for (S32 i = 0; i < mActiveList.size(); ++i)
       {
-         BulletPhysicsObject* obj = &mPhysicsObjects[i];
-         if ( obj->deleted )
-            continue;
+         BulletPhysicsObject* obj = mActiveList[i];
+
+         btTransform trans;
+         btMotionState* objMotion = obj->_rigidBody->getMotionState();
+         if ( objMotion )
+            objMotion->getWorldTransform(trans);
+         else
+            trans = obj->_rigidBody->getWorldTransform();
+
+         btVector3 origin = trans.getOrigin() - (trans.getBasis() * obj->_shapeOffset);
+         btQuaternion rot = trans.getRotation();
+
+         PhysicsTransform& transform = _transforms[i];
+         transform.object        = obj;
+         transform.generation    = obj->generation;
+         transform.prevPosition  = obj->_position;
+         transform.prevRotation  = obj->_rotation;
+         transform.position.set(origin.x(), origin.y(), origin.z());
+         transform.rotation.set(rot.x(), rot.y(), rot.z(), rot.w());
+
+         obj->_position = transform.position;
+         obj->_rotation = transform.rotation;
+      }
+   }
+
+   // --------------------------------------
+   // Collision Shapes
+   // --------------------------------------
+
+   static U32 alignCookedOffset(U32 offset, U32 alignment)
+   {
+      return (offset + alignment - 1) & ~(alignment - 1);
+   }
+
+   static bool isCookedRangeValid(U32 offset, U32 count, U32 elementSize, U32 alignment, U32 fileSize)
+   {
+      if ( count == 0 )
+         return true;
+
+      if ( (offset & (alignment - 1)) != 0 )
+         return false;
+
+      return ((U64)offset + (U64)count * elementSize) <= fileSize;
+   }
+
+   PhysicsShape* BulletPhysicsEngine::createMeshShape(PhysicsShape::Type _type, MeshAsset* _mesh)
+   {
+      char cookedFilename[256];
+      dSprintf(cookedFilename, 256, "%s.%s.bin", _mesh->getMeshFile(), _type == PhysicsShape::ConvexHull ? "hull" : "bvh");
+      StringTableEntry cookedPath = Platform::getCachedFilePath(cookedFilename);
+
+      // The cooked file doesn't need the mesh to be loaded.
+      BulletPhysicsShape* shape = _loadCookedShape(_type, cookedPath);
+      if ( shape != NULL )
+         return shape;
+
+      if ( !_mesh->isLoaded() )
+         return NULL;
+
+      return _cookShape(_type, _mesh, cookedPath);
+   }
+
+   BulletPhysicsShape* BulletPhysicsEngine::_loadCookedShape(PhysicsShape::Type _type, const char* _path)
+   {
+      FileStream stream;
+      if ( !stream.open(_path, FileStream::Read) )
+         return NULL;
+
+      U32 fileSize = stream.getStreamSize();
+      if ( fileSize < sizeof(CookedHeader) )
+         return NULL;
+
+      CookedHeader header;
+      if ( !stream.read(sizeof(CookedHeader), &header) )
+         return NULL;
+
+      if ( header.magic != CookedMagic 
+         || header.version != CookedVersion 
+         || header.type != (U32)_type 
+         || header.fileSize != fileSize 
+         || !isCookedRangeValid(header.vertexOffset, header.vertexCount, sizeof(F32) * 3, CookedAlignment, fileSize)
+         || !isCookedRangeValid(header.indexOffset, header.indexCount, sizeof(U32), CookedAlignment, fileSize)
+         || !isCookedRangeValid(header.bvhOffset, header.bvhSize, 1, CookedAlignment, fileSize) )
+         return NULL;
+
+      void* buffer = dMalloc(fileSize + CookedAlignment);
+      U8* data = (U8*)(((size_t)buffer + CookedAlignment - 1) & ~(size_t)(CookedAlignment - 1));
+      stream.setPosition(0);
+      if ( !stream.read(fileSize, data) )
+      {
+         dFree(buffer);
+         return NULL;
+      }
+      stream.close();
+
+      return _createCookedShape(buffer, data);
+   }
 
-         if ( obj->shouldBeDeleted )
+   // Builds the shape from cooked data. Hulls copy their points out, triangle
+   // meshes keep using the buffer for their vertices, indices and BVH.
+   BulletPhysicsShape* BulletPhysicsEngine::_createCookedShape(void* _buffer, U8* _data)
+   {
+      const CookedHeader* header = (const CookedHeader*)_data;
+      const F32* vertices = (const F32*)(_data + header->vertexOffset);
+      if ( header->vertexCount == 0 || (header->type == PhysicsShape::TriangleMesh && (header->indexCount == 0 || header->bvhSize == 0)) )
+      {
+         dFree(_buffer);
+         return NULL;
+      }
+
+      BulletPhysicsShape* shape = new BulletPhysicsShape();
+      if ( header->type == PhysicsShape::ConvexHull )
+      {
+         shape->points.resize(header->vertexCount);
+         for (U32 i = 0; i < header->vertexCount; ++i)
+            shape->points[i].setValue(vertices[i * 3], vertices[(i * 3) + 1], vertices[(i * 3) + 2]);
+
+         dFree(_buffer);
+         return shape;
+      }
+
+      btIndexedMesh mesh;
+      mesh.m_numTriangles        = header->indexCount / 3;
+      mesh.m_triangleIndexBase   = _data + header->indexOffset;
+      mesh.m_triangleIndexStride = sizeof(U32) * 3;
+      mesh.m_numVertices         = header->vertexCount;
+      mesh.m_vertexBase          = _data + header->vertexOffset;
+      mesh.m_vertexStride        = sizeof(F32) * 3;
+      mesh.m_indexType           = PHY_INTEGER;
+      mesh.m_vertexType          = PHY_FLOAT;
+
+      shape->buffer = _buffer;
+      shape->meshInterface = new btTriangleIndexVertexArray();
+      shape->meshInterface->addIndexedMesh(mesh, PHY_INTEGER);
+
+      btOptimizedBvh* bvh = btOptimizedBvh::deSerializeInPlace(_data + header->bvhOffset, header->bvhSize, false);
+      if ( bvh == NULL )
+      {
+         delete shape;
+         return NULL;
+      }
+
+      btBvhTriangleMeshShape* meshShape = new btBvhTriangleMeshShape(shape->meshInterface, true, false);
+      meshShape->setOptimizedBvh(bvh);
+      shape->shape = meshShape;
+      return shape;
+   }
+
+   // Gathers every submesh into one vertex and index list, reduces it to a 
+   // hull or builds the BVH, then saves the result and loads it back like a
+   // cooked file.
+   BulletPhysicsShape* BulletPhysicsEngine::_cookShape(PhysicsShape::Type _type, MeshAsset* _mesh, const char* _path)
+   {
+      Vector<F32> vertices;
+      Vector<U32> indices;
+      U32 stride = _mesh->getVertexStride();
+
+      for (U32 n = 0; n < _mesh->getMeshCount(); ++n)
+      {
+         U32 baseVertex = vertices.size() / 3;
+         const U8* vertexData = _mesh->getVertexData(n);
+         for (U32 i = 0; i < _mesh->getVertexCount(n); ++i)
          {
-            if ( obj->initialized )
-            {
-               mDynamicsWorld->removeRigidBody(obj->_rigidBody);
-               obj->destroy();
-            }
+            const F32* position = (const F32*)(vertexData + (i * stride));
+            vertices.push_back(position[0]);
+            vertices.push_back(position[1]);
+            vertices.push_back(position[2]);
+         }
 
-            obj->deleted = true;
+         const U32* faces = _mesh->getFaces(n);
+         if ( faces == NULL )
             continue;
-         }
+
+         for (U32 i = 0; i < _mesh->getFaceCount(n) * 3; ++i)
+            indices.push_back(baseVertex + faces[i]);
       }
 
-      for (U32 i = 0; i < 1024; ++i)
+      if ( vertices.size() == 0 || (_type == PhysicsShape::TriangleMesh && indices.size() == 0) )
       {
-         BulletPhysicsObject* obj = &mPhysicsObjects[i];
-         if ( obj->deleted )
-            continue;
+         Con::warnf("[Physics] No geometry to build a collision shape from: %s", _mesh->getMeshFile());
+         return NULL;
+      }
 
-         if ( !obj->initialized )
+      btBvhTriangleMeshShape* meshShape = NULL;
+      btTriangleIndexVertexArray* meshInterface = NULL;
+      Vector<F32> hullVertices;
+      U32 bvhSize = 0;
+
+      if ( _type == PhysicsShape::ConvexHull )
+      {
+         btConvexHullShape source(vertices.address(), vertices.size() / 3, sizeof(F32) * 3);
+         btShapeHull hull(&source);
+         hull.buildHull(source.getMargin());
+
+         for (S32 i = 0; i < hull.numVertices(); ++i)
          {
-            obj->initialize();
-            mDynamicsWorld->addRigidBody(obj->_rigidBody);
-         } else {
-            // Pull updates from Physics thread.
-            btMotionState* objMotion = obj->_rigidBody->getMotionState();
-            if ( objMotion )
-            {
-               btTransform trans;
-               objMotion->getWorldTransform(trans);
+            const btVector3& point = hull.getVertexPointer()[i];
+            hullVertices.push_back(point.x());
+            hullVertices.push_back(point.y());
+            hullVertices.push_back(point.z());
+         }
+         vertices = hullVertices;
+         indices.clear();
+      } else {
+         meshInterface = new btTriangleIndexVertexArray(indices.size() / 3, (int*)indices.address(), sizeof(U32) * 3,
+            vertices.size() / 3, vertices.address(), sizeof(F32) * 3);
+         meshShape = new btBvhTriangleMeshShape(meshInterface, true, true);
+         bvhSize = meshShape->getOptimizedBvh()->calculateSerializeBufferSize();
+      }
 
-               F32 mat[16];
-               trans.getOpenGLMatrix(mat);
+      CookedHeader header;
+      dMemset(&header, 0, sizeof(CookedHeader));
+      header.magic         = CookedMagic;
+      header.version       = CookedVersion;
+      header.type          = _type;
+      header.vertexCount   = vertices.size() / 3;
+      header.vertexOffset  = alignCookedOffset(sizeof(CookedHeader), CookedAlignment);
+      header.indexCount    = indices.size();
+      header.indexOffset   = alignCookedOffset(header.vertexOffset + (vertices.size() * sizeof(F32)), CookedAlignment);
+      header.bvhSize       = bvhSize;
+      header.bvhOffset     = alignCookedOffset(header.indexOffset + (indices.size() * sizeof(U32)), CookedAlignment);
+      header.fileSize      = header.bvhOffset + bvhSize;
+
+      void* buffer = dMalloc(header.fileSize + CookedAlignment);
+      U8* data = (U8*)(((size_t)buffer + CookedAlignment - 1) & ~(size_t)(CookedAlignment - 1));
+      dMemset(data, 0, header.fileSize);
+      dMemcpy(data, &header, sizeof(CookedHeader));
+      dMemcpy(data + header.vertexOffset, vertices.address(), vertices.size() * sizeof(F32));
+      if ( indices.size() > 0 )
+         dMemcpy(data + header.indexOffset, indices.address(), indices.size() * sizeof(U32));
+
+      if ( meshShape != NULL )
+      {
+         meshShape->getOptimizedBvh()->serializeInPlace(data + header.bvhOffset, bvhSize, false);
+         SAFE_DELETE(meshShape);
+         SAFE_DELETE(meshInterface);
+      }
 
-               obj->mPosition.set(mat[12], mat[13], mat[14]);
-               btQuaternion rot = trans.getRotation();
-               obj->mRotation.set(QuatToEuler(rot.x(), rot.y(), rot.z(), rot.w()));
-            }
+      Platform::createPath(_path);
+      FileStream stream;
+      if ( stream.open(_path, FileStream::Write) )
+      {
+         stream.write(header.fileSize, data);
+         stream.close();
+      } else {
+         Con::errorf("[Physics] Could not save cooked collision shape: %s", _path);
+      }
 
-            // Apply actions from Game thread.
-            while ( obj->mPhysicsActions.size() > 0 )
-            {
-               Physics::PhysicsAction action = obj->mPhysicsActions.front();
-
-               switch(action.actionType)
-               {
-                  case Physics::PhysicsAction::setPosition:
-                     obj->mPosition = action.vector3Value;
-                     obj->_rigidBody->setWorldTransform(btTransform(btQuaternion(0, 0, 0, 1),btVector3(action.vector3Value.x, action.vector3Value.y, action.vector3Value.z)));
-                     obj->_rigidBody->activate();
-                     break;
-
-                  case Physics::PhysicsAction::setLinearVelocity:
-                     obj->_rigidBody->setLinearVelocity(btVector3(action.vector3Value.x * 25.0f, action.vector3Value.y * 25.0f, action.vector3Value.z * 25.0f));
-                     obj->_rigidBody->activate();
-                     break;
-               }
-
-               obj->mPhysicsActions.pop_front();
-            }
-         }
+      return _createCookedShape(buffer, data);
+   }
+
+   // Heights are copied so the terrain is free to change its own. The
+   // shape is centered on its bounds, the offset puts it back at the cell.
+   PhysicsShape* BulletPhysicsEngine::createHeightfieldShape(const PhysicsHeightfield* _heightfield)
+   {
+      if ( _heightfield->width < 2 || _heightfield->length < 2 )
+         return NULL;
+
+      BulletPhysicsShape* shape = new BulletPhysicsShape();
+      shape->heights = _heightfield->heights;
+
+      F32 minHeight = shape->heights[0];
+      F32 maxHeight = shape->heights[0];
+      for (S32 i = 1; i < shape->heights.size(); ++i)
+      {
+         minHeight = getMin(minHeight, shape->heights[i]);
+         maxHeight = getMax(maxHeight, shape->heights[i]);
       }
+
+      shape->shape = new btHeightfieldTerrainShape(_heightfield->width, _heightfield->length, shape->heights.address(), 
+         1.0f, minHeight, maxHeight, 1, PHY_FLOAT, false);
+
+      const Point3F& origin = _heightfield->origin;
+      shape->offset.setValue(origin.x + ((_heightfield->width - 1) * 0.5f), 
+                             origin.y + ((minHeight + maxHeight) * 0.5f), 
+                             origin.z + ((_heightfield->length - 1) * 0.5f));
+      return shape;
    }
-}
\ No newline at end of file
+}
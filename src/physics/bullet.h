@@ -51,8 +51,33 @@
 #include <btBulletDynamicsCommon.h>
 #endif
 
+#ifndef BT_HEIGHTFIELD_TERRAIN_SHAPE_H
+#include <BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
+#endif
+
 namespace Physics 
 {
+   // Shared collision data. Triangle meshes and heightfields share the shape
+   // itself, convex hulls share their points and every object builds its own
+   // btConvexHullShape so it can be scaled. Cooked mesh data is used straight
+   // out of the buffer it was loaded into.
+   class BulletPhysicsShape : public PhysicsShape
+   {
+      public:
+         btCollisionShape*                   shape;
+         btTriangleIndexVertexArray*         meshInterface;
+         btAlignedObjectArray<btVector3>     points;
+         void*                               buffer;
+         Vector<F32>                         heights;
+
+         // Heightfields are centered on their bounds, bodies are placed by
+         // this offset from the object's position.
+         btVector3                           offset;
+
+         BulletPhysicsShape();
+         ~BulletPhysicsShape();
+   };
+
    class BulletPhysicsObject : public PhysicsObject
    {
       public:
@@ -61,6 +86,18 @@ namespace Physics
          btRigidBody*            _rigidBody;
          btDefaultMotionState*   _motionState;
 
+         // Shared shapes are owned by their BulletPhysicsShape.
+         bool                    _ownsShape;
+         btVector3               _shapeOffset;
+
+         // Transform at the last published step. The body starts from 
+         // the position handed over with the add action.
+         Point3F                 _position;
+         QuatF                   _rotation;
+
+         // Position in the engine's active list once initialized.
+         U32                     _listIndex;
+
          BulletPhysicsObject();
          ~BulletPhysicsObject();
 
@@ -77,16 +114,54 @@ namespace Physics
          btCollisionDispatcher*                 mDispatcher;
          btSequentialImpulseConstraintSolver*   mSolver;
 
-         BulletPhysicsObject                    mPhysicsObjects[1024];
+         // Objects are allocated in blocks so the pointers handed out stay 
+         // valid as the pool grows. Released objects go on the free list
+         // (game thread), live ones are tracked in a dense list so a step 
+         // only touches them (physics thread).
+         static const U32                       ObjectBlockSize = 256;
+         Vector<BulletPhysicsObject*>           mObjectBlocks;
+         Vector<BulletPhysicsObject*>           mFreeObjects;
+         Vector<BulletPhysicsObject*>           mActiveList;
+
+         void _allocObjectBlock();
+         void _removeFromList(Vector<BulletPhysicsObject*>& list, BulletPhysicsObject* obj);
+
+         // Cooked mesh shapes are cached next to the mesh binary cache.
+         static const U32                       CookedMagic = 0x53433654; // 'T6CS'
+         static const U32                       CookedVersion = 1;
+         static const U32                       CookedAlignment = 16;
+
+         struct CookedHeader
+         {
+            U32 magic;
+            U32 version;
+            U32 type;
+            U32 fileSize;
+            U32 vertexCount;
+            U32 vertexOffset;
+            U32 indexCount;
+            U32 indexOffset;
+            U32 bvhSize;
+            U32 bvhOffset;
+            U32 reserved[2];
+         };
+
+         BulletPhysicsShape* _loadCookedShape(PhysicsShape::Type _type, const char* _path);
+         BulletPhysicsShape* _cookShape(PhysicsShape::Type _type, MeshAsset* _mesh, const char* _path);
+         BulletPhysicsShape* _createCookedShape(void* _buffer, U8* _data);
 
       public:
          BulletPhysicsEngine();
          ~BulletPhysicsEngine();
 
          virtual PhysicsObject* getPhysicsObject(void* _user = NULL);
-         virtual void           deletePhysicsObject(PhysicsObject* _obj);
-         virtual void simulate(F32 dt);
-         virtual void update();
+         virtual void           recyclePhysicsObject(PhysicsObject* _obj);
+         virtual void           applyAction(const PhysicsAction& _action);
+         virtual void           simulate(F32 dt);
+         virtual void           getTransforms(Vector<PhysicsTransform>& _transforms);
+         virtual void           getContacts(Vector<PhysicsContact>& _contacts);
+         virtual PhysicsShape*  createMeshShape(PhysicsShape::Type _type, MeshAsset* _mesh);
+         virtual PhysicsShape*  createHeightfieldShape(const PhysicsHeightfield* _heightfield);
    };
 }
 
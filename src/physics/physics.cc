@@ -42,7 +42,7 @@ namespace Physics
    void init()
    {
       engine = new BulletPhysicsEngine();
-      engine->setRunning(true);
+      engine->start();
    }
 
    void destroy()
@@ -71,4 +71,24 @@ namespace Physics
    {
       engine->deletePhysicsObject(_obj);
    }
+
+   PhysicsShape* getMeshShape(PhysicsShape::Type _type, MeshAsset* _mesh)
+   {
+      return engine->getMeshShape(_type, _mesh);
+   }
+
+   PhysicsShape* getHeightfieldShape(S32 _gridX, S32 _gridY)
+   {
+      return engine->getHeightfieldShape(_gridX, _gridY);
+   }
+
+   void releaseShape(PhysicsShape* _shape)
+   {
+      engine->releaseShape(_shape);
+   }
+
+   void setHeightfield(S32 _gridX, S32 _gridY, const F32* _heights, U32 _width, U32 _length, Point3F _origin)
+   {
+      engine->setHeightfield(_gridX, _gridY, _heights, _width, _length, _origin);
+   }
 }
\ No newline at end of file
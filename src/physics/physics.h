@@ -46,6 +46,12 @@ namespace Physics
 
    PhysicsObject* getPhysicsObject(void* _user = NULL);
    void deletePhysicsObject(PhysicsObject* _obj);
+
+   // Collision Shapes
+   PhysicsShape* getMeshShape(PhysicsShape::Type _type, MeshAsset* _mesh);
+   PhysicsShape* getHeightfieldShape(S32 _gridX, S32 _gridY);
+   void releaseShape(PhysicsShape* _shape);
+   void setHeightfield(S32 _gridX, S32 _gridY, const F32* _heights, U32 _width, U32 _length, Point3F _origin);
 }
 
 #endif
\ No newline at end of file
@@ -23,74 +23,475 @@
 #include "platform/platform.h"
 #include "console/console.h"
 #include "sim/simBase.h"
+#include "memory/safeDelete.h"
 
 #include "physicsEngine.h"
+#include "physicsThread.h"
+#include "3d/entity/meshAsset.h"
 
 #include "math/mMath.h"
 #include <bx/timer.h>
 
 namespace Physics 
 {
-   void* PhysicsEngine::smPhysicsExecuteMutex   = Mutex::createMutex();
-   void* PhysicsEngine::smPhysicsFinishedMutex  = Mutex::createMutex();
+   static S32 QSORT_CALLBACK compareContacts(const void* a, const void* b)
+   {
+      const PhysicsContact* contactA = (const PhysicsContact*)a;
+      const PhysicsContact* contactB = (const PhysicsContact*)b;
+
+      if ( contactA->objectA != contactB->objectA )
+         return contactA->objectA < contactB->objectA ? -1 : 1;
+      if ( contactA->objectB != contactB->objectB )
+         return contactA->objectB < contactB->objectB ? -1 : 1;
+      return 0;
+   }
+
+   void PhysicsObject::addAction(PhysicsAction::Enum _actionType, Point3F _vector3Value)
+   {
+      if ( engine != NULL )
+         engine->queueAction(this, _actionType, _vector3Value);
+   }
+
+   void PhysicsObject::setShape(PhysicsShape::Type _type, PhysicsShape* _shape)
+   {
+      if ( added )
+      {
+         if ( engine != NULL && _shape != NULL )
+            engine->releaseShape(_shape);
+         return;
+      }
+
+      if ( mShape != NULL && engine != NULL )
+         engine->releaseShape(mShape);
+
+      mShapeType = _type;
+      mShape = _shape;
+   }
 
    PhysicsEngine::PhysicsEngine()
    {
+      mPhysicsThread    = NULL;
       mAccumulatorTime  = 0.0f;
       mStepSize         = 1.0f / 60.0f;
 
-      mPreviousTime = (F64)( bx::getHPCounter()/F64(bx::getHPFrequency()) );
+      mSnapshotWrite    = 0;
+      mSnapshotShared   = 1;
+      mSnapshotRead     = 2;
+      mSnapshotTimes[0] = mSnapshotTimes[1] = mSnapshotTimes[2] = 0.0;
 
-#ifdef TORQUE_MULTITHREAD
-      // We lock this to cause the physics thread to block until we release it.
-      Mutex::lockMutex(PhysicsThread::smPhysicsFinishedMutex);
-
-      mPhysicsThread = new PhysicsThread(mStepSize, simulate);
-      mPhysicsThread->start();
-#endif
+      mPreviousTime = (F64)( bx::getHPCounter()/F64(bx::getHPFrequency()) );
 
-      mRunning = true;
+      // Nothing steps until start(), the derived engine isn't built yet.
+      mRunning = false;
       setProcessTicks(true);
    }
 
    PhysicsEngine::~PhysicsEngine()
    {
+      _stopPhysicsThread();
+
+      // The derived engine has destroyed every body by now.
+      for (S32 i = 0; i < mShapes.size(); ++i)
+         delete mShapes[i];
+      mShapes.clear();
+
+      for (S32 i = 0; i < mHeightfields.size(); ++i)
+         delete mHeightfields[i];
+      mHeightfields.clear();
+   }
+
+   // Called once the engine is fully constructed. The physics thread 
+   // calls into the derived engine as soon as it's running.
+   void PhysicsEngine::start()
+   {
+      mPreviousTime     = (F64)( bx::getHPCounter()/F64(bx::getHPFrequency()) );
+      mAccumulatorTime  = 0.0;
+      mRunning          = true;
+
 #ifdef TORQUE_MULTITHREAD
-      Mutex::unlockMutex(PhysicsThread::smPhysicsExecuteMutex);
-      Mutex::unlockMutex(PhysicsThread::smPhysicsFinishedMutex);
-      SAFE_DELETE(mPhysicsThread);
+      if ( mPhysicsThread == NULL )
+      {
+         mPhysicsThread = new PhysicsThread(this, mStepSize);
+         mPhysicsThread->start();
+      }
 #endif
    }
 
+   // Derived engines call this before tearing down their world so the 
+   // physics thread is never left stepping it.
+   void PhysicsEngine::_stopPhysicsThread()
+   {
+      if ( mPhysicsThread == NULL )
+         return;
+
+      mPhysicsThread->stop();
+      mPhysicsThread->join();
+      SAFE_DELETE(mPhysicsThread);
+   }
+
    void PhysicsEngine::processPhysics()
    {  
+      _flushActions();
+
 #ifdef TORQUE_MULTITHREAD
-      // This will block until the physics thread is finished execution.
-      if( Mutex::lockMutex(PhysicsThread::smPhysicsExecuteMutex) )
+      // The physics thread keeps its own clock, the game side only exchanges
+      // actions and results once per step.
+      mAccumulatorTime = mFmodD(mAccumulatorTime, mStepSize);
+#else
+      while ( mAccumulatorTime >= mStepSize )
+      {
+         mAccumulatorTime -= mStepSize;
+         step(mStepSize, mPreviousTime - mAccumulatorTime);
+      }
+#endif
+
+      update();
+   }
+
+   void PhysicsEngine::trackObject(PhysicsObject* _obj, void* _user)
+   {
+      // Recycled objects start over from the defaults.
+      _obj->mPosition.set(0.0f, 0.0f, 0.0f);
+      _obj->mRotation.set(0.0f, 0.0f, 0.0f);
+      _obj->mScale.set(1.0f, 1.0f, 1.0f);
+      _obj->mStatic = false;
+      _obj->mMass = 1.0f;
+      _obj->mShapeType = PhysicsShape::Box;
+      _obj->mShape = NULL;
+      _obj->onCollideDelegate.clear();
+      _obj->onTransformDelegate.clear();
+      _obj->added = false;
+      _obj->shouldBeDeleted = false;
+      _obj->deleted = false;
+      _obj->generation++;
+      _obj->engine = this;
+      _obj->user = _user;
+
+      mPendingObjects.push_back(_obj);
+   }
+
+   void PhysicsEngine::releaseObject(PhysicsObject* _obj)
+   {
+      if ( mReleaseOverflow.size() > 0 || !mReleaseQueue.push(_obj) )
+         mReleaseOverflow.push_back(_obj);
+   }
+
+   void PhysicsEngine::queueAction(PhysicsObject* _obj, PhysicsAction::Enum _actionType, Point3F _vector3Value)
+   {
+      PhysicsAction action;
+      action.object        = _obj;
+      action.actionType    = _actionType;
+      action.vector3Value  = _vector3Value;
+
+      // Objects that haven't been added yet hold on to their actions until
+      // the flush that pushes their add, which can be several ticks away
+      // for objects waiting on a shape.
+      if ( !_obj->added )
+         mHeldActions.push_back(action);
+      else if ( mActionOverflow.size() > 0 || !mActionQueue.push(action) )
+         mActionOverflow.push_back(action);
+   }
+
+   void PhysicsEngine::_flushActions()
+   {
+      if ( mPendingObjects.size() > 0 )
       {
-         // Unlocking this will stop the physics thread from blocking at the
-         // end of it's tick.
-         Mutex::unlockMutex(PhysicsThread::smPhysicsFinishedMutex);
+         Vector<PhysicsAction> actions;
+         actions.reserve(mPendingObjects.size() + mActionOverflow.size());
+
+         // Objects still waiting on their shape stay pending.
+         S32 waiting = 0;
+         for (S32 i = 0; i < mPendingObjects.size(); ++i)
+         {
+            PhysicsObject* obj = mPendingObjects[i];
+            if ( !obj->isShapeReady() )
+            {
+               mPendingObjects[waiting++] = obj;
+               continue;
+            }
 
-         // We're sycned, it's a great time for updates.
-         update();
+            obj->added = true;
 
-         // We're going to unlock this so the physics thread can 
-         // execute while we get on with the rest of the frames.
-         Mutex::unlockMutex(PhysicsThread::smPhysicsExecuteMutex);
+            PhysicsAction action;
+            action.object        = obj;
+            action.actionType    = PhysicsAction::addObject;
+            action.vector3Value  = obj->mPosition;
+            actions.push_back(action);
+         }
+         mPendingObjects.setSize(waiting);
 
-         // And lock this so the physics thread will lock again at 
-         // the end of execution of a time step.
-         Mutex::lockMutex(PhysicsThread::smPhysicsFinishedMutex);
+         // Held actions follow the add of their object, in queued order.
+         if ( actions.size() > 0 )
+         {
+            S32 held = 0;
+            for (S32 i = 0; i < mHeldActions.size(); ++i)
+            {
+               if ( mHeldActions[i].object->added )
+                  actions.push_back(mHeldActions[i]);
+               else
+                  mHeldActions[held++] = mHeldActions[i];
+            }
+            mHeldActions.setSize(held);
+
+            actions.merge(mActionOverflow);
+            mActionOverflow.clear();
+            mActionOverflow.merge(actions);
+         }
       }
-#else
-      while ( mAccumulatorTime >= mStepSize )
+
+      U32 pushed = 0;
+      while ( pushed < (U32)mActionOverflow.size() && mActionQueue.push(mActionOverflow[pushed]) )
+         pushed++;
+
+      if ( pushed > 0 )
+         mActionOverflow.erase(0, pushed);
+   }
+
+   void PhysicsEngine::step(F32 dt, F64 time)
+   {
+      // Anything the release queue couldn't take last step goes first.
+      U32 released = 0;
+      while ( released < (U32)mReleaseOverflow.size() && mReleaseQueue.push(mReleaseOverflow[released]) )
+         released++;
+
+      if ( released > 0 )
+         mReleaseOverflow.erase(0, released);
+
+      U32 contacts = 0;
+      while ( contacts < (U32)mContactOverflow.size() && mContactQueue.push(mContactOverflow[contacts]) )
+         contacts++;
+
+      if ( contacts > 0 )
+         mContactOverflow.erase(0, contacts);
+
+      PhysicsAction action;
+      while ( mActionQueue.pop(action) )
+         applyAction(action);
+
+      simulate(dt);
+      _updateContacts();
+
+      mSnapshotTimes[mSnapshotWrite] = time;
+      _publishSnapshot();
+   }
+
+   void PhysicsEngine::_queueContact(const PhysicsContact& _contact)
+   {
+      if ( mContactOverflow.size() > 0 || !mContactQueue.push(_contact) )
+         mContactOverflow.push_back(_contact);
+   }
+
+   // Physics thread. Sorts and dedups this step's pairs then walks them
+   // alongside last step's to find the ones that began or ended.
+   void PhysicsEngine::_updateContacts()
+   {
+      mStepContacts.clear();
+      getContacts(mStepContacts);
+
+      for (S32 i = 0; i < mStepContacts.size(); ++i)
       {
-         simulate(mStepSize);
-         mAccumulatorTime -= mStepSize;
+         PhysicsContact& contact = mStepContacts[i];
+         if ( contact.objectB < contact.objectA )
+         {
+            PhysicsObject* obj = contact.objectA;
+            contact.objectA = contact.objectB;
+            contact.objectB = obj;
+         }
       }
-      update();
-#endif
+
+      if ( mStepContacts.size() > 1 )
+         dQsort(mStepContacts.address(), mStepContacts.size(), sizeof(PhysicsContact), compareContacts);
+
+      S32 unique = 0;
+      for (S32 i = 0; i < mStepContacts.size(); ++i)
+      {
+         if ( unique > 0 && compareContacts(&mStepContacts[unique - 1], &mStepContacts[i]) == 0 )
+            continue;
+         mStepContacts[unique++] = mStepContacts[i];
+      }
+      mStepContacts.setSize(unique);
+
+      S32 prev = 0;
+      S32 next = 0;
+      while ( prev < mContacts.size() || next < mStepContacts.size() )
+      {
+         S32 order = 0;
+         if ( prev >= mContacts.size() )
+            order = 1;
+         else if ( next >= mStepContacts.size() )
+            order = -1;
+         else
+            order = compareContacts(&mContacts[prev], &mStepContacts[next]);
+
+         if ( order < 0 )
+         {
+            // Generations are kept from when both objects were known to be
+            // alive, either could have been released since.
+            PhysicsContact contact = mContacts[prev++];
+            contact.state = PhysicsContact::End;
+            _queueContact(contact);
+            continue;
+         }
+
+         PhysicsContact& contact = mStepContacts[next++];
+         contact.generationA = contact.objectA->generation;
+         contact.generationB = contact.objectB->generation;
+
+         if ( order > 0 )
+         {
+            contact.state = PhysicsContact::Begin;
+            _queueContact(contact);
+         } else {
+            contact.state = PhysicsContact::Persist;
+            prev++;
+         }
+      }
+
+      mContacts.clear();
+      mContacts.merge(mStepContacts);
+   }
+
+   // Game thread. Everything queued since the last tick goes out at once.
+   void PhysicsEngine::_dispatchContacts()
+   {
+      PhysicsContact contact;
+      while ( mContactQueue.pop(contact) )
+      {
+         PhysicsObject* objA = contact.objectA;
+         PhysicsObject* objB = contact.objectB;
+
+         // Callbacks can delete objects, so check both every time.
+         if ( objA->deleted || objA->shouldBeDeleted || objA->generation != contact.generationA )
+            continue;
+         if ( objB->deleted || objB->shouldBeDeleted || objB->generation != contact.generationB )
+            continue;
+
+         if ( !objA->onCollideDelegate.empty() )
+            objA->onCollideDelegate(objB->user, contact.state);
+
+         if ( objB->deleted || objB->shouldBeDeleted || objA->shouldBeDeleted )
+            continue;
+
+         if ( !objB->onCollideDelegate.empty() )
+            objB->onCollideDelegate(objA->user, contact.state);
+      }
+   }
+
+   S32 PhysicsEngine::_exchangeSnapshot(S32 value)
+   {
+      S32 prev = mSnapshotShared;
+      for (;;)
+      {
+         S32 result = bx::atomicCompareAndSwap(&mSnapshotShared, prev, value);
+         if ( result == prev )
+            return prev;
+         prev = result;
+      }
+   }
+
+   // Physics thread.
+   void PhysicsEngine::_publishSnapshot()
+   {
+      Vector<PhysicsTransform>& transforms = mSnapshots[mSnapshotWrite];
+      transforms.clear();
+      getTransforms(transforms);
+
+      S32 prev = _exchangeSnapshot(mSnapshotWrite | SnapshotFresh);
+      mSnapshotWrite = prev & SnapshotIndexMask;
+   }
+
+   // Game thread.
+   void PhysicsEngine::_readSnapshot()
+   {
+      if ( !(mSnapshotShared & SnapshotFresh) )
+         return;
+
+      S32 prev = _exchangeSnapshot(mSnapshotRead);
+      mSnapshotRead = prev & SnapshotIndexMask;
+
+      const Vector<PhysicsTransform>& transforms = mSnapshots[mSnapshotRead];
+      for (S32 i = 0; i < transforms.size(); ++i)
+      {
+         const PhysicsTransform& transform = transforms[i];
+         PhysicsObject* obj = transform.object;
+
+         // Skip objects deleted or recycled since the snapshot was taken.
+         if ( obj->deleted || obj->shouldBeDeleted || obj->generation != transform.generation )
+            continue;
+
+         obj->mPosition = transform.position;
+         obj->mRotation = QuatToEuler(transform.rotation.x, transform.rotation.y, transform.rotation.z, transform.rotation.w);
+      }
+   }
+
+   // Game thread, every frame. Blends the last two steps of the current 
+   // snapshot by how far the clock has moved past it.
+   void PhysicsEngine::_interpolateTransforms(F64 time)
+   {
+      const Vector<PhysicsTransform>& transforms = mSnapshots[mSnapshotRead];
+      if ( transforms.size() == 0 )
+         return;
+
+      F32 alpha = mClampF((F32)((time - mSnapshotTimes[mSnapshotRead]) / mStepSize), 0.0f, 1.0f);
+
+      for (S32 i = 0; i < transforms.size(); ++i)
+      {
+         const PhysicsTransform& transform = transforms[i];
+         PhysicsObject* obj = transform.object;
+
+         if ( obj->onTransformDelegate.empty() )
+            continue;
+
+         if ( obj->deleted || obj->shouldBeDeleted || obj->generation != transform.generation )
+            continue;
+
+         Point3F pos = transform.prevPosition + (transform.position - transform.prevPosition) * alpha;
+
+         // Normalized lerp, steps are small enough that it's as good as slerp.
+         const QuatF& q0 = transform.prevRotation;
+         const QuatF& q1 = transform.rotation;
+         F32 sign = q0.dot(q1) < 0.0f ? -1.0f : 1.0f;
+         QuatF rot(q0.x + (q1.x * sign - q0.x) * alpha,
+                   q0.y + (q1.y * sign - q0.y) * alpha,
+                   q0.z + (q1.z * sign - q0.z) * alpha,
+                   q0.w + (q1.w * sign - q0.w) * alpha);
+         rot.normalize();
+
+         // Same layout bullet uses for its OpenGL matrices.
+         F32* mtx = obj->mTransformationMatrix;
+         F32 xx = rot.x * rot.x, yy = rot.y * rot.y, zz = rot.z * rot.z;
+         F32 xy = rot.x * rot.y, xz = rot.x * rot.z, yz = rot.y * rot.z;
+         F32 wx = rot.w * rot.x, wy = rot.w * rot.y, wz = rot.w * rot.z;
+
+         mtx[0]  = 1.0f - 2.0f * (yy + zz);
+         mtx[1]  = 2.0f * (xy + wz);
+         mtx[2]  = 2.0f * (xz - wy);
+         mtx[3]  = 0.0f;
+         mtx[4]  = 2.0f * (xy - wz);
+         mtx[5]  = 1.0f - 2.0f * (xx + zz);
+         mtx[6]  = 2.0f * (yz + wx);
+         mtx[7]  = 0.0f;
+         mtx[8]  = 2.0f * (xz + wy);
+         mtx[9]  = 2.0f * (yz - wx);
+         mtx[10] = 1.0f - 2.0f * (xx + yy);
+         mtx[11] = 0.0f;
+         mtx[12] = pos.x;
+         mtx[13] = pos.y;
+         mtx[14] = pos.z;
+         mtx[15] = 1.0f;
+
+         obj->onTransformDelegate(mtx);
+      }
+   }
+
+   void PhysicsEngine::update()
+   {
+      PhysicsObject* obj = NULL;
+      while ( mReleaseQueue.pop(obj) )
+         _recycleObject(obj);
+
+      _readSnapshot();
+      _dispatchContacts();
    }
 
    PhysicsObject* PhysicsEngine::getPhysicsObject(void* _user)
@@ -99,6 +500,188 @@ namespace Physics
    }
 
    void PhysicsEngine::deletePhysicsObject(PhysicsObject* _obj)
+   {
+      if ( _obj == NULL || _obj->deleted || _obj->shouldBeDeleted )
+         return;
+
+      // Never reached the physics thread, drop it and anything it queued.
+      if ( !_obj->added )
+      {
+         for (S32 i = 0; i < mPendingObjects.size(); ++i)
+         {
+            if ( mPendingObjects[i] == _obj )
+            {
+               mPendingObjects.erase(i);
+               break;
+            }
+         }
+
+         for (S32 i = mHeldActions.size() - 1; i >= 0; --i)
+         {
+            if ( mHeldActions[i].object == _obj )
+               mHeldActions.erase(i);
+         }
+
+         _recycleObject(_obj);
+         return;
+      }
+
+      _obj->shouldBeDeleted = true;
+      queueAction(_obj, PhysicsAction::removeObject, Point3F(0.0f, 0.0f, 0.0f));
+   }
+
+   // Game thread, once the physics thread is done with the object.
+   void PhysicsEngine::_recycleObject(PhysicsObject* _obj)
+   {
+      if ( _obj->mShape != NULL )
+         releaseShape(_obj->mShape);
+
+      _obj->mShape = NULL;
+      _obj->deleted = true;
+      _obj->shouldBeDeleted = false;
+      _obj->user = NULL;
+      _obj->onCollideDelegate.clear();
+      _obj->onTransformDelegate.clear();
+      recyclePhysicsObject(_obj);
+   }
+
+   PhysicsShape* PhysicsEngine::_findShape(StringTableEntry _key, U32 _version)
+   {
+      for (S32 i = 0; i < mShapes.size(); ++i)
+      {
+         if ( mShapes[i]->key == _key && mShapes[i]->version == _version )
+            return mShapes[i];
+      }
+      return NULL;
+   }
+
+   PhysicsShape* PhysicsEngine::getMeshShape(PhysicsShape::Type _type, MeshAsset* _mesh)
+   {
+      if ( _mesh == NULL || PhysicsShape::isPrimitive(_type) || _type == PhysicsShape::Heightfield )
+         return NULL;
+
+      char key[256];
+      dSprintf(key, 256, "%s:%d", _mesh->getMeshFile(), (S32)_type);
+      StringTableEntry shapeKey = StringTable->insert(key);
+
+      PhysicsShape* shape = _findShape(shapeKey, 0);
+      if ( shape == NULL )
+      {
+         shape = createMeshShape(_type, _mesh);
+         if ( shape == NULL )
+            return NULL;
+
+         shape->type = _type;
+         shape->key = shapeKey;
+         mShapes.push_back(shape);
+      }
+
+      shape->refCount++;
+      return shape;
+   }
+
+   PhysicsShape* PhysicsEngine::getHeightfieldShape(S32 _gridX, S32 _gridY)
+   {
+      PhysicsHeightfield* heightfield = NULL;
+      for (S32 i = 0; i < mHeightfields.size(); ++i)
+      {
+         if ( mHeightfields[i]->gridX == _gridX && mHeightfields[i]->gridY == _gridY )
+         {
+            heightfield = mHeightfields[i];
+            break;
+         }
+      }
+
+      if ( heightfield == NULL )
+         return NULL;
+
+      char key[64];
+      dSprintf(key, 64, "heightfield:%d:%d", _gridX, _gridY);
+      StringTableEntry shapeKey = StringTable->insert(key);
+
+      // Edited terrain gets a new shape, objects already using the old one
+      // keep it until they're gone.
+      PhysicsShape* shape = _findShape(shapeKey, heightfield->version);
+      if ( shape == NULL )
+      {
+         shape = createHeightfieldShape(heightfield);
+         if ( shape == NULL )
+            return NULL;
+
+         shape->type = PhysicsShape::Heightfield;
+         shape->key = shapeKey;
+         shape->version = heightfield->version;
+         mShapes.push_back(shape);
+      }
+
+      shape->refCount++;
+      return shape;
+   }
+
+   void PhysicsEngine::releaseShape(PhysicsShape* _shape)
+   {
+      if ( _shape == NULL || _shape->refCount == 0 )
+         return;
+
+      if ( --_shape->refCount > 0 )
+         return;
+
+      for (S32 i = 0; i < mShapes.size(); ++i)
+      {
+         if ( mShapes[i] == _shape )
+         {
+            mShapes.erase_fast(i);
+            break;
+         }
+      }
+      delete _shape;
+   }
+
+   void PhysicsEngine::setHeightfield(S32 _gridX, S32 _gridY, const F32* _heights, U32 _width, U32 _length, Point3F _origin)
+   {
+      PhysicsHeightfield* heightfield = NULL;
+      for (S32 i = 0; i < mHeightfields.size(); ++i)
+      {
+         if ( mHeightfields[i]->gridX == _gridX && mHeightfields[i]->gridY == _gridY )
+         {
+            heightfield = mHeightfields[i];
+            break;
+         }
+      }
+
+      if ( heightfield == NULL )
+      {
+         heightfield = new PhysicsHeightfield();
+         heightfield->gridX = _gridX;
+         heightfield->gridY = _gridY;
+         heightfield->version = 0;
+         mHeightfields.push_back(heightfield);
+      }
+
+      heightfield->width = _width;
+      heightfield->length = _length;
+      heightfield->origin = _origin;
+      heightfield->heights.setSize(_width * _length);
+      dMemcpy(heightfield->heights.address(), _heights, _width * _length * sizeof(F32));
+      heightfield->version++;
+   }
+
+   void PhysicsEngine::recyclePhysicsObject(PhysicsObject* _obj)
+   {
+      //
+   }
+
+   PhysicsShape* PhysicsEngine::createMeshShape(PhysicsShape::Type _type, MeshAsset* _mesh)
+   {
+      return NULL;
+   }
+
+   PhysicsShape* PhysicsEngine::createHeightfieldShape(const PhysicsHeightfield* _heightfield)
+   {
+      return NULL;
+   }
+
+   void PhysicsEngine::applyAction(const PhysicsAction& _action)
    {
       //
    }
@@ -108,11 +691,19 @@ namespace Physics
       //
    }
 
-   void PhysicsEngine::update()
+   void PhysicsEngine::getTransforms(Vector<PhysicsTransform>& _transforms)
    {
       //
    }
 
+   void PhysicsEngine::getContacts(Vector<PhysicsContact>& _contacts)
+   {
+      //
+   }
+
+   // Tickable interpolates before advanceTime, which would always blend 
+   // against last frame's snapshot. Transforms are interpolated at the end
+   // of advanceTime instead.
    void PhysicsEngine::interpolateTick( F32 delta )
    {  
       //
@@ -134,20 +725,12 @@ namespace Physics
 
       if ( mAccumulatorTime >= mStepSize )
          processPhysics();
+
+      _interpolateTransforms(time);
    }
 
    void PhysicsEngine::setRunning(bool value)
    {
       mRunning = value;
    }
-
-   // Thread Safe Collision Event
-   void PhysicsEvent::process(SimObject *object)
-   {
-      if ( !mObjA.onCollideDelegate.empty() )
-         mObjA.onCollideDelegate(mObjB.user);
-
-      if ( !mObjB.onCollideDelegate.empty() )
-         mObjB.onCollideDelegate(mObjA.user);
-   }
 }
\ No newline at end of file
@@ -43,28 +43,52 @@
 #include "platform/Tickable.h"
 #endif
 
+#include <bx/cpu.h>
+
 // ------------------------------------------------------------------------------
 //  How the Physics Engine works:
 // ------------------------------------------------------------------------------
 //
-//   1) PhysicsEngine::InterpolateTick is called
-//   2) If time passed is >= 1.0f/32.0f PhysicsEngine::processPhysics is called
-//   3) If single-threaded, step is processed, physics is updated.
-//   4) If multi-threaded:
-//      a) Attempt to lock Execute mutex. The Physics Thread should be done by
-//           now so this should be immediately available.
-//      b) Unlock Finished mutex which lets the Physics Thread lock it.
-//           The physics thread is now stuck trying to lock Execute again, but we 
-//           hold that. This means we're synced and free to operate on the data.
-//      c) Sync data between physics thread and main thread.
-//      d) Unlock Execute mutex, letting the physics thread start it's next step.
-//      e) Lock Finished mutex until the next time Physics Engine ticks.
+//   The game thread and the physics thread never wait on each other. They
+//   only share four things:
+//
+//   1) Action Queue (game -> physics): a fixed size single producer/single
+//        consumer ring. Object adds, removes and every setter are queued as
+//        actions and applied by the physics thread at the start of a step.
+//        If the ring is full the game thread keeps the overflow and pushes
+//        it on the next tick, so order is always preserved.
+//   2) Release Queue (physics -> game): objects the physics thread is done
+//        with. The game thread only recycles an object once it shows up here.
+//   3) Transform Snapshot (physics -> game): three buffers of transforms. The
+//        physics thread fills one after each step and swaps it with the shared
+//        slot, the game thread swaps the shared slot for its own when a fresh
+//        one is there. Neither side ever touches the buffer the other holds.
+//   4) Contact Queue (physics -> game): after each step the touching body 
+//        pairs are compared against the step before. Pairs that began or
+//        ended are queued and dispatched to onCollideDelegate in one batch
+//        on the game tick. Persisting pairs generate nothing.
+//
+//   Single-threaded the game tick simply performs the physics steps itself
+//   between pushing actions and reading back the snapshot.
+//
+//   Collision shapes other than the primitives are cooked on the game thread
+//   and shared between objects. An object waits on the game side until its
+//   shape is ready, along with any actions queued for it, and only lets go
+//   of the shape once the physics thread has released the object.
+//
+//   Every transform in a snapshot carries the previous and current step. Each
+//   frame the game thread blends them by how far it is past the step and
+//   hands the result to the object's onTransformDelegate for rendering.
 //
 // ------------------------------------------------------------------------------
 
+class MeshAsset;
+
 namespace Physics 
 {
    class PhysicsThread;
+   class PhysicsEngine;
+   class PhysicsObject;
 
    // Shared data between main thread and physics thread.
    struct PhysicsAction
@@ -76,27 +100,156 @@ namespace Physics
          setScale,
          setLinearVelocity,
          applyForce,
+         addObject,
+         removeObject,
          COUNT
       };
 
+      PhysicsObject* object;
       Enum actionType;
       Point3F vector3Value;
    };
 
+   // Transform written by the physics thread after a step, along with the
+   // one from the step before it.
+   struct PhysicsTransform
+   {
+      PhysicsObject* object;
+      U32 generation;
+      Point3F prevPosition;
+      QuatF prevRotation;
+      Point3F position;
+      QuatF rotation;
+   };
+
+   // Touching pair of bodies, objectA always has the lower address. 
+   struct PhysicsContact
+   {
+      enum State
+      {
+         Begin,
+         Persist,
+         End
+      };
+
+      PhysicsObject* objectA;
+      PhysicsObject* objectB;
+      U32 generationA;
+      U32 generationB;
+      State state;
+   };
+
+   // Cooked collision shape, shared between objects and reference counted on
+   // the game thread. Primitives are built per object from its scale and
+   // never need one.
+   class PhysicsShape
+   {
+      public:
+         enum Type
+         {
+            Box,
+            Sphere,
+            Capsule,
+            ConvexHull,
+            TriangleMesh,
+            Heightfield,
+            COUNT
+         };
+
+         Type              type;
+         StringTableEntry  key;
+         U32               version;
+         U32               refCount;
+
+         PhysicsShape()
+         {
+            type = Box;
+            key = NULL;
+            version = 0;
+            refCount = 0;
+         }
+         virtual ~PhysicsShape() { }
+
+         static bool isPrimitive(Type _type) { return _type == Box || _type == Sphere || _type == Capsule; }
+   };
+
+   // Terrain heights handed over by the terrain, see PhysicsEngine::setHeightfield.
+   struct PhysicsHeightfield
+   {
+      S32         gridX;
+      S32         gridY;
+      U32         width;
+      U32         length;
+      Point3F     origin;
+      Vector<F32> heights;
+      U32         version;
+   };
+
+   // Fixed size single producer/single consumer ring. Each index is only
+   // ever written by one side, push and pop never block.
+   template<typename T, U32 Capacity>
+   class PhysicsQueue
+   {
+      protected:
+         T              mItems[Capacity];
+         volatile U32   mRead;
+         volatile U32   mWrite;
+
+      public:
+         PhysicsQueue() : mRead(0), mWrite(0) { }
+
+         // Producer only.
+         bool push(const T& item)
+         {
+            U32 write = mWrite;
+            U32 next = (write + 1) & (Capacity - 1);
+            if ( next == mRead )
+               return false;
+
+            mItems[write] = item;
+            bx::memoryBarrier();
+            mWrite = next;
+            return true;
+         }
+
+         // Consumer only.
+         bool pop(T& item)
+         {
+            U32 read = mRead;
+            if ( read == mWrite )
+               return false;
+
+            bx::memoryBarrier();
+            item = mItems[read];
+            bx::memoryBarrier();
+            mRead = (read + 1) & (Capacity - 1);
+            return true;
+         }
+   };
+
    class PhysicsObject
    {
       public:
-         Vector<PhysicsAction>               mPhysicsActions;
          F32                                 mTransformationMatrix[16];
          Point3F                             mPosition;
          Point3F                             mRotation;
          Point3F                             mScale;
          bool                                mStatic;
+         F32                                 mMass;
+         PhysicsShape::Type                  mShapeType;
+         PhysicsShape*                       mShape;
          bool                                initialized;
+         bool                                added;
          bool                                deleted;
          bool                                shouldBeDeleted;
+         U32                                 generation;
+         PhysicsEngine*                      engine;
          void*                               user;
-         Delegate<void(void* _hitUser)>      onCollideDelegate;
+         Delegate<void(void* _hitUser, PhysicsContact::State _state)> onCollideDelegate;
+
+         // Called every frame with the interpolated transform, see 
+         // PhysicsEngine::interpolateTransforms.
+         Delegate<void(const F32* _transform)> onTransformDelegate;
 
          PhysicsObject()
          {
@@ -104,84 +257,150 @@ namespace Physics
             mRotation.set(0.0f, 0.0f, 0.0f);
             mScale.set(1.0f, 1.0f, 1.0f);
             mStatic = false;
+            mMass = 1.0f;
+            mShapeType = PhysicsShape::Box;
+            mShape = NULL;
             initialized = false;
+            added = false;
             deleted = true;
             shouldBeDeleted = false;
+            generation = 0;
+            engine = NULL;
             user = NULL;
             onCollideDelegate.clear();
+            onTransformDelegate.clear();
          }
-         ~PhysicsObject() { }
+         virtual ~PhysicsObject() { }
 
-         void addAction(PhysicsAction::Enum _actionType, Point3F _vector3Value)
-         {
-            PhysicsAction action;
-            action.actionType = _actionType;
-            action.vector3Value = _vector3Value;
-            mPhysicsActions.push_back(action);
-         }
+         void addAction(PhysicsAction::Enum _actionType, Point3F _vector3Value);
 
+         // Called on the physics thread.
          virtual void initialize()                    { initialized = true; }
          virtual void destroy()                       { initialized = false; }
+
+         // Called on the game thread. Position is taken directly until the 
+         // object has been handed to the physics thread, scale, static, mass
+         // and shape can't change after that.
          virtual Point3F getPosition()                { return mPosition; }
-         virtual void setPosition(Point3F _position)  { addAction(PhysicsAction::setPosition, _position); }
+         virtual void setPosition(Point3F _position)  { if ( !added ) mPosition = _position; else addAction(PhysicsAction::setPosition, _position); }
          virtual Point3F getRotation()                { return mRotation; }
          virtual void setRotation(Point3F _rot)       { addAction(PhysicsAction::setRotation, _rot); }
          virtual Point3F getScale()                   { return mScale; }
-         virtual void setScale(Point3F _scale)        { mScale = _scale; }
-         virtual void setStatic(bool _val)            { mStatic = _val; }
+         virtual void setScale(Point3F _scale)        { if ( !added ) mScale = _scale; }
+         virtual void setStatic(bool _val)            { if ( !added ) mStatic = _val; }
+         virtual void setMass(F32 _mass)              { if ( !added ) mMass = _mass; }
+
+         // Takes over the caller's reference to _shape. Objects with a cooked
+         // shape type stay on the game side until they have the shape.
+         void setShape(PhysicsShape::Type _type, PhysicsShape* _shape);
+         bool isShapeReady() { return PhysicsShape::isPrimitive(mShapeType) || mShape != NULL; }
 
          virtual void applyForce(Point3F _force)      { addAction(PhysicsAction::applyForce, _force); }
          virtual void setLinearVelocity(Point3F _vel) { addAction(PhysicsAction::setLinearVelocity, _vel); }
    };
 
-   // Thread safe physics event.
-   class PhysicsEvent : public SimEvent
-   {
-      protected:
-         PhysicsObject mObjA;
-         PhysicsObject mObjB;
-
-      public:
-         PhysicsEvent(PhysicsObject objA, PhysicsObject objB)
-         {
-            mObjA = objA;
-            mObjB = objB;
-         }
-
-         virtual void process(SimObject *object);
-   };
-
    // Physics Engine Core
    class PhysicsEngine : public virtual Tickable
    {
       protected:
+         static const U32 ActionQueueSize    = 4096;
+         static const U32 ReleaseQueueSize   = 1024;
+         static const U32 ContactQueueSize   = 4096;
+         static const S32 SnapshotFresh      = 0x4;
+         static const S32 SnapshotIndexMask  = 0x3;
+
          PhysicsThread* mPhysicsThread;
          F64            mPreviousTime;
          F64            mAccumulatorTime;
          F32            mStepSize;
-         bool           mRunning;
+         volatile bool  mRunning;
+
+         // Game -> Physics
+         PhysicsQueue<PhysicsAction, ActionQueueSize>    mActionQueue;
+         Vector<PhysicsAction>                           mActionOverflow;
+         Vector<PhysicsObject*>                          mPendingObjects;
+         Vector<PhysicsAction>                           mHeldActions;
+
+         // Physics -> Game
+         PhysicsQueue<PhysicsObject*, ReleaseQueueSize>  mReleaseQueue;
+         Vector<PhysicsObject*>                          mReleaseOverflow;
+         PhysicsQueue<PhysicsContact, ContactQueueSize>  mContactQueue;
+         Vector<PhysicsContact>                          mContactOverflow;
+
+         // Game thread: cooked shapes in use and terrain heights.
+         Vector<PhysicsShape*>                           mShapes;
+         Vector<PhysicsHeightfield*>                     mHeightfields;
+
+         // Physics thread: touching pairs of the last step, sorted.
+         Vector<PhysicsContact>                          mContacts;
+         Vector<PhysicsContact>                          mStepContacts;
+
+         // Triple buffered transforms. mSnapshotShared holds the index of the
+         // buffer neither side owns, plus SnapshotFresh when it's unread.
+         Vector<PhysicsTransform>                        mSnapshots[3];
+         F64                                             mSnapshotTimes[3];
+         volatile S32                                    mSnapshotShared;
+         S32                                             mSnapshotWrite;
+         S32                                             mSnapshotRead;
+
+         S32  _exchangeSnapshot(S32 value);
+         void _flushActions();
+         void _publishSnapshot();
+         void _readSnapshot();
+         void _interpolateTransforms(F64 time);
+         void _queueContact(const PhysicsContact& _contact);
+         void _updateContacts();
+         void _dispatchContacts();
+         void _recycleObject(PhysicsObject* _obj);
+         PhysicsShape* _findShape(StringTableEntry _key, U32 _version);
+         void _stopPhysicsThread();
+
+         // Game thread: registers a freshly allocated object, it's handed to
+         // the physics thread on the next tick.
+         void trackObject(PhysicsObject* _obj, void* _user);
+
+         // Physics thread: hands an object back to the game thread.
+         void releaseObject(PhysicsObject* _obj);
 
       public:
          PhysicsEngine();
          ~PhysicsEngine();
 
+         void start();
          void setRunning(bool value);
+         bool isRunning() { return mRunning; }
          void processPhysics();
 
+         // Game thread.
+         void queueAction(PhysicsObject* _obj, PhysicsAction::Enum _actionType, Point3F _vector3Value);
+         void update();
+
+         // Game thread. Shapes come back with a reference for the caller, NULL
+         // when they can't be built (yet).
+         PhysicsShape*  getMeshShape(PhysicsShape::Type _type, MeshAsset* _mesh);
+         PhysicsShape*  getHeightfieldShape(S32 _gridX, S32 _gridY);
+         void           releaseShape(PhysicsShape* _shape);
+         void           setHeightfield(S32 _gridX, S32 _gridY, const F32* _heights, U32 _width, U32 _length, Point3F _origin);
+
+         // Physics thread: apply queued actions, step and publish transforms.
+         // time is the clock time the step corresponds to.
+         void step(F32 dt, F64 time);
+
          // These must be implemented for a functioning physics engine:
          virtual PhysicsObject*  getPhysicsObject(void* _user = NULL);
          virtual void            deletePhysicsObject(PhysicsObject* _obj);
+         virtual void            recyclePhysicsObject(PhysicsObject* _obj);
+         virtual void            applyAction(const PhysicsAction& _action);
          virtual void            simulate(F32 dt);
-         virtual void            update();
+         virtual void            getTransforms(Vector<PhysicsTransform>& _transforms);
+         virtual void            getContacts(Vector<PhysicsContact>& _contacts);
+         virtual PhysicsShape*   createMeshShape(PhysicsShape::Type _type, MeshAsset* _mesh);
+         virtual PhysicsShape*   createHeightfieldShape(const PhysicsHeightfield* _heightfield);
 
          // Tickable
          virtual void interpolateTick( F32 delta );
          virtual void processTick();
          virtual void advanceTime( F32 timeDelta );
-
-         // Static Variables
-         static void* smPhysicsExecuteMutex;
-         static void* smPhysicsFinishedMutex;
    };
 }
 
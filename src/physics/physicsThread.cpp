@@ -30,31 +30,48 @@
 
 namespace Physics 
 {
-   PhysicsThread::PhysicsThread(F32 _stepSize, simulateFunc _simulateFunction)
+   PhysicsThread::PhysicsThread(PhysicsEngine* _engine, F32 _stepSize)
+      : Thread(0, 0, false)
    {
+      engine   = _engine;
       stepSize = _stepSize;
-      simulate = _simulateFunction;
    }
 
    // This only executes if TORQUE_MULTITHREAD is defined.
    void PhysicsThread::run(void *arg)
    {
+      F64 previousTime  = (F64)( bx::getHPCounter() / F64(bx::getHPFrequency()) );
+      F64 accumulator   = 0.0;
+
       while ( !shouldStop )
       {
-         // This won't be available when we're not suppoesd to run.
-         if( Mutex::lockMutex(PhysicsEngine::smPhysicsExecuteMutex) )
+         F64 time       = (F64)( bx::getHPCounter() / F64(bx::getHPFrequency()) );
+         accumulator    += (time - previousTime);
+         previousTime   = time;
+
+         if ( !engine->isRunning() )
          {
-            if ( simulate != NULL )
-               simulate(stepSize);
+            accumulator = 0.0;
+            Platform::sleep(1);
+            continue;
+         }
 
-            // Release execution mutex.
-            Mutex::unlockMutex(PhysicsEngine::smPhysicsExecuteMutex);
+         if ( accumulator < stepSize )
+         {
+            Platform::sleep(1);
+            continue;
+         }
 
-            // This will block execution until the main thread 
-            // obtains the smPhysicsExecuteMutex lock.
-            if( Mutex::lockMutex(PhysicsEngine::smPhysicsFinishedMutex) )
-               Mutex::unlockMutex(PhysicsEngine::smPhysicsFinishedMutex);
+         U32 steps = 0;
+         while ( accumulator >= stepSize && steps < MaxSteps )
+         {
+            accumulator -= stepSize;
+            engine->step(stepSize, time - accumulator);
+            steps++;
          }
+
+         if ( accumulator >= stepSize )
+            accumulator = 0.0;
       }
    }
-}
\ No newline at end of file
+}
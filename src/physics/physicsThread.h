@@ -43,10 +43,6 @@
 #include "platform/Tickable.h"
 #endif
 
-#ifndef _PHYSICS_COMPONENT_H_
-#include "3d/entity/components/physicsComponent.h"
-#endif
-
 #ifndef _PHYSICS_ENGINE_H_
 #include "physicsEngine.h"
 #endif
@@ -55,13 +51,10 @@
 //  How the Physics Thread works:
 // ------------------------------------------------------------------------------
 //
-//   1) Attempt to lock Execute mutex. When this locks we're free to execute.
-//   2) Step Physics.
-//   3) Unlock Execute mutex since we're finished.
-//   4) Attempt to lock Finished mutex. We'll block here until the main thread
-//        unlocks the mutex.
-//   5) Unlock Finished mutex as soon as we get it. We have no reason to hold it
-//        we just wanted to block for the main thread.
+//   The thread keeps its own fixed step clock. Whenever a step is due it
+//   calls PhysicsEngine::step which drains the action queue, simulates and
+//   publishes a transform snapshot. Otherwise it sleeps. It never waits for
+//   the game thread.
 //
 // ------------------------------------------------------------------------------
 
@@ -70,14 +63,16 @@ namespace Physics
    // Threaded Physics
    class PhysicsThread : public Thread
    {
-      typedef void (*simulateFunc)(F32 dt);
-
       protected:
-         F32          stepSize;
-         simulateFunc simulate;
+         // Steps taken in one go before the clock is reset, keeps a stalled
+         // thread from spiraling.
+         static const U32 MaxSteps = 10;
+
+         PhysicsEngine* engine;
+         F32            stepSize;
 
       public:
-         PhysicsThread(F32 _sizeSize, simulateFunc _simulateFunction);
+         PhysicsThread(PhysicsEngine* _engine, F32 _stepSize);
 
          virtual void run(void *arg = 0);
    };
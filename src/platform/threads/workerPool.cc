@@ -0,0 +1,166 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#include "platform/platform.h"
+#include "platform/threads/thread.h"
+#include "platform/threads/semaphore.h"
+#include "collection/vector.h"
+#include "console/console.h"
+#include "math/mMathFn.h"
+#include "memory/safeDelete.h"
+#include "workerPool.h"
+
+#include <bx/cpu.h>
+
+// Script bindings.
+#include "workerPool_Binding.h"
+
+namespace WorkerPool
+{
+   struct Job
+   {
+      JobFunction    func;
+      void*          data;
+      U32            count;
+      U32            grainSize;
+      volatile S32   nextRange;
+   };
+
+   class WorkerThread : public Thread
+   {
+      public:
+         WorkerThread() : Thread(0, 0, false) { }
+         virtual void run(void *arg = 0);
+   };
+
+   static Vector<WorkerThread*>  gWorkers;
+   static Semaphore*             gStartSemaphore   = NULL;
+   static Semaphore*             gDoneSemaphore    = NULL;
+   static volatile bool          gShutdown         = false;
+   static Job                    gJob;
+
+   // Grabs ranges from the current job until there are none left.
+   static void _processJob()
+   {
+      for (;;)
+      {
+         U32 range = (U32)(bx::atomicInc(&gJob.nextRange) - 1);
+         U32 start = range * gJob.grainSize;
+         if ( start >= gJob.count )
+            break;
+
+         U32 end = getMin(start + gJob.grainSize, gJob.count);
+         gJob.func(gJob.data, start, end);
+      }
+   }
+
+   void WorkerThread::run(void *arg)
+   {
+      for (;;)
+      {
+         gStartSemaphore->acquire();
+         if ( gShutdown )
+            break;
+
+         _processJob();
+         gDoneSemaphore->release();
+      }
+   }
+
+   void init(U32 workerCount)
+   {
+      if ( gStartSemaphore != NULL )
+         return;
+
+      gShutdown         = false;
+      gStartSemaphore   = new Semaphore(0);
+      gDoneSemaphore    = new Semaphore(0);
+
+      for (U32 n = 0; n < workerCount; ++n)
+      {
+         WorkerThread* worker = new WorkerThread();
+         worker->start();
+         gWorkers.push_back(worker);
+      }
+   }
+
+   void destroy()
+   {
+      if ( gStartSemaphore == NULL )
+         return;
+
+      // Wake every worker up so it can see the shutdown flag.
+      gShutdown = true;
+      for (S32 n = 0; n < gWorkers.size(); ++n)
+         gStartSemaphore->release();
+
+      for (S32 n = 0; n < gWorkers.size(); ++n)
+      {
+         gWorkers[n]->join();
+         delete gWorkers[n];
+      }
+      gWorkers.clear();
+
+      SAFE_DELETE(gStartSemaphore);
+      SAFE_DELETE(gDoneSemaphore);
+   }
+
+   U32 getWorkerCount()
+   {
+      return gWorkers.size();
+   }
+
+   void run(JobFunction func, void* data, U32 count, U32 grainSize)
+   {
+      if ( count < 1 )
+         return;
+
+      if ( grainSize < 1 )
+         grainSize = 1;
+
+      // Not worth waking anyone up for a single range.
+      if ( gWorkers.size() < 1 || count <= grainSize )
+      {
+         func(data, 0, count);
+         return;
+      }
+
+      gJob.func      = func;
+      gJob.data      = data;
+      gJob.count     = count;
+      gJob.grainSize = grainSize;
+      gJob.nextRange = 0;
+      bx::memoryBarrier();
+
+      // Only wake as many workers as there are ranges for, the calling thread
+      // takes part too.
+      U32 rangeCount = (count + grainSize - 1) / grainSize;
+      U32 wakeCount  = getMin((U32)gWorkers.size(), rangeCount - 1);
+      for (U32 n = 0; n < wakeCount; ++n)
+         gStartSemaphore->release();
+
+      _processJob();
+
+      for (U32 n = 0; n < wakeCount; ++n)
+         gDoneSemaphore->acquire();
+   }
+}
@@ -0,0 +1,54 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2015 Andrew Mac
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef _PLATFORM_THREADS_WORKER_POOL_H_
+#define _PLATFORM_THREADS_WORKER_POOL_H_
+
+#ifndef _TORQUE_TYPES_H_
+#include "platform/types.h"
+#endif
+
+// ------------------------------------------------------------------------------
+//  Worker Pool
+// ------------------------------------------------------------------------------
+//
+//   A fixed set of worker threads used to split per-frame work into ranges.
+//   run() hands out [start, end) ranges of grainSize items to the workers and
+//   the calling thread until every item has been processed, then returns.
+//
+//   run() is meant to be called from the main thread only and jobs must not
+//   call run() themselves.
+//
+// ------------------------------------------------------------------------------
+
+namespace WorkerPool
+{
+   typedef void (*JobFunction)(void* data, U32 start, U32 end);
+
+   void init(U32 workerCount);
+   void destroy();
+
+   U32  getWorkerCount();
+   void run(JobFunction func, void* data, U32 count, U32 grainSize = 1);
+}
+
+#endif // _PLATFORM_THREADS_WORKER_POOL_H_
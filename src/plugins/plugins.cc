@@ -185,12 +185,22 @@ namespace Plugins
       // Physics
       Link.Physics.pause = Physics::pause;
       Link.Physics.resume = Physics::resume;
+      Link.Physics.setHeightfield = Physics::setHeightfield;
 
       // Rendering
       Link.Rendering.canvasSizeChanged       = &Rendering::canvasSizeChanged;
       Link.Rendering.canvasWidth             = &Rendering::canvasWidth;
       Link.Rendering.canvasHeight            = &Rendering::canvasHeight;
       Link.Rendering.createRenderData        = Rendering::createRenderData;
+      Link.Rendering.destroyRenderData       = Rendering::destroyRenderData;
+      Link.Rendering.getRenderHandle         = Rendering::getRenderHandle;
+      Link.Rendering.getRenderData           = Rendering::getRenderData;
+      Link.Rendering.transformBox            = Rendering::transformBox;
+      Link.Rendering.createStaticInstanceBuffer    = Rendering::createStaticInstanceBuffer;
+      Link.Rendering.createDynamicInstanceBuffer   = Rendering::createDynamicInstanceBuffer;
+      Link.Rendering.destroyInstanceBuffer         = Rendering::destroyInstanceBuffer;
+      Link.Rendering.beginInstanceUpdate           = Rendering::beginInstanceUpdate;
+      Link.Rendering.endInstanceUpdate             = Rendering::endInstanceUpdate;
       Link.Rendering.viewMatrix              = Rendering::viewMatrix;
       Link.Rendering.projectionMatrix        = Rendering::projectionMatrix;
       Link.Rendering.screenToWorld           = Rendering::screenToWorld;
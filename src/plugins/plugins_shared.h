@@ -47,6 +47,10 @@
 #include <../common/nanovg/nanovg.h>
 #endif
 
+#ifndef _RENDERING_CULLING_H_
+#include "3d/rendering/culling.h"
+#endif
+
 #ifndef _DEFERREDRENDERING_H_
 #include "3d/rendering/deferredRendering.h"
 #endif
@@ -220,6 +224,8 @@ namespace Plugins
       void (*removeEntity)(Scene::SceneEntity* entity);
 
       MaterialAsset* (*getMaterialAsset)(const char* id);
+      // Blocks until the mesh is loaded. A refresh of the asset replaces its
+      // buffers, so don't hold on to them past the frame.
       MeshAsset* (*getMeshAsset)(const char* id);
 
       void (*refresh)();
@@ -229,6 +235,7 @@ namespace Plugins
    {
       void (*pause)();
       void (*resume)();
+      void (*setHeightfield)(S32 gridX, S32 gridY, const F32* heights, U32 width, U32 length, Point3F origin);
    };
 
    struct RenderingWrapper
@@ -242,6 +249,15 @@ namespace Plugins
       Point2I (*worldToScreen)(Point3F worldPos);
       Point3F (*screenToWorld)(Point2I screenPos);
       Rendering::RenderData* (*createRenderData)();
+      void (*destroyRenderData)(Rendering::RenderData* item);
+      Rendering::RenderHandle (*getRenderHandle)(Rendering::RenderData* item);
+      Rendering::RenderData* (*getRenderData)(Rendering::RenderHandle handle);
+      Box3F (*transformBox)(const F32* mtx, const Box3F& box);
+      Rendering::InstanceBuffer* (*createStaticInstanceBuffer)(const Rendering::InstanceData* data, U32 count);
+      Rendering::InstanceBuffer* (*createDynamicInstanceBuffer)(U32 capacity);
+      void (*destroyInstanceBuffer)(Rendering::InstanceBuffer* buffer);
+      Rendering::InstanceData* (*beginInstanceUpdate)(Rendering::InstanceBuffer* buffer);
+      void (*endInstanceUpdate)(Rendering::InstanceBuffer* buffer, U32 count);
 
       Rendering::DeferredRendering* (*getDeferredRendering)();
    };